@@ -0,0 +1,99 @@
+// Measures how many random doubles per second all threads together draw, for rand() and the per-thread engines of
+// Utils::Random. The lock inside rand() stops it from scaling past one thread, the per-thread engines should scale
+// linearly with the core count.
+
+#include <Utils/Random.h>
+#include <Utils/RandomEngines.h>
+#include <Utils/Timers.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Impl
+{
+
+    constexpr uint64_t SamplesPerThread = 20'000'000;
+
+    // Keeps the compiler from dropping the generated numbers.
+    volatile double g_Sink = 0.0;
+
+    template <typename Function>
+    double MeasureSamplesPerSecond(const unsigned threadCount, Function drawDouble)
+    {
+        const Utils::Timer timer;
+
+        std::vector<std::thread> threads;
+        for(unsigned t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back(
+                [drawDouble]
+                {
+                    double sum = 0.0;
+                    for(uint64_t i = 0; i < SamplesPerThread; i++)
+                    {
+                        sum += drawDouble();
+                    }
+                    g_Sink = g_Sink + sum;
+                });
+        }
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        return static_cast<double>(SamplesPerThread) * threadCount / timer.ElapsedSeconds();
+    }
+
+    template <typename Engine>
+    double EngineDouble()
+    {
+        thread_local Engine engine(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        if constexpr(sizeof(typename Engine::result_type) == 8)
+            return static_cast<double>(engine() >> 11) * 0x1.0p-53;
+        else
+            return static_cast<double>(engine()) * 0x1.0p-32;
+    }
+
+    void PrintRow(const std::string_view name, const unsigned threadCount, const double samplesPerSecond, const double singleThread)
+    {
+        std::printf("%-20.*s %8u %14.1f %10.2fx\n", static_cast<int>(name.size()), name.data(), threadCount, samplesPerSecond / 1e6, samplesPerSecond / singleThread);
+    }
+
+    template <typename Function>
+    void Run(const std::string_view name, const std::vector<unsigned>& threadCounts, Function drawDouble)
+    {
+        double singleThread = 0.0;
+        for(const unsigned threadCount : threadCounts)
+        {
+            const double samplesPerSecond = MeasureSamplesPerSecond(threadCount, drawDouble);
+            if(threadCount == 1)
+                singleThread = samplesPerSecond;
+            PrintRow(name, threadCount, samplesPerSecond, singleThread);
+        }
+    }
+
+}    // namespace Impl
+
+int main()
+{
+    const unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<unsigned> threadCounts;
+    for(unsigned threadCount = 1; threadCount < hardwareThreads; threadCount *= 2)
+    {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(hardwareThreads);
+
+    std::printf("%-20s %8s %14s %11s\n", "Generator", "Threads", "Msamples/s", "Scaling");
+    Impl::Run("rand()", threadCounts, [] { return std::rand() / (RAND_MAX + 1.0); });
+    Impl::Run("Utils::Random", threadCounts, [] { return Utils::Random::Double(); });
+    Impl::Run("xoshiro256++", threadCounts, [] { return Impl::EngineDouble<Utils::Xoshiro256PlusPlus>(); });
+    Impl::Run("PCG32", threadCounts, [] { return Impl::EngineDouble<Utils::PCG32>(); });
+    return 0;
+}
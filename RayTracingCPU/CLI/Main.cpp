@@ -0,0 +1,294 @@
+#include <Render/Camera.h>
+#include <Render/Renderer.h>
+#include <Scenes/Scene.h>
+#include <Utils/ImageIO.h>
+#include <Utils/Log.h>
+#include <Utils/Random.h>
+#include <Utils/Timers.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace Impl
+{
+
+    struct Options
+    {
+        int         SceneId    = 17;
+        int         Width      = 700;
+        int         Height     = 700;
+        int         Samples    = 10;
+        int         Depth      = 50;
+        unsigned    Threads    = 0;    // Zero uses one thread per hardware thread
+        int         Renderer   = 1;    // Render::Camera::RenderType
+        int         Integrator = 2;    // Render::Camera::IntegratorType
+        int         RRDepth    = 3;    // Negative disables Russian roulette
+        int         Lights     = 0;    // Objects::LightSelection
+        int         Sampler    = 2;    // Render::Camera::SamplerType
+        int         MinSpp     = 16;
+        int         MaxSpp     = 1024;
+        double      Threshold  = 0.005;
+        bool        ShowSpp    = false;    // Write the adaptive sample counts instead of the image
+        uint32_t    TileSize   = 32;
+        int         TileOrder  = 2;    // Render::TileOrder
+        uint64_t    Seed       = 0;
+        bool        Seeded     = false;    // A seed was given, render deterministically
+        std::string OutputPath = "image.png";
+        bool        InfoOnly   = false;    // Only help or the scene list was requested
+    };
+
+    void PrintUsage()
+    {
+        std::printf("Usage: ray-tracing-cpu-cli [options]\n"
+                    "  --scene <id>       Scene to render, see --list-scenes (default 17)\n"
+                    "  --width <pixels>   Image width (default 700)\n"
+                    "  --height <pixels>  Image height (default 700)\n"
+                    "  --spp <count>      Samples per pixel, the average with the adaptive sampler (default 10)\n"
+                    "  --sampler <name>   normal, stratified or adaptive (default stratified)\n"
+                    "  --min-spp <count>  Adaptive sampler: samples before a pixel may stop (default 16)\n"
+                    "  --max-spp <count>  Adaptive sampler: most samples of a pixel (default 1024)\n"
+                    "  --threshold <err>  Adaptive sampler: error of a converged pixel (default 0.005)\n"
+                    "  --show-samples     Adaptive sampler: write the samples per pixel as a heat map\n"
+                    "  --depth <count>    Maximum ray bounces (default 50)\n"
+                    "  --threads <count>  Render threads, 0 uses all hardware threads (default 0)\n"
+                    "  --renderer <name>  single, multi or packets (default multi)\n"
+                    "  --integrator <n>   recursive, iterative or nee (default nee)\n"
+                    "  --rr-depth <n>     Bounces before Russian roulette, or off (default 3)\n"
+                    "  --lights <name>    Pick lights by power or importance (default power)\n"
+                    "  --tile-size <px>   Edge of the square render tiles (default 32)\n"
+                    "  --tile-order <n>   scanline, morton or hilbert (default hilbert)\n"
+                    "  --seed <number>    Render deterministically, the image then only depends on the seed\n"
+                    "  --output <path>    Output image, .png or .ppm (default image.png)\n"
+                    "  --list-scenes      Print the scene ids and exit\n");
+    }
+
+    template <typename T>
+    bool ParseNumber(const std::string_view text, T& value)
+    {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool ParseRenderer(const std::string_view text, int& renderer)
+    {
+        if(text == "single")
+            renderer = static_cast<int>(Render::Camera::RenderType::CPUOneCore);
+        else if(text == "multi")
+            renderer = static_cast<int>(Render::Camera::RenderType::CPUMultiCore);
+        else if(text == "packets")
+            renderer = static_cast<int>(Render::Camera::RenderType::CPUPackets);
+        else
+            return false;
+        return true;
+    }
+
+    bool ParseIntegrator(const std::string_view text, int& integrator)
+    {
+        if(text == "recursive")
+            integrator = static_cast<int>(Render::Camera::IntegratorType::Recursive);
+        else if(text == "iterative")
+            integrator = static_cast<int>(Render::Camera::IntegratorType::Iterative);
+        else if(text == "nee")
+            integrator = static_cast<int>(Render::Camera::IntegratorType::NextEvent);
+        else
+            return false;
+        return true;
+    }
+
+    bool ParseSampler(const std::string_view text, int& sampler)
+    {
+        if(text == "normal")
+            sampler = static_cast<int>(Render::Camera::SamplerType::Normal);
+        else if(text == "stratified")
+            sampler = static_cast<int>(Render::Camera::SamplerType::Stratified);
+        else if(text == "adaptive")
+            sampler = static_cast<int>(Render::Camera::SamplerType::Adaptive);
+        else
+            return false;
+        return true;
+    }
+
+    bool ParseLightSelection(const std::string_view text, int& selection)
+    {
+        if(text == "power")
+            selection = static_cast<int>(Objects::LightSelection::Power);
+        else if(text == "importance")
+            selection = static_cast<int>(Objects::LightSelection::Importance);
+        else
+            return false;
+        return true;
+    }
+
+    bool ParseTileOrder(const std::string_view text, int& order)
+    {
+        if(text == "scanline")
+            order = static_cast<int>(Render::TileOrder::Scanline);
+        else if(text == "morton")
+            order = static_cast<int>(Render::TileOrder::Morton);
+        else if(text == "hilbert")
+            order = static_cast<int>(Render::TileOrder::Hilbert);
+        else
+            return false;
+        return true;
+    }
+
+    // Returns false if the arguments are invalid.
+    bool ParseOptions(const int argc, char** argv, Options& options)
+    {
+        for(int i = 1; i < argc; i++)
+        {
+            const std::string_view argument = argv[i];
+            if(argument == "--help" || argument == "-h")
+            {
+                PrintUsage();
+                options.InfoOnly = true;
+                return true;
+            }
+            if(argument == "--list-scenes")
+            {
+                for(size_t id = 0; id < Scenes::SceneNames.size(); id++)
+                {
+                    std::printf("%2zu  %s\n", id, Scenes::SceneNames[id]);
+                }
+                options.InfoOnly = true;
+                return true;
+            }
+            if(argument == "--show-samples")
+            {
+                options.ShowSpp = true;
+                continue;
+            }
+            if(i + 1 >= argc)
+            {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+
+            const std::string_view value = argv[++i];
+
+            bool valid = true;
+            if(argument == "--scene")
+                valid = ParseNumber(value, options.SceneId) && options.SceneId >= 0 && options.SceneId < static_cast<int>(Scenes::SceneNames.size());
+            else if(argument == "--width")
+                valid = ParseNumber(value, options.Width) && options.Width > 0;
+            else if(argument == "--height")
+                valid = ParseNumber(value, options.Height) && options.Height > 0;
+            else if(argument == "--spp")
+                valid = ParseNumber(value, options.Samples) && options.Samples > 0;
+            else if(argument == "--sampler")
+                valid = ParseSampler(value, options.Sampler);
+            else if(argument == "--min-spp")
+                valid = ParseNumber(value, options.MinSpp) && options.MinSpp > 0;
+            else if(argument == "--max-spp")
+                valid = ParseNumber(value, options.MaxSpp) && options.MaxSpp > 0;
+            else if(argument == "--threshold")
+                valid = ParseNumber(value, options.Threshold) && options.Threshold >= 0.0;
+            else if(argument == "--depth")
+                valid = ParseNumber(value, options.Depth) && options.Depth >= 0;
+            else if(argument == "--threads")
+                valid = ParseNumber(value, options.Threads);
+            else if(argument == "--tile-size")
+                valid = ParseNumber(value, options.TileSize) && options.TileSize > 0;
+            else if(argument == "--tile-order")
+                valid = ParseTileOrder(value, options.TileOrder);
+            else if(argument == "--seed")
+                valid = options.Seeded = ParseNumber(value, options.Seed);
+            else if(argument == "--renderer")
+                valid = ParseRenderer(value, options.Renderer);
+            else if(argument == "--integrator")
+                valid = ParseIntegrator(value, options.Integrator);
+            else if(argument == "--rr-depth")
+                valid = value == "off" ? (options.RRDepth = -1, true) : ParseNumber(value, options.RRDepth) && options.RRDepth >= 0;
+            else if(argument == "--lights")
+                valid = ParseLightSelection(value, options.Lights);
+            else if(argument == "--output")
+                options.OutputPath = value;
+            else
+            {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                PrintUsage();
+                return false;
+            }
+
+            if(!valid)
+            {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+}    // namespace Impl
+
+int main(const int argc, char** argv)
+{
+    Impl::Options options;
+    if(!Impl::ParseOptions(argc, argv, options))
+        return 1;
+    if(options.InfoOnly)
+        return 0;
+
+    Utils::Log::Init();
+
+    const double aspectRatio = static_cast<double>(options.Width) / options.Height;
+
+    // Scenes with random content draw from the engine of this thread.
+    if(options.Seeded)
+        Utils::Random::Init(options.Seed);
+
+    const Utils::Timer sceneTimer;
+    const auto         scene = Scenes::CreateScene(options.SceneId, aspectRatio, options.Width, options.Samples, options.Depth);
+    scene->SetLightSelection(static_cast<Objects::LightSelection>(options.Lights));
+
+    Render::Camera camera = scene->GetCamera();
+    camera.RenderingType  = static_cast<Render::Camera::RenderType>(options.Renderer);
+    camera.Integrator     = static_cast<Render::Camera::IntegratorType>(options.Integrator);
+
+    camera.UseRussianRoulette   = options.RRDepth >= 0;
+    camera.RussianRouletteDepth = options.RRDepth;
+
+    camera.SamplingType      = static_cast<Render::Camera::SamplerType>(options.Sampler);
+    camera.AdaptiveMinSpp    = options.MinSpp;
+    camera.AdaptiveMaxSpp    = options.MaxSpp;
+    camera.AdaptiveThreshold = options.Threshold;
+    camera.ShowSampleCount   = options.ShowSpp;
+
+    camera.DeterministicSampling = options.Seeded;
+    camera.Seed                  = options.Seed;
+
+    // Same rounding as Camera::Initialize, so the image matches the camera.
+    const int height = std::max(1, static_cast<int>(camera.ImageWidth / camera.AspectRatio));
+
+    const Objects::Hittable& world = scene->GetWorld();
+    LOG_INFO("Scene \"{}\" built in {:.3f} ms", Scenes::SceneNames[options.SceneId], sceneTimer.ElapsedMilliseconds());
+
+    Render::Renderer renderer(options.Threads);
+    renderer.SetTileSize(options.TileSize);
+    renderer.SetTileOrder(static_cast<Render::TileOrder>(options.TileOrder));
+    renderer.SetImageSize(static_cast<uint32_t>(camera.ImageWidth), static_cast<uint32_t>(height));
+
+    const Utils::Timer renderTimer;
+    renderer.Render(camera, world, scene->GetLights());
+
+    const bool   adaptive = camera.SamplingType == Render::Camera::SamplerType::Adaptive;
+    const double renderMs = renderTimer.ElapsedMilliseconds();
+    const double samples  = adaptive ? static_cast<double>(renderer.GetAdaptiveStats().SampleCount)
+                                     : static_cast<double>(renderer.GetWidth()) * renderer.GetHeight() * camera.PixelSampleCount();
+    LOG_INFO("Rendered {}x{} with {} spp in {:.3f} ms, {:.3f} Msamples/s", renderer.GetWidth(), renderer.GetHeight(), options.Samples, renderMs, samples / renderMs / 1e3);
+    if(adaptive)
+        renderer.GetAdaptiveStats().Log("Adaptive sampling");
+    else if(camera.RenderingType != Render::Camera::RenderType::CPUOneCore)
+        renderer.GetTileStats().Log("Tiles");
+
+    if(!Utils::WriteImage(options.OutputPath, renderer.GetWidth(), renderer.GetHeight(), renderer.GetImageData()))
+    {
+        LOG_ERROR("Failed to write {}", options.OutputPath);
+        return 1;
+    }
+    LOG_INFO("Saved {}", options.OutputPath);
+    return 0;
+}
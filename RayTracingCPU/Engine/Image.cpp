@@ -4,7 +4,6 @@
 #include <imgui.h>
 #include <imgui_impl_vulkan.h>
 
-#define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 #include "Utils/VulkanException.h"
@@ -1,5 +1,7 @@
 
-#include <Render/Renderer.h>
+#include <Math/Transform.h>
+#include <Objects/TopLevelBVH.h>
+#include <Render/RenderThread.h>
 #include <Scenes/Scene.h>
 #include <UI/ImGuiHelper.h>
 #include <UI/Layer.h>
@@ -10,6 +12,10 @@
 
 #include <imgui.h>
 
+#include <algorithm>
+#include <bit>
+#include <vector>
+
 bool g_ApplicationRunning = true;
 
 class RayTracinUILayer final : public UI::Layer
@@ -22,34 +28,23 @@ public:
 
     void OnUIRender() override
     {
+        uint32_t imageWidth  = 0;
+        uint32_t imageHeight = 0;
+        if(m_RenderThread.FetchImage(m_Pixels, imageWidth, imageHeight))
+        {
+            UpdateImage(imageWidth, imageHeight);
+        }
+        const Render::RenderStatus status = m_RenderThread.GetStatus();
+        m_LastRenderTime                  = status.LastFrameMs;
+
         ImGui::Begin("Settings");
         ImGui::SeparatorText("Style");
         UI::ImGuiSettings::ShowStyleSelector("Colors");
         UI::ImGuiSettings::ShowFontSelector("Font");
 
         ImGui::SeparatorText("Rendering");
-        const char* sceneList[] = {
-            "RTWeekOne: Default",
-            "RTWeekOne: Test",
-            "RTWeekOne: Final",
-            "RTWeekNext: Default",
-            "RTWeekNext: Random Spheres",
-            "RTWeekNext: Two Spheres",
-            "RTWeekNext: Earth",
-            "RTWeekNext: Two Perlin Spheres",
-            "RTWeekNext: Quads",
-            "RTWeekNext: Simple Light",
-            "RTWeekNext: Cornell Box",
-            "RTWeekNext: Cornell Smoke",
-            "RTWeekNext: Final",
-            "RTWeekRest: Cornell Box (Simple)",
-            "RTWeekRest: Cornell Box (Mirror)",
-            "RTWeekRest: Cornell Box (Glass)",
-            "White Speres",
-            "Cornell Box Lights"};
-        if(ImGui::Combo("Scene", &m_SceneId, sceneList, IM_ARRAYSIZE(sceneList)))
+        if(ImGui::Combo("Scene", &m_SceneId, Scenes::SceneNames.data(), static_cast<int>(Scenes::SceneNames.size())))
         {
-            m_Renderer.ResetFrameCounter();
             SetScene();
         }
 
@@ -57,7 +52,10 @@ public:
         {
             SetScene();
         }
-        ImGui::InputInt("Depth", &m_SceneDepth);
+        if(ImGui::InputInt("Depth", &m_SceneDepth))
+        {
+            SetScene();
+        }
 
         // ImGui::Text("Aspect Ratio: %.6f", m_AspectRatio);
         ImGui::InputDouble("Aspect Ratio", &m_AspectRatio, 0.0, 0.0, "%.2f");
@@ -78,6 +76,24 @@ public:
         ImGui::RadioButton("CPU Multi Core", &m_RendererType, 1);
         ImGui::SameLine();
         ImGui::RadioButton("GPU", &m_RendererType, 2);
+        ImGui::SameLine();
+        ImGui::RadioButton("CPU Packets", &m_RendererType, 3);
+        if(m_RendererType == 3)
+        {
+            const char* packetSizeList[] = {"4 (2x2)", "8 (4x2)", "16 (4x4)"};
+            int         packetSizeId     = std::bit_width(static_cast<unsigned>(m_PacketSize)) - 3;
+            if(ImGui::Combo("Packet Size", &packetSizeId, packetSizeList, IM_ARRAYSIZE(packetSizeList)))
+            {
+                m_PacketSize = 4 << packetSizeId;
+            }
+        }
+        if(m_RendererType == 1 || m_RendererType == 3)
+        {
+            ImGui::SliderInt("Tile Size", &m_TileSize, 4, 128);
+
+            const char* tileOrderList[] = {"Scanline", "Morton", "Hilbert"};
+            ImGui::Combo("Tile Order", &m_TileOrder, tileOrderList, IM_ARRAYSIZE(tileOrderList));
+        }
 
         ImGui::Text("Pixel Sampling Type:");
         ImGui::RadioButton("Normal", &m_SamplingType, 0);
@@ -85,13 +101,99 @@ public:
         ImGui::RadioButton("Accumulation", &m_SamplingType, 1);
         ImGui::SameLine();
         ImGui::RadioButton("Stratified", &m_SamplingType, 2);
+        ImGui::SameLine();
+        ImGui::RadioButton("Adaptive", &m_SamplingType, 3);
+        if(m_SamplingType == 3)
+        {
+            ImGui::SliderInt("Min SPP", &m_AdaptiveMinSpp, 2, 256);
+            ImGui::SliderInt("Max SPP", &m_AdaptiveMaxSpp, m_AdaptiveMinSpp, 16384, "%d", ImGuiSliderFlags_Logarithmic);
+            ImGui::InputDouble("Error Threshold", &m_AdaptiveThreshold, 0.001, 0.01, "%.4f");
+            ImGui::Checkbox("Show Sample Count", &m_ShowSampleCount);
+
+            const auto& stats = status.Adaptive;
+            if(stats.PixelCount > 0)
+            {
+                ImGui::Text("Passes: %u, average SPP: %.1f, converged: %.1f%%", stats.Passes,
+                            static_cast<double>(stats.SampleCount) / stats.PixelCount, 100.0 * stats.ConvergedPixels / stats.PixelCount);
+            }
+        }
 
         ImGui::Checkbox("Use Probability Density Functions (PDF)", &m_UsePDF);
         ImGui::Checkbox("Use Unidirectional Light", &m_UseUnidirectionalLight);
+        const char* integratorList[] = {"Recursive", "Iterative", "Next Event Estimation"};
+        ImGui::Combo("Integrator", &m_Integrator, integratorList, IM_ARRAYSIZE(integratorList));
+        if(m_Integrator != static_cast<int>(Render::Camera::IntegratorType::Recursive))
+        {
+            ImGui::Checkbox("Russian Roulette", &m_UseRussianRoulette);
+            if(m_UseRussianRoulette)
+            {
+                ImGui::SliderInt("Roulette Start Depth", &m_RussianRouletteDepth, 0, 16);
+            }
+        }
+        const char* lightSelectionList[] = {"Power", "Importance"};
+        if(ImGui::Combo("Light Sampling", &m_LightSelection, lightSelectionList, IM_ARRAYSIZE(lightSelectionList)))
+        {
+            m_RenderThread.Cancel();
+            m_Scene->SetLightSelection(static_cast<Objects::LightSelection>(m_LightSelection));
+        }
+        ImGui::Checkbox("Deterministic Sampling", &m_DeterministicSampling);
+        if(m_DeterministicSampling)
+        {
+            ImGui::InputScalar("Seed", ImGuiDataType_U64, &m_Seed);
+        }
+
+        const char* bvhLayoutList[] = {"Binary", "BVH4", "BVH8"};
+        int         bvhLayout       = static_cast<int>(m_BVHBuildOptions.Layout);
+        if(ImGui::Combo("BVH Layout", &bvhLayout, bvhLayoutList, IM_ARRAYSIZE(bvhLayoutList)))
+        {
+            m_BVHBuildOptions.Layout = static_cast<Objects::BVHLayout>(bvhLayout);
+            m_RenderThread.Cancel();
+            m_Scene->SetBVHBuildOptions(m_BVHBuildOptions);
+        }
+
+        const char* bvhSplitList[] = {"Median", "SAH"};
+        int         bvhSplitMethod = static_cast<int>(m_BVHBuildOptions.SplitMethod);
+        if(ImGui::Combo("BVH Split", &bvhSplitMethod, bvhSplitList, IM_ARRAYSIZE(bvhSplitList)))
+        {
+            m_BVHBuildOptions.SplitMethod = static_cast<Objects::BVHSplitMethod>(bvhSplitMethod);
+            m_RenderThread.Cancel();
+            m_Scene->SetBVHBuildOptions(m_BVHBuildOptions);
+        }
+        if(m_BVHBuildOptions.SplitMethod == Objects::BVHSplitMethod::SAH)
+        {
+            if(ImGui::SliderInt("SAH Bins", &m_BVHBuildOptions.BinCount, 2, Objects::BVHBuildOptions::MaxBinCount))
+            {
+                m_RenderThread.Cancel();
+                m_Scene->SetBVHBuildOptions(m_BVHBuildOptions);
+            }
+            if(ImGui::InputDouble("SAH Leaf Cost", &m_BVHBuildOptions.LeafCost, 0.1, 1.0, "%.2f"))
+            {
+                m_RenderThread.Cancel();
+                m_Scene->SetBVHBuildOptions(m_BVHBuildOptions);
+            }
+        }
+
+        // Dragging moves the selected instance and only refits the top level of the world.
+        if(Objects::TopLevelBVH* topLevel = m_Scene->GetTopLevel())
+        {
+            const int instanceCount = static_cast<int>(topLevel->InstanceCount());
+            m_InstanceIndex         = std::clamp(m_InstanceIndex, 0, instanceCount - 1);
+            ImGui::SliderInt("Instance", &m_InstanceIndex, 0, instanceCount - 1);
+
+            float offset[3] = {0.0f, 0.0f, 0.0f};
+            if(ImGui::DragFloat3("Move Instance", offset))
+            {
+                m_RenderThread.Cancel();
+                const auto& objectToWorld = topLevel->Instances()[m_InstanceIndex]->ObjectToWorld();
+                topLevel->SetTransform(m_InstanceIndex, Math::Transform::Translate(Math::Vector3(offset[0], offset[1], offset[2])) * objectToWorld);
+                topLevel->Update();
+                m_ResetAccumulation = true;
+            }
+        }
 
         if(static_cast<Render::Camera::SamplerType>(m_SamplingType) == Render::Camera::SamplerType::Accumulation)
         {
-            m_SceneSamples = static_cast<int>(m_Renderer.GetFrameCounter());
+            m_SceneSamples = static_cast<int>(status.FrameCounter);
             if(ImGui::Button("Render", ImVec2(ImGui::GetWindowSize().x * 0.45f, 0.0f)))
             {
                 Render();
@@ -99,13 +201,12 @@ public:
             ImGui::SameLine();
             if(ImGui::Button("Reset", ImVec2(ImGui::GetWindowSize().x * 0.45f, 0.0f)))
             {
-                m_Renderer.ResetFrameCounter();
+                m_ResetAccumulation = true;
                 Render();
             }
         }
         else
         {
-            m_Renderer.ResetFrameCounter();
             if(ImGui::Button("Render", ImVec2(-FLT_MIN, 0.0f)))
             {
                 Render();
@@ -115,6 +216,16 @@ public:
         static bool loopRendering = false;
         ImGui::Checkbox("Loop Rendering", &loopRendering);
 
+        if(status.Busy)
+        {
+            ImGui::ProgressBar(static_cast<float>(status.Progress), ImVec2(ImGui::GetWindowSize().x * 0.7f, 0.0f));
+            ImGui::SameLine();
+            if(ImGui::Button("Cancel", ImVec2(-FLT_MIN, 0.0f)))
+            {
+                m_RenderThread.Cancel();
+            }
+        }
+
         const int miliseconds = static_cast<int>(m_LastRenderTime) % 1000;
         const int seconds     = static_cast<int>(m_LastRenderTime) / 1000 % 60;
         const int minutes     = static_cast<int>(m_LastRenderTime) / 1000 / 60 % 60;
@@ -140,6 +251,13 @@ public:
         }
         ImGui::Text("%dms", miliseconds);
 
+        if(m_RendererType == 1 || m_RendererType == 3)
+        {
+            const Render::TileStats& tileStats = status.Tiles;
+            ImGui::Text("Tiles: %zu on %u threads, %u stolen", tileStats.TileCount, tileStats.ThreadCount, tileStats.StealCount);
+            ImGui::Text("Tile time: min %.3f ms, mean %.3f ms, max %.3f ms", tileStats.MinTileMs, tileStats.MeanTileMs, tileStats.MaxTileMs);
+        }
+
         ImGui::End();
 
         ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
@@ -158,7 +276,7 @@ public:
         m_ViewportHeight = static_cast<int>(m_ViewportWidth / m_AspectRatio);
         m_ViewportHeight = (m_ViewportHeight < 1) ? 1 : m_ViewportHeight;
 
-        if(const auto image = m_Renderer.GetImage())
+        if(const auto image = m_Image)
         {
             m_ImageWidth  = static_cast<float>(image->GetWidth());
             m_ImageHeight = static_cast<float>(image->GetHeight());
@@ -171,127 +289,146 @@ public:
         ImGui::PopStyleColor();
         ImGui::PopStyleVar();
 
-        if(loopRendering)
+        // A new frame is only queued once the last one is done, so the loop never cancels its own work.
+        if(loopRendering && !m_RenderThread.IsBusy())
         {
             Render();
         }
     }
 
+    // Queues a frame on the render thread, cancelling the one in flight. The world and lights are compiled here, so that
+    // the job only reads them. The job gets copies of all settings, they can change while it runs.
     void Render()
     {
-        const Utils::Timer timer;
-
-        m_Renderer.SetImageSize(m_ViewportWidth, m_ViewportHeight);
-        switch(m_RendererId)
-        {
-            case 0:
-            {
-                Render::Camera camera         = m_Scene->GetCamera();
-                camera.RenderingType          = static_cast<Render::Camera::RenderType>(m_RendererType);
-                camera.SamplingType           = static_cast<Render::Camera::SamplerType>(m_SamplingType);
-                camera.UsePDF                 = m_UsePDF;
-                camera.UseUnidirectionalLight = m_UseUnidirectionalLight;
-                m_Renderer.Render(camera, m_Scene->GetWorld(), m_Scene->GetLights());
-                break;
-            }
-            case 1:
-            {
-                m_Renderer.RenderRandom();
-                break;
-            }
-            case 2:
+        const uint32_t               width      = m_ViewportWidth;
+        const uint32_t               height     = m_ViewportHeight;
+        const auto                   tileSize   = static_cast<uint32_t>(m_TileSize);
+        const auto                   tileOrder  = static_cast<Render::TileOrder>(m_TileOrder);
+        const int                    rendererId = m_RendererId;
+        const bool                   restart    = m_ResetAccumulation || static_cast<Render::Camera::SamplerType>(m_SamplingType) != Render::Camera::SamplerType::Accumulation;
+        const Render::Camera         camera     = MakeCamera();
+        const Objects::Hittable*     world      = &m_Scene->GetWorld();
+        const Objects::HittableList* lights     = &m_Scene->GetLights();
+
+        m_ResetAccumulation = false;
+        m_RenderThread.Submit(
+            // The scene is captured to keep the world and lights alive while the job runs.
+            [=, scene = m_Scene](Render::Renderer& renderer)
             {
+                renderer.SetImageSize(width, height);
+                renderer.SetTileSize(tileSize);
+                renderer.SetTileOrder(tileOrder);
+                if(restart)
+                {
+                    renderer.ResetFrameCounter();
+                }
 
-                m_Renderer.RenderHelloWorld();
-                break;
-            }
-            default:
-            {
+                switch(rendererId)
+                {
+                    case 0:
+                    {
+                        Render::Camera frameCamera = camera;
+                        renderer.Render(frameCamera, *world, *lights);
+                        break;
+                    }
+                    case 1:
+                    {
+                        renderer.RenderRandom();
+                        break;
+                    }
+                    case 2:
+                    {
+
+                        renderer.RenderHelloWorld();
+                        break;
+                    }
+                    default:
+                    {
+
+                        renderer.RenderRandom();
+                        break;
+                    }
+                }
+            });
+    }
 
-                m_Renderer.RenderRandom();
-                break;
-            }
-        }
-        m_LastRenderTime = timer.ElapsedMilliseconds();
+    Render::Camera MakeCamera()
+    {
+        Render::Camera camera         = m_Scene->GetCamera();
+        camera.RenderingType          = static_cast<Render::Camera::RenderType>(m_RendererType);
+        camera.SamplingType           = static_cast<Render::Camera::SamplerType>(m_SamplingType);
+        camera.AdaptiveMinSpp         = m_AdaptiveMinSpp;
+        camera.AdaptiveMaxSpp         = m_AdaptiveMaxSpp;
+        camera.AdaptiveThreshold      = m_AdaptiveThreshold;
+        camera.ShowSampleCount        = m_ShowSampleCount;
+        camera.UsePDF                 = m_UsePDF;
+        camera.UseUnidirectionalLight = m_UseUnidirectionalLight;
+        camera.Integrator             = static_cast<Render::Camera::IntegratorType>(m_Integrator);
+        camera.UseRussianRoulette     = m_UseRussianRoulette;
+        camera.RussianRouletteDepth   = m_RussianRouletteDepth;
+        camera.PacketSize             = m_PacketSize;
+        camera.DeterministicSampling  = m_DeterministicSampling;
+        camera.Seed                   = m_Seed;
+        return camera;
     }
 
-    void SetScene()
+    // Uploads the pixels of the render thread into the image shown in the viewport.
+    void UpdateImage(const uint32_t width, const uint32_t height)
     {
-        switch(m_SceneId)
+        if(!m_Image)
+        {
+            m_Image = std::make_shared<Engine::Image>(width, height, Engine::ImageFormat::RGBA);
+        }
+        else if(m_Image->GetWidth() != width || m_Image->GetHeight() != height)
         {
-            case 0:
-                m_Scene = std::make_shared<Scenes::RTWeekOneDefaultScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 1:
-                m_Scene = std::make_shared<Scenes::RTWeekOneTestScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 2:
-                m_Scene = std::make_shared<Scenes::RTWeekOneFinalScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 3:
-                m_Scene = std::make_shared<Scenes::RTWeekNextDefaultScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 4:
-                m_Scene = std::make_shared<Scenes::RTWeekNextRandomSpheresScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 5:
-                m_Scene = std::make_shared<Scenes::RTWeekNextTwoSpheresScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 6:
-                m_Scene = std::make_shared<Scenes::RTWeekNextEarthScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 7:
-                m_Scene = std::make_shared<Scenes::RTWeekNextTwoPerlinSpheresScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 8:
-                m_Scene = std::make_shared<Scenes::RTWeekNextQuadsScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 9:
-                m_Scene = std::make_shared<Scenes::RTWeekNextSimpleLightScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 10:
-                m_Scene = std::make_shared<Scenes::RTWeekNextCornellBoxScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 11:
-                m_Scene = std::make_shared<Scenes::RTWeekNextCornellSmokeScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 12:
-                m_Scene = std::make_shared<Scenes::RTWeekNextFinalScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 13:
-                m_Scene = std::make_shared<Scenes::RTWeekRestACornellBoxScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 14:
-                m_Scene = std::make_shared<Scenes::RTWeekRestBCornellBoxMirrorScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 15:
-                m_Scene = std::make_shared<Scenes::RTWeekRestCCornellBoxGlassScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 16:
-                m_Scene = std::make_shared<Scenes::WhiteSperesScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
-            case 17:
-            default:
-                m_Scene = std::make_shared<Scenes::CornellBoxLightsScene>(m_AspectRatio, m_ViewportWidth, m_SceneSamples, m_SceneDepth);
-                break;
+            m_Image->Resize(width, height);
         }
+        m_Image->SetData(m_Pixels.data());
+    }
+
+    // The old scene stays alive until the job that renders it has stopped.
+    void SetScene()
+    {
+        m_RenderThread.Cancel();
+        m_ResetAccumulation = true;
+        m_Scene = Scenes::CreateScene(m_SceneId, m_AspectRatio, static_cast<int>(m_ViewportWidth), m_SceneSamples, m_SceneDepth);
+        m_Scene->SetBVHBuildOptions(m_BVHBuildOptions);
+        m_Scene->SetLightSelection(static_cast<Objects::LightSelection>(m_LightSelection));
     }
 
 private:
     // Rendering
-    Render::Renderer m_Renderer;
-    int              m_RendererId             = 0;
-    int              m_RendererType           = 1;
-    int              m_SamplingType           = 2;
-    double           m_LastRenderTime         = 0.0;
-    bool             m_UsePDF                 = true;
-    bool             m_UseUnidirectionalLight = true;
+    Render::RenderThread           m_RenderThread;
+    std::vector<uint32_t>          m_Pixels;    // Copy of the front buffer of the render thread
+    std::shared_ptr<Engine::Image> m_Image;
+    int                            m_RendererId             = 0;
+    int                            m_RendererType           = 1;
+    int                            m_SamplingType           = 2;
+    int                            m_PacketSize             = 16;
+    int                            m_TileSize               = 32;
+    int                            m_TileOrder              = 2;
+    int                            m_AdaptiveMinSpp         = 16;
+    int                            m_AdaptiveMaxSpp         = 1024;
+    double                         m_AdaptiveThreshold      = 0.005;
+    bool                           m_ShowSampleCount        = false;
+    double                         m_LastRenderTime         = 0.0;
+    bool                           m_UsePDF                 = true;
+    bool                           m_UseUnidirectionalLight = true;
+    int                            m_Integrator             = 2;
+    bool                           m_UseRussianRoulette     = true;
+    int                            m_RussianRouletteDepth   = 3;
+    int                            m_LightSelection         = 0;
+    bool                           m_DeterministicSampling  = false;
+    uint64_t                       m_Seed                   = 0;
+    bool                           m_ResetAccumulation      = true;
 
     // Scene
-    std::shared_ptr<Scenes::Scene> m_Scene        = nullptr;
-    int                            m_SceneId      = 17;
-    int                            m_SceneDepth   = 50;
-    int                            m_SceneSamples = 10;
+    std::shared_ptr<Scenes::Scene> m_Scene         = nullptr;
+    int                            m_SceneId       = 17;
+    int                            m_SceneDepth    = 50;
+    int                            m_SceneSamples  = 10;
+    int                            m_InstanceIndex = 0;
+    Objects::BVHBuildOptions       m_BVHBuildOptions;
 
     // Output
     // double   m_AspectRatio    = 16.0 / 9.0;
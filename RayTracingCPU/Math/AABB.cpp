@@ -38,10 +38,10 @@ AABB::AABB(const AABB& box0, const AABB& box1)
 // Return an AABB that has no side narrower than some delta, padding if necessary.
 AABB AABB::Pad() const
 {
-    constexpr double delta = 0.0001;
-    const Interval   newX  = (X.Size() >= delta) ? X : X.Expand(delta);
-    const Interval   newY  = (Y.Size() >= delta) ? Y : Y.Expand(delta);
-    const Interval   newZ  = (Z.Size() >= delta) ? Z : Z.Expand(delta);
+    constexpr Real delta = 0.0001;
+    const Interval newX  = (X.Size() >= delta) ? X : X.Expand(delta);
+    const Interval newY  = (Y.Size() >= delta) ? Y : Y.Expand(delta);
+    const Interval newZ  = (Z.Size() >= delta) ? Z : Z.Expand(delta);
 
     return {newX, newY, newZ};
 }
@@ -108,7 +108,7 @@ bool AABB::HitNew(const Render::Ray& ray, Interval rayT) const
     for(int axis = 0; axis < 3; axis++)
     {
         const Interval& ax    = AxisInterval(axis);
-        const double    adinv = 1.0 / rayDir[axis];
+        const Real      adinv = 1.0 / rayDir[axis];
 
         const auto s = (ax.Min - rayOrig[axis]) * adinv;
         const auto t = (ax.Max - rayOrig[axis]) * adinv;
@@ -137,7 +137,7 @@ int AABB::LongestAxis() const
 // Adjust the AABB so that no side is narrower than some delta, padding if necessary.
 void AABB::PadToMinimums()
 {
-    constexpr double delta = 0.0001;
+    constexpr Real delta = 0.0001;
     if(X.Size() < delta)
         X = X.Expand(delta);
     if(Y.Size() < delta)
@@ -146,7 +146,9 @@ void AABB::PadToMinimums()
         Z = Z.Expand(delta);
 }
 
-const AABB AABB::Empty    = AABB(Interval::Empty, Interval::Empty, Interval::Empty);
-const AABB AABB::Universe = AABB(Interval::Universe, Interval::Universe, Interval::Universe);
+// Built from literal intervals: Interval::Empty and Interval::Universe live in another translation unit and may not be
+// initialized yet, which used to turn AABB::Empty into a tiny box around the origin.
+const AABB AABB::Empty    = AABB(Interval(+Infinity, -Infinity), Interval(+Infinity, -Infinity), Interval(+Infinity, -Infinity));
+const AABB AABB::Universe = AABB(Interval(-Infinity, +Infinity), Interval(-Infinity, +Infinity), Interval(-Infinity, +Infinity));
 
 }    // namespace Math
@@ -0,0 +1,79 @@
+#include "AliasTable.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Math
+{
+
+AliasTable::AliasTable(const std::vector<Real>& weights)
+    : m_Bins(weights.size())
+{
+    if(m_Bins.empty())
+        return;
+
+    double sum = 0.0;
+    for(const Real weight : weights)
+    {
+        sum += std::max<Real>(weight, 0);
+    }
+
+    const size_t count = m_Bins.size();
+    for(size_t i = 0; i < count; i++)
+    {
+        m_Bins[i].PMF = static_cast<Real>(sum > 0.0 ? std::max<Real>(weights[i], 0) / sum : 1.0 / static_cast<double>(count));
+    }
+
+    // Split the items by whether their probability scaled by the count is below or above one. Each item below one then
+    // fills the rest of its bin with an item above one, whose excess shrinks by that amount.
+    std::vector<double>   scaled(count);
+    std::vector<uint32_t> under;
+    std::vector<uint32_t> over;
+    for(size_t i = 0; i < count; i++)
+    {
+        scaled[i] = static_cast<double>(m_Bins[i].PMF) * static_cast<double>(count);
+        (scaled[i] < 1.0 ? under : over).emplace_back(static_cast<uint32_t>(i));
+    }
+
+    while(!under.empty() && !over.empty())
+    {
+        const uint32_t small = under.back();
+        const uint32_t large = over.back();
+        under.pop_back();
+        over.pop_back();
+
+        m_Bins[small].Threshold = static_cast<Real>(scaled[small]);
+        m_Bins[small].Alias     = large;
+
+        scaled[large] += scaled[small] - 1.0;
+        (scaled[large] < 1.0 ? under : over).emplace_back(large);
+    }
+
+    // Whatever is left only differs from one by rounding and keeps its whole bin.
+    for(const uint32_t i : under)
+    {
+        m_Bins[i].Threshold = 1;
+        m_Bins[i].Alias     = i;
+    }
+    for(const uint32_t i : over)
+    {
+        m_Bins[i].Threshold = 1;
+        m_Bins[i].Alias     = i;
+    }
+}
+
+uint32_t AliasTable::Sample(const Real u, Real& pmf) const
+{
+    constexpr Real OneMinusEpsilon = 1 - std::numeric_limits<Real>::epsilon();
+
+    // The integer part of the scaled number picks the bin, the fraction decides between the item and its alias.
+    const Real     scaled = u * static_cast<Real>(m_Bins.size());
+    const uint32_t bin    = std::min(static_cast<uint32_t>(scaled), static_cast<uint32_t>(m_Bins.size() - 1));
+    const Real     up     = std::min(scaled - static_cast<Real>(bin), OneMinusEpsilon);
+
+    const uint32_t index = up < m_Bins[bin].Threshold ? bin : m_Bins[bin].Alias;
+    pmf                  = m_Bins[index].PMF;
+    return index;
+}
+
+}    // namespace Math
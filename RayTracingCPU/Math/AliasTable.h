@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Precision.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Math
+{
+
+// Discrete distribution over items in proportion to their weights, sampled in O(1) from a single number, see Vose,
+// "A Linear Algorithm for Generating Random Numbers with a Given Distribution" (1991). Every bin holds one item up to
+// its threshold and an alias of a heavier item above it.
+class AliasTable
+{
+public:
+    AliasTable() = default;
+
+    // Items without any weight are never picked. If all weights are zero, the items are picked uniformly.
+    explicit AliasTable(const std::vector<Real>& weights);
+
+    // Picks an item for u in [0, 1), along with its probability.
+    uint32_t Sample(Real u, Real& pmf) const;
+
+    Real   PMF(const uint32_t index) const { return m_Bins[index].PMF; }
+    size_t Size() const { return m_Bins.size(); }
+
+private:
+    struct Bin
+    {
+        Real     Threshold = 1;
+        Real     PMF       = 0;
+        uint32_t Alias     = 0;
+    };
+
+    std::vector<Bin> m_Bins;
+};
+
+}    // namespace Math
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Precision.h"
+
 // Constants
 #include <limits>
 
@@ -7,7 +9,7 @@ namespace Math
 {
 
 // Constants
-const double     Infinity = std::numeric_limits<double>::infinity();
-constexpr double Pi       = 3.1415926535897932385;
+constexpr Real Infinity = std::numeric_limits<Real>::infinity();
+constexpr Real Pi       = static_cast<Real>(3.1415926535897932385);
 
 }    // namespace Math
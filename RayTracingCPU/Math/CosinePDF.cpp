@@ -10,7 +10,7 @@ CosinePDF::CosinePDF(const Vector3& w)
     m_Uvw.BuildFromW(w);
 }
 
-double CosinePDF::Value(const Vector3& direction) const
+Real CosinePDF::Value(const Vector3& direction) const
 {
     const auto cosineTheta = DotProduct(UnitVector(direction), m_Uvw.W());
     // return 1 / (2 * Pi) * (1 + cosineTheta);
@@ -1,18 +1,18 @@
 #pragma once
 
 #include "ONB.h"
-#include "PDF.h"
+#include "Vector3.h"
 
 namespace Math
 {
 
-class CosinePDF final : public PDF
+class CosinePDF
 {
 public:
     explicit CosinePDF(const Vector3& w);
 
-    double  Value(const Vector3& direction) const override;
-    Vector3 Generate() const override;
+    Real    Value(const Vector3& direction) const;
+    Vector3 Generate() const;
 
 private:
     ONB m_Uvw;
@@ -3,14 +3,14 @@
 namespace Math
 {
 
-double HittablePDF::Value(const Vector3& direction) const
+Real HittablePDF::Value(const Vector3& direction) const
 {
-    return m_Objects.PDFValue(m_Origin, direction);
+    return m_Objects->PDFValue(m_Origin, direction);
 }
 
 Vector3 HittablePDF::Generate() const
 {
-    return m_Objects.Random(m_Origin);
+    return m_Objects->Random(m_Origin);
 }
 
 }    // namespace Math
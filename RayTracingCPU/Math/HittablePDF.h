@@ -1,26 +1,26 @@
 #pragma once
 
-#include "PDF.h"
+#include "Vector3.h"
 
 #include <Objects/Hittable.h>
 
 namespace Math
 {
 
-class HittablePDF final : public PDF
+class HittablePDF
 {
 public:
     HittablePDF(const Objects::Hittable& objects, const Point3& origin)
-        : m_Objects(objects)
+        : m_Objects(&objects)
         , m_Origin(origin)
     {
     }
 
-    double  Value(const Vector3& direction) const override;
-    Vector3 Generate() const override;
+    Real    Value(const Vector3& direction) const;
+    Vector3 Generate() const;
 
 private:
-    const Objects::Hittable& m_Objects;
+    const Objects::Hittable* m_Objects;
     Point3                   m_Origin;
 };
 
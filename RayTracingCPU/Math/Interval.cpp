@@ -17,7 +17,7 @@ Interval::Interval()
 {
 }
 
-Interval::Interval(const double min, const double max)
+Interval::Interval(const Real min, const Real max)
     : Min(min)
     , Max(max)
 {
@@ -37,12 +37,12 @@ bool Interval::IsEmpty() const
     return !(Min <= Max);
 }
 
-double Interval::Size() const
+Real Interval::Size() const
 {
     return Max - Min;
 }
 
-Interval Interval::Expand(const double delta) const
+Interval Interval::Expand(const Real delta) const
 {
     const auto padding = delta / 2;
     return {Min - padding, Max + padding};
@@ -50,22 +50,22 @@ Interval Interval::Expand(const double delta) const
 
 Interval Interval::Intersect(const Interval& other) const
 {
-    double a = Min >= other.Min ? Min : other.Min;
-    double b = Max <= other.Max ? Max : other.Max;
+    Real a = Min >= other.Min ? Min : other.Min;
+    Real b = Max <= other.Max ? Max : other.Max;
     return {a, b};
 }
 
-bool Interval::Contains(const double x) const
+bool Interval::Contains(const Real x) const
 {
     return Min <= x && x <= Max;
 }
 
-bool Interval::Surrounds(const double x) const
+bool Interval::Surrounds(const Real x) const
 {
     return Min < x && x < Max;
 }
 
-double Interval::Clamp(const double x) const
+Real Interval::Clamp(const Real x) const
 {
     if(x < Min)
     {
@@ -78,7 +78,7 @@ double Interval::Clamp(const double x) const
     return x;
 }
 
-Interval Interval::Span(double a, double b)
+Interval Interval::Span(Real a, Real b)
 {
     if(a > b)
         return {b, a};
@@ -10,14 +10,14 @@ namespace Math
 class Interval
 {
 public:
-    double                Min;
-    double                Max;
+    Real                  Min;
+    Real                  Max;
     static const Interval Empty;
     static const Interval Universe;
 
     // Default interval is empty
     Interval();
-    Interval(const double min, const double max);
+    Interval(const Real min, const Real max);
     Interval(const Interval& a, const Interval& b);
 
     /*
@@ -25,25 +25,25 @@ public:
      */
     bool IsEmpty() const;
 
-    double   Size() const;
-    Interval Expand(double delta) const;
+    Real     Size() const;
+    Interval Expand(Real delta) const;
     Interval Intersect(const Interval& other) const;
-    bool     Contains(double x) const;
-    bool     Surrounds(double x) const;
-    double   Clamp(double x) const;
+    bool     Contains(Real x) const;
+    bool     Surrounds(Real x) const;
+    Real     Clamp(Real x) const;
 
     /*
      * @brief Return the non-empty interval between a and b, regardless of their order.
      */
-    static Interval Span(double a, double b);
+    static Interval Span(Real a, Real b);
 };
 
-inline Interval operator+(const Interval& intervalValue, const double displacement)
+inline Interval operator+(const Interval& intervalValue, const Real displacement)
 {
     return {intervalValue.Min + displacement, intervalValue.Max + displacement};
 }
 
-inline Interval operator+(const double displacement, const Interval& intervalValue)
+inline Interval operator+(const Real displacement, const Interval& intervalValue)
 {
     return intervalValue + displacement;
 }
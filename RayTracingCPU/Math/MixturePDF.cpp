@@ -3,13 +3,13 @@
 namespace Math
 {
 
-MixturePDF::MixturePDF(const std::shared_ptr<PDF>& p0, const std::shared_ptr<PDF>& p1)
+MixturePDF::MixturePDF(const PDF& p0, const PDF& p1)
 {
-    m_P[0] = p0;
-    m_P[1] = p1;
+    m_P[0] = &p0;
+    m_P[1] = &p1;
 }
 
-double MixturePDF::Value(const Vector3& direction) const
+Real MixturePDF::Value(const Vector3& direction) const
 {
     return 0.5 * m_P[0]->Value(direction) + 0.5 * m_P[1]->Value(direction);
 }
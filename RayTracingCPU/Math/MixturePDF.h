@@ -2,21 +2,20 @@
 
 #include "PDF.h"
 
-#include <memory>
-
 namespace Math
 {
 
-class MixturePDF final : public PDF
+// Picks either PDF with equal probability. Only refers to the two PDFs, so they have to outlive the mixture.
+class MixturePDF
 {
 public:
-    MixturePDF(const std::shared_ptr<PDF>& p0, const std::shared_ptr<PDF>& p1);
+    MixturePDF(const PDF& p0, const PDF& p1);
 
-    double  Value(const Vector3& direction) const override;
-    Vector3 Generate() const override;
+    Real    Value(const Vector3& direction) const;
+    Vector3 Generate() const;
 
 private:
-    std::shared_ptr<PDF> m_P[2];
+    const PDF* m_P[2];
 };
 
 }    // namespace Math
@@ -30,7 +30,7 @@ Vector3 ONB::W() const
     return m_Axis[2];
 }
 
-Vector3 ONB::Local(const double a, const double b, const double c) const
+Vector3 ONB::Local(const Real a, const Real b, const Real c) const
 {
     return a * U() + b * V() + c * W();
 }
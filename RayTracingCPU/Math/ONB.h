@@ -17,7 +17,7 @@ public:
     Vector3 V() const;
     Vector3 W() const;
 
-    Vector3 Local(double a, double b, double c) const;
+    Vector3 Local(Real a, Real b, Real c) const;
     Vector3 Local(const Vector3& a) const;
     void    BuildFromW(const Vector3& w);
 
@@ -2,4 +2,31 @@
 
 namespace Math
 {
+
+Real PDF::Value(const Vector3& direction) const
+{
+    return std::visit(
+        [&direction]<typename T>(const T& pdf)
+        {
+            if constexpr(std::is_same_v<T, std::monostate>)
+                return Real(0);
+            else
+                return pdf.Value(direction);
+        },
+        m_PDF);
+}
+
+Vector3 PDF::Generate() const
+{
+    return std::visit(
+        []<typename T>(const T& pdf)
+        {
+            if constexpr(std::is_same_v<T, std::monostate>)
+                return Vector3();
+            else
+                return pdf.Generate();
+        },
+        m_PDF);
+}
+
 }    // namespace Math
@@ -1,17 +1,35 @@
 #pragma once
 
+#include "CosinePDF.h"
+#include "HittablePDF.h"
+#include "SpherePDF.h"
 #include "Vector3.h"
 
+#include <variant>
+
 namespace Math
 {
 
+// Holds any of the concrete PDFs by value. Scattering runs once per bounce, so the PDFs live on the stack instead of
+// behind shared pointers. An empty PDF has zero density and generates a zero vector.
 class PDF
 {
 public:
-    virtual ~PDF() = default;
+    PDF() = default;
+
+    template <typename T>
+    PDF(const T& pdf)
+        : m_PDF(pdf)
+    {
+    }
+
+    bool Empty() const { return std::holds_alternative<std::monostate>(m_PDF); }
+
+    Real    Value(const Vector3& direction) const;
+    Vector3 Generate() const;
 
-    virtual double  Value(const Vector3& direction) const = 0;
-    virtual Vector3 Generate() const                      = 0;
+private:
+    std::variant<std::monostate, CosinePDF, HittablePDF, SpherePDF> m_PDF;
 };
 
 }    // namespace Math
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace Math
+{
+
+// Scalar of the math core. Float builds trade precision for twice the SIMD width and half the memory traffic.
+#if defined(RT_REAL_FLOAT)
+using Real = float;
+#else
+using Real = double;
+#endif
+
+// Bound on the relative rounding error of n consecutive floating-point operations, see pbrt section 6.8.
+constexpr Real Gamma(const int n)
+{
+    constexpr Real machineEpsilon = std::numeric_limits<Real>::epsilon() / 2;
+    return n * machineEpsilon / (1 - n * machineEpsilon);
+}
+
+// Neighbours of v on the floating-point grid, cheaper than std::nextafter on the ray spawning path.
+inline Real NextRealUp(Real v)
+{
+    using Bits = std::conditional_t<sizeof(Real) == 4, uint32_t, uint64_t>;
+
+    if(std::isinf(v) && v > 0)
+        return v;
+    if(v == 0)
+        v = 0;    // Turn -0 into +0, whose successor is the smallest positive subnormal
+    auto bits = std::bit_cast<Bits>(v);
+    bits      = v >= 0 ? bits + 1 : bits - 1;
+    return std::bit_cast<Real>(bits);
+}
+
+inline Real NextRealDown(Real v)
+{
+    using Bits = std::conditional_t<sizeof(Real) == 4, uint32_t, uint64_t>;
+
+    if(std::isinf(v) && v < 0)
+        return v;
+    if(v == 0)
+        v = -0.0;
+    auto bits = std::bit_cast<Bits>(v);
+    bits      = v > 0 ? bits - 1 : bits + 1;
+    return std::bit_cast<Real>(bits);
+}
+
+}    // namespace Math
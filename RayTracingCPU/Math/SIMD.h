@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Precision.h"
+
+#include <Utils/CPUFeatures.h>
+
+#if RT_ARCH_X86
+    #include <immintrin.h>
+#endif
+
+#include <cmath>
+#include <cstdint>
+
+// The generic kernels pass AVX vectors between these helpers, which are all inlined into their AVX2 entry points. This
+// header is only included by the translation units holding such kernels.
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+namespace Math::SIMD
+{
+
+// The SoA primitive kernels are written once against these lane types. Each one wraps the vector instructions of one
+// instruction set for the precision of Real. Masks follow the SSE convention: AndNot(a, b) is (not a) and b.
+
+struct ScalarLanes
+{
+    static constexpr int Size = 1;
+
+    using Type = Real;
+    using Mask = bool;
+
+    static Type     Load(const Real* p) { return *p; }
+    static void     Store(Real* p, const Type v) { *p = v; }
+    static Type     Set(const Real v) { return v; }
+    static Type     Add(const Type a, const Type b) { return a + b; }
+    static Type     Sub(const Type a, const Type b) { return a - b; }
+    static Type     Mul(const Type a, const Type b) { return a * b; }
+    static Type     Div(const Type a, const Type b) { return a / b; }
+    static Type     Sqrt(const Type a) { return std::sqrt(a); }
+    static Type     Min(const Type a, const Type b) { return a < b ? a : b; }
+    static Type     Max(const Type a, const Type b) { return a > b ? a : b; }
+    static Type     CopySign(const Type magnitude, const Type sign) { return std::copysign(magnitude, sign); }
+    static Type     Abs(const Type a) { return std::fabs(a); }
+    static Mask     Less(const Type a, const Type b) { return a < b; }
+    static Mask     GreaterEqual(const Type a, const Type b) { return a >= b; }
+    static Mask     And(const Mask a, const Mask b) { return a && b; }
+    static Mask     Or(const Mask a, const Mask b) { return a || b; }
+    static Mask     AndNot(const Mask a, const Mask b) { return !a && b; }
+    static Type     Select(const Mask m, const Type a, const Type b) { return m ? a : b; }
+    static uint32_t MoveMask(const Mask m) { return m ? 1u : 0u; }
+};
+
+#if RT_ARCH_X86
+    #if defined(RT_REAL_FLOAT)
+// SSE is part of x86-64, so these lanes need no dispatch.
+struct SSELanes
+{
+    static constexpr int Size = 4;
+
+    using Type = __m128;
+    using Mask = __m128;
+
+    static Type     Load(const Real* p) { return _mm_load_ps(p); }
+    static void     Store(Real* p, const Type v) { _mm_store_ps(p, v); }
+    static Type     Set(const Real v) { return _mm_set1_ps(v); }
+    static Type     Add(const Type a, const Type b) { return _mm_add_ps(a, b); }
+    static Type     Sub(const Type a, const Type b) { return _mm_sub_ps(a, b); }
+    static Type     Mul(const Type a, const Type b) { return _mm_mul_ps(a, b); }
+    static Type     Div(const Type a, const Type b) { return _mm_div_ps(a, b); }
+    static Type     Sqrt(const Type a) { return _mm_sqrt_ps(a); }
+    static Type     Min(const Type a, const Type b) { return _mm_min_ps(a, b); }
+    static Type     Max(const Type a, const Type b) { return _mm_max_ps(a, b); }
+    static Type     CopySign(const Type magnitude, const Type sign) { return _mm_or_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), magnitude), _mm_and_ps(_mm_set1_ps(-0.0f), sign)); }
+    static Type     Abs(const Type a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static Mask     Less(const Type a, const Type b) { return _mm_cmplt_ps(a, b); }
+    static Mask     GreaterEqual(const Type a, const Type b) { return _mm_cmpge_ps(a, b); }
+    static Mask     And(const Mask a, const Mask b) { return _mm_and_ps(a, b); }
+    static Mask     Or(const Mask a, const Mask b) { return _mm_or_ps(a, b); }
+    static Mask     AndNot(const Mask a, const Mask b) { return _mm_andnot_ps(a, b); }
+    static Type     Select(const Mask m, const Type a, const Type b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    static uint32_t MoveMask(const Mask m) { return static_cast<uint32_t>(_mm_movemask_ps(m)); }
+};
+
+struct AVX2Lanes
+{
+    static constexpr int Size = 8;
+
+    using Type = __m256;
+    using Mask = __m256;
+
+    RT_TARGET_AVX2 static Type     Load(const Real* p) { return _mm256_load_ps(p); }
+    RT_TARGET_AVX2 static void     Store(Real* p, const Type v) { _mm256_store_ps(p, v); }
+    RT_TARGET_AVX2 static Type     Set(const Real v) { return _mm256_set1_ps(v); }
+    RT_TARGET_AVX2 static Type     Add(const Type a, const Type b) { return _mm256_add_ps(a, b); }
+    RT_TARGET_AVX2 static Type     Sub(const Type a, const Type b) { return _mm256_sub_ps(a, b); }
+    RT_TARGET_AVX2 static Type     Mul(const Type a, const Type b) { return _mm256_mul_ps(a, b); }
+    RT_TARGET_AVX2 static Type     Div(const Type a, const Type b) { return _mm256_div_ps(a, b); }
+    RT_TARGET_AVX2 static Type     Sqrt(const Type a) { return _mm256_sqrt_ps(a); }
+    RT_TARGET_AVX2 static Type     Min(const Type a, const Type b) { return _mm256_min_ps(a, b); }
+    RT_TARGET_AVX2 static Type     Max(const Type a, const Type b) { return _mm256_max_ps(a, b); }
+    RT_TARGET_AVX2 static Type     CopySign(const Type magnitude, const Type sign) { return _mm256_or_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), magnitude), _mm256_and_ps(_mm256_set1_ps(-0.0f), sign)); }
+    RT_TARGET_AVX2 static Type     Abs(const Type a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    RT_TARGET_AVX2 static Mask     Less(const Type a, const Type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    RT_TARGET_AVX2 static Mask     GreaterEqual(const Type a, const Type b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    RT_TARGET_AVX2 static Mask     And(const Mask a, const Mask b) { return _mm256_and_ps(a, b); }
+    RT_TARGET_AVX2 static Mask     Or(const Mask a, const Mask b) { return _mm256_or_ps(a, b); }
+    RT_TARGET_AVX2 static Mask     AndNot(const Mask a, const Mask b) { return _mm256_andnot_ps(a, b); }
+    RT_TARGET_AVX2 static Type     Select(const Mask m, const Type a, const Type b) { return _mm256_blendv_ps(b, a, m); }
+    RT_TARGET_AVX2 static uint32_t MoveMask(const Mask m) { return static_cast<uint32_t>(_mm256_movemask_ps(m)); }
+};
+    #else
+// SSE2 is part of x86-64, so these lanes need no dispatch.
+struct SSELanes
+{
+    static constexpr int Size = 2;
+
+    using Type = __m128d;
+    using Mask = __m128d;
+
+    static Type     Load(const Real* p) { return _mm_load_pd(p); }
+    static void     Store(Real* p, const Type v) { _mm_store_pd(p, v); }
+    static Type     Set(const Real v) { return _mm_set1_pd(v); }
+    static Type     Add(const Type a, const Type b) { return _mm_add_pd(a, b); }
+    static Type     Sub(const Type a, const Type b) { return _mm_sub_pd(a, b); }
+    static Type     Mul(const Type a, const Type b) { return _mm_mul_pd(a, b); }
+    static Type     Div(const Type a, const Type b) { return _mm_div_pd(a, b); }
+    static Type     Sqrt(const Type a) { return _mm_sqrt_pd(a); }
+    static Type     Min(const Type a, const Type b) { return _mm_min_pd(a, b); }
+    static Type     Max(const Type a, const Type b) { return _mm_max_pd(a, b); }
+    static Type     CopySign(const Type magnitude, const Type sign) { return _mm_or_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), magnitude), _mm_and_pd(_mm_set1_pd(-0.0), sign)); }
+    static Type     Abs(const Type a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static Mask     Less(const Type a, const Type b) { return _mm_cmplt_pd(a, b); }
+    static Mask     GreaterEqual(const Type a, const Type b) { return _mm_cmpge_pd(a, b); }
+    static Mask     And(const Mask a, const Mask b) { return _mm_and_pd(a, b); }
+    static Mask     Or(const Mask a, const Mask b) { return _mm_or_pd(a, b); }
+    static Mask     AndNot(const Mask a, const Mask b) { return _mm_andnot_pd(a, b); }
+    static Type     Select(const Mask m, const Type a, const Type b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+    static uint32_t MoveMask(const Mask m) { return static_cast<uint32_t>(_mm_movemask_pd(m)); }
+};
+
+struct AVX2Lanes
+{
+    static constexpr int Size = 4;
+
+    using Type = __m256d;
+    using Mask = __m256d;
+
+    RT_TARGET_AVX2 static Type     Load(const Real* p) { return _mm256_load_pd(p); }
+    RT_TARGET_AVX2 static void     Store(Real* p, const Type v) { _mm256_store_pd(p, v); }
+    RT_TARGET_AVX2 static Type     Set(const Real v) { return _mm256_set1_pd(v); }
+    RT_TARGET_AVX2 static Type     Add(const Type a, const Type b) { return _mm256_add_pd(a, b); }
+    RT_TARGET_AVX2 static Type     Sub(const Type a, const Type b) { return _mm256_sub_pd(a, b); }
+    RT_TARGET_AVX2 static Type     Mul(const Type a, const Type b) { return _mm256_mul_pd(a, b); }
+    RT_TARGET_AVX2 static Type     Div(const Type a, const Type b) { return _mm256_div_pd(a, b); }
+    RT_TARGET_AVX2 static Type     Sqrt(const Type a) { return _mm256_sqrt_pd(a); }
+    RT_TARGET_AVX2 static Type     Min(const Type a, const Type b) { return _mm256_min_pd(a, b); }
+    RT_TARGET_AVX2 static Type     Max(const Type a, const Type b) { return _mm256_max_pd(a, b); }
+    RT_TARGET_AVX2 static Type     CopySign(const Type magnitude, const Type sign) { return _mm256_or_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), magnitude), _mm256_and_pd(_mm256_set1_pd(-0.0), sign)); }
+    RT_TARGET_AVX2 static Type     Abs(const Type a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    RT_TARGET_AVX2 static Mask     Less(const Type a, const Type b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    RT_TARGET_AVX2 static Mask     GreaterEqual(const Type a, const Type b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+    RT_TARGET_AVX2 static Mask     And(const Mask a, const Mask b) { return _mm256_and_pd(a, b); }
+    RT_TARGET_AVX2 static Mask     Or(const Mask a, const Mask b) { return _mm256_or_pd(a, b); }
+    RT_TARGET_AVX2 static Mask     AndNot(const Mask a, const Mask b) { return _mm256_andnot_pd(a, b); }
+    RT_TARGET_AVX2 static Type     Select(const Mask m, const Type a, const Type b) { return _mm256_blendv_pd(b, a, m); }
+    RT_TARGET_AVX2 static uint32_t MoveMask(const Mask m) { return static_cast<uint32_t>(_mm256_movemask_pd(m)); }
+};
+    #endif
+#endif
+
+}    // namespace Math::SIMD
@@ -3,7 +3,7 @@
 namespace Math
 {
 
-double SpherePDF::Value(const Vector3& direction) const
+Real SpherePDF::Value(const Vector3& direction) const
 {
     return 1 / (4 * Pi);
 }
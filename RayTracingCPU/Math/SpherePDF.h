@@ -1,17 +1,17 @@
 #pragma once
 
-#include "PDF.h"
+#include "Vector3.h"
 
 namespace Math
 {
 
-class SpherePDF final : public PDF
+class SpherePDF
 {
 public:
     SpherePDF() = default;
 
-    double  Value(const Vector3& direction) const override;
-    Vector3 Generate() const override;
+    Real    Value(const Vector3& direction) const;
+    Vector3 Generate() const;
 };
 
 }    // namespace Math
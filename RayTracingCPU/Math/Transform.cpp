@@ -0,0 +1,196 @@
+#include "Transform.h"
+
+#include "Converters.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Math
+{
+
+namespace Impl
+{
+
+    void SetIdentity(Real m[3][4])
+    {
+        for(int i = 0; i < 3; i++)
+        {
+            for(int j = 0; j < 4; j++)
+            {
+                m[i][j] = i == j ? 1 : 0;
+            }
+        }
+    }
+
+    // Product of two affine matrices, with the implicit fourth row (0, 0, 0, 1).
+    void Multiply(const Real a[3][4], const Real b[3][4], Real result[3][4])
+    {
+        for(int i = 0; i < 3; i++)
+        {
+            for(int j = 0; j < 4; j++)
+            {
+                result[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+            }
+            result[i][3] += a[i][3];
+        }
+    }
+
+}    // namespace Impl
+
+Transform::Transform()
+{
+    Impl::SetIdentity(m_Matrix);
+    Impl::SetIdentity(m_Inverse);
+}
+
+Transform Transform::Translate(const Vector3& offset)
+{
+    Transform t;
+    for(int i = 0; i < 3; i++)
+    {
+        t.m_Matrix[i][3]  = offset[i];
+        t.m_Inverse[i][3] = -offset[i];
+    }
+    return t;
+}
+
+Transform Transform::Scale(const Real factor)
+{
+    return Scale(Vector3(factor, factor, factor));
+}
+
+Transform Transform::Scale(const Vector3& factors)
+{
+    Transform t;
+    for(int i = 0; i < 3; i++)
+    {
+        t.m_Matrix[i][i]  = factors[i];
+        t.m_Inverse[i][i] = 1 / factors[i];
+    }
+    return t;
+}
+
+// Rodrigues' rotation formula, the inverse of a rotation is its transpose.
+Transform Transform::Rotate(const Real degrees, const Vector3& axis)
+{
+    const Vector3 a        = UnitVector(axis);
+    const auto    radians  = static_cast<Real>(DegreesToRadians(degrees));
+    const Real    sinTheta = std::sin(radians);
+    const Real    cosTheta = std::cos(radians);
+
+    Transform t;
+    t.m_Matrix[0][0] = a.X() * a.X() + (1 - a.X() * a.X()) * cosTheta;
+    t.m_Matrix[0][1] = a.X() * a.Y() * (1 - cosTheta) - a.Z() * sinTheta;
+    t.m_Matrix[0][2] = a.X() * a.Z() * (1 - cosTheta) + a.Y() * sinTheta;
+    t.m_Matrix[1][0] = a.X() * a.Y() * (1 - cosTheta) + a.Z() * sinTheta;
+    t.m_Matrix[1][1] = a.Y() * a.Y() + (1 - a.Y() * a.Y()) * cosTheta;
+    t.m_Matrix[1][2] = a.Y() * a.Z() * (1 - cosTheta) - a.X() * sinTheta;
+    t.m_Matrix[2][0] = a.X() * a.Z() * (1 - cosTheta) - a.Y() * sinTheta;
+    t.m_Matrix[2][1] = a.Y() * a.Z() * (1 - cosTheta) + a.X() * sinTheta;
+    t.m_Matrix[2][2] = a.Z() * a.Z() + (1 - a.Z() * a.Z()) * cosTheta;
+
+    for(int i = 0; i < 3; i++)
+    {
+        for(int j = 0; j < 3; j++)
+        {
+            t.m_Inverse[i][j] = t.m_Matrix[j][i];
+        }
+    }
+    return t;
+}
+
+Transform Transform::operator*(const Transform& other) const
+{
+    Transform t;
+    Impl::Multiply(m_Matrix, other.m_Matrix, t.m_Matrix);
+    Impl::Multiply(other.m_Inverse, m_Inverse, t.m_Inverse);
+    return t;
+}
+
+Transform Transform::Inverse() const
+{
+    Transform t;
+    std::copy_n(&m_Inverse[0][0], 12, &t.m_Matrix[0][0]);
+    std::copy_n(&m_Matrix[0][0], 12, &t.m_Inverse[0][0]);
+    return t;
+}
+
+Point3 Transform::ApplyPoint(const Point3& p) const
+{
+    const auto& m = m_Matrix;
+    return {m[0][0] * p.X() + m[0][1] * p.Y() + m[0][2] * p.Z() + m[0][3],
+            m[1][0] * p.X() + m[1][1] * p.Y() + m[1][2] * p.Z() + m[1][3],
+            m[2][0] * p.X() + m[2][1] * p.Y() + m[2][2] * p.Z() + m[2][3]};
+}
+
+// The error of the result consists of the rounding of the product and the error of p scaled by the matrix, bounded
+// per row as in pbrt section 6.8.6.
+Point3 Transform::ApplyPoint(const Point3& p, Real& pError) const
+{
+    const auto& m           = m_Matrix;
+    Real        roundingMax = 0;
+    Real        scaleMax    = 0;
+    for(int i = 0; i < 3; i++)
+    {
+        const Real rounding = std::fabs(m[i][0] * p.X()) + std::fabs(m[i][1] * p.Y()) + std::fabs(m[i][2] * p.Z()) + std::fabs(m[i][3]);
+        const Real scale    = std::fabs(m[i][0]) + std::fabs(m[i][1]) + std::fabs(m[i][2]);
+        roundingMax         = std::max(roundingMax, rounding);
+        scaleMax            = std::max(scaleMax, scale);
+    }
+
+    pError = (Gamma(3) + 1) * scaleMax * pError + Gamma(3) * roundingMax;
+    return ApplyPoint(p);
+}
+
+Vector3 Transform::ApplyVector(const Vector3& v) const
+{
+    const auto& m = m_Matrix;
+    return {m[0][0] * v.X() + m[0][1] * v.Y() + m[0][2] * v.Z(),
+            m[1][0] * v.X() + m[1][1] * v.Y() + m[1][2] * v.Z(),
+            m[2][0] * v.X() + m[2][1] * v.Y() + m[2][2] * v.Z()};
+}
+
+Vector3 Transform::ApplyNormal(const Vector3& n) const
+{
+    const auto& m = m_Inverse;
+    return {m[0][0] * n.X() + m[1][0] * n.Y() + m[2][0] * n.Z(),
+            m[0][1] * n.X() + m[1][1] * n.Y() + m[2][1] * n.Z(),
+            m[0][2] * n.X() + m[1][2] * n.Y() + m[2][2] * n.Z()};
+}
+
+AABB Transform::ApplyBox(const AABB& box) const
+{
+    Point3 min(Infinity, Infinity, Infinity);
+    Point3 max(-Infinity, -Infinity, -Infinity);
+
+    for(int corner = 0; corner < 8; corner++)
+    {
+        const Point3 p(corner & 1 ? box.X.Max : box.X.Min,
+                       corner & 2 ? box.Y.Max : box.Y.Min,
+                       corner & 4 ? box.Z.Max : box.Z.Min);
+        const Point3 q = ApplyPoint(p);
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            min[axis] = std::min(min[axis], q[axis]);
+            max[axis] = std::max(max[axis], q[axis]);
+        }
+    }
+
+    return {min, max};
+}
+
+Real Transform::Determinant() const
+{
+    const auto& m = m_Matrix;
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+         - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+         + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+bool Transform::SwapsHandedness() const
+{
+    return Determinant() < 0;
+}
+
+}    // namespace Math
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "AABB.h"
+#include "Vector3.h"
+
+namespace Math
+{
+
+// Affine transform of points, vectors and normals. Only the top three rows of the 4x4 matrix are stored, next to those
+// of the inverse, which the factories build exactly instead of inverting the matrix numerically.
+class Transform
+{
+public:
+    // Identity
+    Transform();
+
+    static Transform Translate(const Vector3& offset);
+    static Transform Scale(Real factor);
+    static Transform Scale(const Vector3& factors);
+
+    // Counterclockwise rotation around the axis through the origin, looking against the axis direction.
+    static Transform Rotate(Real degrees, const Vector3& axis);
+
+    // Applies other first and then this transform, like the product of the matrices.
+    Transform operator*(const Transform& other) const;
+    Transform Inverse() const;
+
+    Point3  ApplyPoint(const Point3& p) const;
+    Vector3 ApplyVector(const Vector3& v) const;
+    Vector3 ApplyNormal(const Vector3& n) const;    // Multiplies by the inverse transpose, the result is not normalized
+    AABB    ApplyBox(const AABB& box) const;        // Bounds of the eight transformed corners
+
+    // Transforms p and widens pError, the bound on the error of each coordinate, by the rounding of the product.
+    Point3 ApplyPoint(const Point3& p, Real& pError) const;
+
+    // Of the linear part, the factor by which the transform scales volumes, negative for mirroring transforms.
+    Real Determinant() const;
+
+    // Mirroring transforms turn counterclockwise triangles into clockwise ones.
+    bool SwapsHandedness() const;
+
+private:
+    Real m_Matrix[3][4];
+    Real m_Inverse[3][4];
+};
+
+}    // namespace Math
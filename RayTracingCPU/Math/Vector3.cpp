@@ -3,17 +3,17 @@
 namespace Math
 {
 
-double Vector3::X() const
+Real Vector3::X() const
 {
     return E[0];
 }
 
-double Vector3::Y() const
+Real Vector3::Y() const
 {
     return E[1];
 }
 
-double Vector3::Z() const
+Real Vector3::Z() const
 {
     return E[2];
 }
@@ -37,12 +37,12 @@ Vector3 Vector3::operator-() const
     return {-E[0], -E[1], -E[2]};
 }
 
-double Vector3::operator[](const int i) const
+Real Vector3::operator[](const int i) const
 {
     return E[i];
 }
 
-double& Vector3::operator[](const int i)
+Real& Vector3::operator[](const int i)
 {
     return E[i];
 }
@@ -55,7 +55,7 @@ Vector3& Vector3::operator+=(const Vector3& v)
     return *this;
 }
 
-Vector3& Vector3::operator*=(const double t)
+Vector3& Vector3::operator*=(const Real t)
 {
     E[0] *= t;
     E[1] *= t;
@@ -63,17 +63,17 @@ Vector3& Vector3::operator*=(const double t)
     return *this;
 }
 
-Vector3& Vector3::operator/=(const double t)
+Vector3& Vector3::operator/=(const Real t)
 {
     return *this *= 1 / t;
 }
 
-double Vector3::Length() const
+Real Vector3::Length() const
 {
     return sqrt(LengthSquared());
 }
 
-double Vector3::LengthSquared() const
+Real Vector3::LengthSquared() const
 {
     return E[0] * E[0] + E[1] * E[1] + E[2] * E[2];
 }
@@ -87,12 +87,18 @@ bool Vector3::NearZero() const
 
 Vector3 Vector3::Random()
 {
-    return {Utils::Random::Double(), Utils::Random::Double(), Utils::Random::Double()};
+    const Real x = Utils::Random::Double();
+    const Real y = Utils::Random::Double();
+    const Real z = Utils::Random::Double();
+    return {x, y, z};
 }
 
-Vector3 Vector3::Random(const double min, const double max)
+Vector3 Vector3::Random(const Real min, const Real max)
 {
-    return {Utils::Random::Double(min, max), Utils::Random::Double(min, max), Utils::Random::Double(min, max)};
+    const Real x = Utils::Random::Double(min, max);
+    const Real y = Utils::Random::Double(min, max);
+    const Real z = Utils::Random::Double(min, max);
+    return {x, y, z};
 }
 
 }    // namespace Math
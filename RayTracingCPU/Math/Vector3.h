@@ -4,6 +4,7 @@
 
 #include <Utils/Random.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -13,39 +14,39 @@ namespace Math
 class Vector3
 {
 public:
-    double E[3];
+    Real E[3];
 
     Vector3()
         : E{0, 0, 0}
     {
     }
 
-    Vector3(const double e0, const double e1, const double e2)
+    Vector3(const Real e0, const Real e1, const Real e2)
         : E{e0, e1, e2}
     {
     }
 
-    double X() const;
-    double Y() const;
-    double Z() const;
+    Real X() const;
+    Real Y() const;
+    Real Z() const;
 
     Vector3  operator-(const Vector3& other) const;
     void     operator-=(const Vector3& other);
     Vector3  operator-() const;
-    double   operator[](int i) const;
-    double&  operator[](int i);
+    Real     operator[](int i) const;
+    Real&    operator[](int i);
     Vector3& operator+=(const Vector3& v);
-    Vector3& operator*=(double t);
-    Vector3& operator/=(double t);
+    Vector3& operator*=(Real t);
+    Vector3& operator/=(Real t);
 
-    double Length() const;
-    double LengthSquared() const;
+    Real Length() const;
+    Real LengthSquared() const;
 
     // Return true if the vector is close to zero in all dimensions.
     bool NearZero() const;
 
     static Vector3 Random();
-    static Vector3 Random(double min, double max);
+    static Vector3 Random(Real min, Real max);
 };
 
 using Point3 = Vector3;
@@ -76,24 +77,24 @@ inline Vector3 operator*(const Vector3& u, const Vector3& v)
             u.E[2] * v.E[2]};
 }
 
-inline Vector3 operator*(const double t, const Vector3& v)
+inline Vector3 operator*(const Real t, const Vector3& v)
 {
     return {t * v.E[0],
             t * v.E[1],
             t * v.E[2]};
 }
 
-inline Vector3 operator*(const Vector3& v, const double t)
+inline Vector3 operator*(const Vector3& v, const Real t)
 {
     return t * v;
 }
 
-inline Vector3 operator/(const Vector3& v, const double t)
+inline Vector3 operator/(const Vector3& v, const Real t)
 {
     return (1 / t) * v;
 }
 
-inline double DotProduct(const Vector3& u, const Vector3& v)
+inline Real DotProduct(const Vector3& u, const Vector3& v)
 {
     return u.E[0] * v.E[0] + u.E[1] * v.E[1] + u.E[2] * v.E[2];
 }
@@ -105,6 +106,11 @@ inline Vector3 CrossProduct(const Vector3& u, const Vector3& v)
             u.E[0] * v.E[1] - u.E[1] * v.E[0]};
 }
 
+inline Real MaxAbsComponent(const Vector3& v)
+{
+    return std::max({std::fabs(v.E[0]), std::fabs(v.E[1]), std::fabs(v.E[2])});
+}
+
 inline Vector3 UnitVector(const Vector3& v)
 {
     return v / v.Length();
@@ -157,7 +163,7 @@ inline Vector3 Reflect(const Vector3& v, const Vector3& n)
     return v - 2 * DotProduct(v, n) * n;
 }
 
-inline Vector3 Refract(const Vector3& uv, const Vector3& n, const double etaIOverEtaT)
+inline Vector3 Refract(const Vector3& uv, const Vector3& n, const Real etaIOverEtaT)
 {
     const auto    cosTheta     = fmin(DotProduct(-uv, n), 1.0);
     const Vector3 rOutPerp     = etaIOverEtaT * (uv + cosTheta * n);
@@ -165,15 +171,36 @@ inline Vector3 Refract(const Vector3& uv, const Vector3& n, const double etaIOve
     return rOutPerp + rOutParallel;
 }
 
+// Moves a surface point p, whose coordinates are off by at most pError each, along the normal n to the side of the
+// direction w, far enough that rays leaving from it cannot hit the same surface again (pbrt section 6.8.6).
+inline Point3 OffsetRayOrigin(const Point3& p, const Real pError, const Vector3& n, const Vector3& w)
+{
+    const Real distance = pError * (std::fabs(n.E[0]) + std::fabs(n.E[1]) + std::fabs(n.E[2]));
+    Vector3    offset   = distance * n;
+    if(DotProduct(w, n) < 0)
+        offset = -offset;
+
+    // Round away from p, so the offset survives the addition.
+    Point3 origin = p + offset;
+    for(int i = 0; i < 3; i++)
+    {
+        if(offset.E[i] > 0)
+            origin.E[i] = NextRealUp(origin.E[i]);
+        else if(offset.E[i] < 0)
+            origin.E[i] = NextRealDown(origin.E[i]);
+    }
+    return origin;
+}
+
 inline Vector3 RandomCosineDirection()
 {
-    const auto r1 = Utils::Random::Double();
-    const auto r2 = Utils::Random::Double();
+    const Real r1 = Utils::Random::Double();
+    const Real r2 = Utils::Random::Double();
 
-    const auto phi = 2 * Pi * r1;
-    const auto x   = cos(phi) * sqrt(r2);
-    const auto y   = sin(phi) * sqrt(r2);
-    const auto z   = sqrt(1 - r2);
+    const Real phi = 2 * Pi * r1;
+    const Real x   = std::cos(phi) * std::sqrt(r2);
+    const Real y   = std::sin(phi) * std::sqrt(r2);
+    const Real z   = std::sqrt(1 - r2);
 
     return {x, y, z};
 }
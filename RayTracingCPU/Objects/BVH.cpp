@@ -3,111 +3,117 @@
 
 #include <Render/HitRecord.h>
 
-#include <algorithm>
-#include <execution>
-
 namespace Objects
 {
 
-BVHNode::BVHNode(const std::vector<std::shared_ptr<Hittable>>& srcObjects)
+BVHNode::BVHNode(const std::vector<std::shared_ptr<Hittable>>& srcObjects, const BVHBuildOptions& options)
 {
     m_BoundingBox = Math::AABB::Empty;
+    if(srcObjects.empty())
+        return;
 
-    for(const auto& object : srcObjects)
+    std::vector<Math::AABB> objectBounds(srcObjects.size());
+    for(size_t i = 0; i < srcObjects.size(); i++)
     {
-        m_BoundingBox = Math::AABB(m_BoundingBox, object->BoundingBox());
+        objectBounds[i] = srcObjects[i]->BoundingBox();
     }
 
-    // const int  axis       = Random::Int(0, 2);
-    const int  axis       = m_BoundingBox.LongestAxis();
-    const auto comparator = (axis == 0) ? BoxXCompare : ((axis == 1) ? BoxYCompare : BoxZCompare);
+    // Leaves hold more than one object only if their centroids coincide.
+    BVHBuildOptions nodeOptions     = options;
+    nodeOptions.MaxPrimitivesInLeaf = 1;
 
-    // Create a modifiable array of the source scene objects
-    auto         objects = srcObjects;
-    const size_t size    = srcObjects.size();
+    BVHBuilder builder(nodeOptions);
+    builder.Build(objectBounds);
+    if(builder.Nodes().empty())
+        return;
 
-    if(size == 1)
-    {
-        m_Left = m_Right = objects[0];
-    }
-    else if(size == 2)
-    {
-        // Technically, we can arbitrarily divide the objects into two groups, and everything will still work.
-        // However, an arbitrary partition will yield bounding volumes that will likely overlap quite a bit.
-        //
-        // With many objects, ordering them in one dimension will yield a tighter cluster, and thus smaller and
-        // minimally overlapping boxes for the two groups. With only two objects, though, dividing is trivial,
-        // and the two boxes will be as small as can be. Order doesn't matter, and the code should be simplified
-        // by keeping only the first branch to if-statement.
-        //
-        // I prefer to keep the code as it is because it's more universal and the performance gain is negligible.
-        if(comparator(objects[0], objects[1]))
-        {
-            m_Left  = objects[0];
-            m_Right = objects[1];
-        }
-        else
-        {
-            m_Left  = objects[1];
-            m_Right = objects[0];
-        }
-    }
-    else
+    // The tree keeps the nodes of the builder, and leaves reference contiguous ranges of the reordered objects.
+    m_Nodes = builder.Nodes();
+    m_Objects.reserve(builder.PrimitiveIndices().size());
+    for(const auto index : builder.PrimitiveIndices())
     {
-        const auto mid = size / 2;
-
-        // The fastest way to create BVH Trees: https://github.com/RayTracing/raytracing.github.io/issues/1388
-        std::nth_element(std::execution::par, objects.begin(), objects.begin() + static_cast<long long>(mid), objects.end(), comparator);
-
-        auto objectsLeft  = std::vector(objects.begin(), objects.begin() + static_cast<long long>(mid));
-        auto objectsRight = std::vector(objects.begin() + static_cast<long long>(mid), objects.end());
-
-        m_Left  = make_shared<BVHNode>(objectsLeft);
-        m_Right = make_shared<BVHNode>(objectsRight);
+        m_Objects.emplace_back(srcObjects[index]);
     }
+    m_BoundingBox = m_Nodes[0].Bounds;
 
-    // m_BoundingBox = AABB(m_Left->BoundingBox(), m_Right->BoundingBox());
+    builder.Stats().Log(options.SplitMethod == BVHSplitMethod::SAH ? "BVHNode (SAH)" : "BVHNode (Median)");
 }
 
 bool BVHNode::Hit(const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord& rec) const
 {
-    if(!m_BoundingBox.Hit(ray, rayT))
+    return !m_Nodes.empty() && HitNode(0, ray, rayT, rec);
+}
+
+bool BVHNode::HitNode(const uint32_t nodeIndex, const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord& rec) const
+{
+    const BVHBuildNode& node = m_Nodes[nodeIndex];
+    if(!node.Bounds.Hit(ray, rayT))
         return false;
 
-    const bool hitLeft  = m_Left->Hit(ray, rayT, rec);
-    const bool hitRight = m_Right->Hit(ray, Math::Interval(rayT.Min, hitLeft ? rec.T : rayT.Max), rec);
+    if(node.IsLeaf())
+    {
+        bool       hitAnything  = false;
+        Math::Real closestSoFar = rayT.Max;
+        for(uint32_t i = 0; i < node.PrimitiveCount; i++)
+        {
+            if(m_Objects[node.Offset + i]->Hit(ray, Math::Interval(rayT.Min, closestSoFar), rec))
+            {
+                hitAnything  = true;
+                closestSoFar = rec.T;
+            }
+        }
+        return hitAnything;
+    }
+
+    const bool hitLeft  = HitNode(node.Offset, ray, rayT, rec);
+    const bool hitRight = HitNode(node.Offset + 1, ray, Math::Interval(rayT.Min, hitLeft ? rec.T : rayT.Max), rec);
 
     return hitLeft || hitRight;
 }
 
-Math::AABB BVHNode::BoundingBox() const
+bool BVHNode::Occluded(const Render::Ray& ray, const Math::Interval rayT) const
 {
-    return m_BoundingBox;
+    return !m_Nodes.empty() && OccludedNode(0, ray, rayT);
 }
 
-bool BVHNode::BoxCompare(const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b, const int axisIndex)
+bool BVHNode::OccludedNode(const uint32_t nodeIndex, const Render::Ray& ray, const Math::Interval rayT) const
 {
-    return a->BoundingBox().AxisInterval(axisIndex).Min < b->BoundingBox().AxisInterval(axisIndex).Min;
+    const BVHBuildNode& node = m_Nodes[nodeIndex];
+    if(!node.Bounds.Hit(ray, rayT))
+        return false;
 
-    // New approach: https://github.com/RayTracing/raytracing.github.io/pull/1422
-    // const auto aAxisInterval = a->BoundingBox().AxisInterval(axisIndex);
-    // const auto bAxisInterval = b->BoundingBox().AxisInterval(axisIndex);
-    // return aAxisInterval.Min < bAxisInterval.Min;
+    if(node.IsLeaf())
+    {
+        for(uint32_t i = 0; i < node.PrimitiveCount; i++)
+        {
+            if(m_Objects[node.Offset + i]->Occluded(ray, rayT))
+                return true;
+        }
+        return false;
+    }
+
+    return OccludedNode(node.Offset, ray, rayT) || OccludedNode(node.Offset + 1, ray, rayT);
 }
 
-bool BVHNode::BoxXCompare(const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b)
+Math::AABB BVHNode::BoundingBox() const
 {
-    return BoxCompare(a, b, 0);
+    return m_BoundingBox;
 }
 
-bool BVHNode::BoxYCompare(const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b)
+void BVHNode::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
 {
-    return BoxCompare(a, b, 1);
+    for(const auto& object : m_Objects)
+    {
+        object->AssignIds(materials, nextPrimitiveId);
+    }
 }
 
-bool BVHNode::BoxZCompare(const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b)
+void BVHNode::CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const
 {
-    return BoxCompare(a, b, 2);
+    for(const auto& object : m_Objects)
+    {
+        object->CollectEmitters(emitters, powers, material);
+    }
 }
 
 }    // namespace Objects
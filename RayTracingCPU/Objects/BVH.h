@@ -1,32 +1,41 @@
 #pragma once
 
+#include "BVHBuild.h"
 #include "Hittable.h"
 #include "HittableList.h"
 
 namespace Objects
 {
 
+// Binary BVH traversed recursively, kept for scenes that group objects by hand. The nodes are the ones of the
+// builder, stored in a single array, and the objects are ordered as the leaves reference them.
 class BVHNode final : public Hittable
 {
 public:
-    explicit BVHNode(const HittableList& list)
-        : BVHNode(list.Objects)
+    explicit BVHNode(const HittableList& list, const BVHBuildOptions& options = {})
+        : BVHNode(list.Objects, options)
     {
     }
 
-    BVHNode(const std::vector<std::shared_ptr<Hittable>>& srcObjects);
+    // Builds the tree and reports its build time and quality through the log.
+    BVHNode(const std::vector<std::shared_ptr<Hittable>>& srcObjects, const BVHBuildOptions& options = {});
+
     bool       Hit(const Render::Ray& ray, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool       Occluded(const Render::Ray& ray, Math::Interval rayT) const override;
     Math::AABB BoundingBox() const override;
+    void       AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
+    void       CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const override;
+
+    // Objects in the tree, without those the builder left out for their empty bounds.
+    const std::vector<std::shared_ptr<Hittable>>& Objects() const { return m_Objects; }
 
 private:
-    std::shared_ptr<Hittable> m_Left;
-    std::shared_ptr<Hittable> m_Right;
-    Math::AABB                m_BoundingBox;
-
-    static bool BoxCompare(const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b, int axisIndex);
-    static bool BoxXCompare(const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b);
-    static bool BoxYCompare(const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b);
-    static bool BoxZCompare(const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b);
+    std::vector<BVHBuildNode>              m_Nodes;
+    std::vector<std::shared_ptr<Hittable>> m_Objects;
+    Math::AABB                             m_BoundingBox;
+
+    bool HitNode(uint32_t nodeIndex, const Render::Ray& ray, Math::Interval rayT, Render::HitRecord& rec) const;
+    bool OccludedNode(uint32_t nodeIndex, const Render::Ray& ray, Math::Interval rayT) const;
 };
 
 }    // namespace Math
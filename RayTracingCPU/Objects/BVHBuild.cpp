@@ -0,0 +1,265 @@
+#include "BVHBuild.h"
+
+#include "Hittable.h"
+
+#include <Utils/Log.h>
+#include <Utils/Timers.h>
+
+#include <bit>
+#include <future>
+#include <thread>
+
+namespace Objects
+{
+
+void BVHBuildStats::Log(const std::string_view name) const
+{
+    LOG_INFO("{}: {} primitives, {} nodes, {} leaves, max depth {}, SAH cost {:.3f}, built in {:.3f} ms",
+             name, PrimitiveCount, NodeCount, LeafCount, MaxDepth, SAHCost, BuildTimeMs);
+}
+
+double SurfaceArea(const Math::AABB& box)
+{
+    if(box.X.IsEmpty() || box.Y.IsEmpty() || box.Z.IsEmpty())
+        return 0.0;
+
+    const double dx = box.X.Size();
+    const double dy = box.Y.Size();
+    const double dz = box.Z.Size();
+    return 2.0 * (dx * dy + dy * dz + dz * dx);
+}
+
+bool IsFiniteBox(const Math::AABB& box)
+{
+    for(int axis = 0; axis < 3; axis++)
+    {
+        const Math::Interval& interval = Impl::AxisInterval(box, axis);
+        if(!std::isfinite(interval.Min) || !std::isfinite(interval.Max) || interval.Min > interval.Max)
+            return false;
+    }
+    return true;
+}
+
+BVHBuilder::BVHBuilder(const BVHBuildOptions& options)
+    : m_Options(options)
+{
+    m_Options.MaxPrimitivesInLeaf = std::clamp(m_Options.MaxPrimitivesInLeaf, 1, static_cast<int>(MaxLeafSize));
+    m_Options.ParallelThreshold   = std::max(m_Options.ParallelThreshold, 2);
+
+    // Spawn a few tasks per hardware thread, so that unbalanced splits still keep all cores busy.
+    const unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    m_MaxTaskDepth             = std::bit_width(threadCount) + 2;
+}
+
+void BVHBuilder::Build(const std::vector<Math::AABB>& primitiveBounds)
+{
+    const Utils::Timer timer;
+
+    m_Stats = {};
+    m_Nodes.clear();
+    m_PrimitiveIndices.clear();
+    m_BuildPrimitives.clear();
+    m_BuildPrimitives.reserve(primitiveBounds.size());
+
+    // Primitives with empty or non-finite bounds cannot be hit, and their centroids would not fall into any bin.
+    for(size_t i = 0; i < primitiveBounds.size(); i++)
+    {
+        if(!IsFiniteBox(primitiveBounds[i]))
+            continue;
+
+        m_BuildPrimitives.push_back({primitiveBounds[i], Centroid(primitiveBounds[i]), static_cast<uint32_t>(i)});
+    }
+
+    if(m_BuildPrimitives.size() < primitiveBounds.size())
+    {
+        LOG_WARN("BVH builder: skipped {} primitives with empty or non-finite bounds", primitiveBounds.size() - m_BuildPrimitives.size());
+    }
+
+    if(m_BuildPrimitives.empty())
+        return;
+
+    // A binary tree with at least one primitive per leaf never has more than 2N - 1 nodes.
+    m_Nodes.resize(2 * m_BuildPrimitives.size() - 1);
+    m_NodeCount = 1;
+
+    BuildRecursive(0, 0, m_BuildPrimitives.size(), 1);
+
+    m_Nodes.resize(m_NodeCount);
+    m_PrimitiveIndices.resize(m_BuildPrimitives.size());
+    for(size_t i = 0; i < m_BuildPrimitives.size(); i++)
+    {
+        m_PrimitiveIndices[i] = m_BuildPrimitives[i].Index;
+    }
+    m_BuildPrimitives.clear();
+    m_BuildPrimitives.shrink_to_fit();
+
+    m_Stats.PrimitiveCount = m_PrimitiveIndices.size();
+    m_Stats.NodeCount      = m_Nodes.size();
+    AccumulateStats(0, SurfaceArea(m_Nodes[0].Bounds), 1);
+    m_Stats.BuildTimeMs = timer.ElapsedMilliseconds();
+}
+
+void BVHBuilder::BuildRecursive(const uint32_t nodeIndex, const size_t start, const size_t end, const int depth)
+{
+    // Centroid bounds are tracked without AABB padding, so coincident centroids can be detected.
+    Impl::BinBounds bounds;
+    Impl::BinBounds centroidBounds;
+    for(size_t i = start; i < end; i++)
+    {
+        const auto& primitive = m_BuildPrimitives[i];
+        for(int c = 0; c < 3; c++)
+        {
+            const Math::Interval& interval = Impl::AxisInterval(primitive.Bounds, c);
+
+            bounds.Min[c]         = std::min(bounds.Min[c], interval.Min);
+            bounds.Max[c]         = std::max(bounds.Max[c], interval.Max);
+            centroidBounds.Min[c] = std::min(centroidBounds.Min[c], primitive.Centroid[c]);
+            centroidBounds.Max[c] = std::max(centroidBounds.Max[c], primitive.Centroid[c]);
+        }
+    }
+    m_Nodes[nodeIndex].Bounds.X = Math::Interval(bounds.Min[0], bounds.Max[0]);
+    m_Nodes[nodeIndex].Bounds.Y = Math::Interval(bounds.Min[1], bounds.Max[1]);
+    m_Nodes[nodeIndex].Bounds.Z = Math::Interval(bounds.Min[2], bounds.Max[2]);
+
+    const Math::Vector3 centroidExtent(centroidBounds.Max[0] - centroidBounds.Min[0], centroidBounds.Max[1] - centroidBounds.Min[1], centroidBounds.Max[2] - centroidBounds.Min[2]);
+
+    int axis = 0;
+    if(centroidExtent.Y() > centroidExtent[axis])
+        axis = 1;
+    if(centroidExtent.Z() > centroidExtent[axis])
+        axis = 2;
+
+    const size_t count = end - start;
+    const auto   first = m_BuildPrimitives.begin() + static_cast<long long>(start);
+    const auto   last  = m_BuildPrimitives.begin() + static_cast<long long>(end);
+
+    // Small ranges may stay a leaf when the SAH finds no cheaper split, larger ones are always split.
+    const bool canBeLeaf = count <= static_cast<size_t>(m_Options.MaxPrimitivesInLeaf);
+
+    auto split = last;
+    if(m_Options.SplitMethod == BVHSplitMethod::SAH && depth <= m_Options.MaxSAHDepth)
+    {
+        split = PartitionSAH(first, last, [](const BuildPrimitive& primitive) { return primitive.Bounds; }, m_Options, canBeLeaf);
+    }
+
+    // Make a leaf when no split was chosen and either few primitives are left, or all centroids coincide.
+    if(split == last && (canBeLeaf || (centroidExtent[axis] <= 0.0 && count <= MaxLeafSize)))
+    {
+        m_Nodes[nodeIndex].Offset         = static_cast<uint32_t>(start);
+        m_Nodes[nodeIndex].PrimitiveCount = static_cast<uint32_t>(count);
+        return;
+    }
+
+    if(split == last)
+    {
+        // Median split on the longest axis of the centroid bounds.
+        split = first + static_cast<long long>(count / 2);
+        std::nth_element(first, split, last, [axis](const BuildPrimitive& a, const BuildPrimitive& b) { return a.Centroid[axis] < b.Centroid[axis]; });
+    }
+
+    const auto mid        = static_cast<size_t>(split - m_BuildPrimitives.begin());
+    const auto firstChild = m_NodeCount.fetch_add(2, std::memory_order_relaxed);
+
+    m_Nodes[nodeIndex].Offset         = firstChild;
+    m_Nodes[nodeIndex].PrimitiveCount = 0;
+
+    // Both halves work on disjoint primitive ranges and nodes, so they can be built concurrently.
+    if(count >= static_cast<size_t>(m_Options.ParallelThreshold) && depth <= m_MaxTaskDepth)
+    {
+        auto task = std::async(std::launch::async, [this, firstChild, start, mid, depth] { BuildRecursive(firstChild, start, mid, depth + 1); });
+        BuildRecursive(firstChild + 1, mid, end, depth + 1);
+        task.get();
+    }
+    else
+    {
+        BuildRecursive(firstChild, start, mid, depth + 1);
+        BuildRecursive(firstChild + 1, mid, end, depth + 1);
+    }
+}
+
+void BVHBuilder::AccumulateStats(const uint32_t nodeIndex, const double rootArea, const int depth)
+{
+    const auto&  node    = m_Nodes[nodeIndex];
+    const double relArea = rootArea > 0.0 ? SurfaceArea(node.Bounds) / rootArea : 1.0;
+
+    m_Stats.MaxDepth = std::max(m_Stats.MaxDepth, depth);
+
+    if(node.IsLeaf())
+    {
+        m_Stats.LeafCount++;
+        m_Stats.SAHCost += m_Options.LeafCost * relArea * static_cast<double>(node.PrimitiveCount);
+        return;
+    }
+
+    m_Stats.SAHCost += m_Options.TraversalCost * relArea;
+    AccumulateStats(node.Offset, rootArea, depth + 1);
+    AccumulateStats(node.Offset + 1, rootArea, depth + 1);
+}
+
+bool MotionBuildBounds::Collect(const std::vector<std::shared_ptr<Hittable>>& primitives, std::vector<Math::AABB>& buildBounds)
+{
+    PrimitiveStart.resize(primitives.size());
+    PrimitiveEnd.resize(primitives.size());
+    buildBounds.resize(primitives.size());
+
+    bool moving = false;
+    for(size_t i = 0; i < primitives.size(); i++)
+    {
+        if(primitives[i]->MotionBounds(PrimitiveStart[i], PrimitiveEnd[i]))
+        {
+            moving = true;
+        }
+        else
+        {
+            PrimitiveStart[i] = primitives[i]->BoundingBox();
+            PrimitiveEnd[i]   = PrimitiveStart[i];
+        }
+        buildBounds[i] = primitives[i]->BoundingBox();
+    }
+
+    if(!moving)
+    {
+        PrimitiveStart.clear();
+        PrimitiveEnd.clear();
+        return false;
+    }
+
+    for(size_t i = 0; i < primitives.size(); i++)
+    {
+        const Math::AABB& start = PrimitiveStart[i];
+        const Math::AABB& end   = PrimitiveEnd[i];
+        buildBounds[i].X        = Math::Interval((start.X.Min + end.X.Min) / 2, (start.X.Max + end.X.Max) / 2);
+        buildBounds[i].Y        = Math::Interval((start.Y.Min + end.Y.Min) / 2, (start.Y.Max + end.Y.Max) / 2);
+        buildBounds[i].Z        = Math::Interval((start.Z.Min + end.Z.Min) / 2, (start.Z.Max + end.Z.Max) / 2);
+    }
+    return true;
+}
+
+void MotionBuildBounds::Compute(const BVHBuilder& builder)
+{
+    const auto& nodes   = builder.Nodes();
+    const auto& indices = builder.PrimitiveIndices();
+
+    NodeStart.assign(nodes.size(), Math::AABB::Empty);
+    NodeEnd.assign(nodes.size(), Math::AABB::Empty);
+
+    for(size_t i = nodes.size(); i-- > 0;)
+    {
+        const auto& node = nodes[i];
+        if(node.IsLeaf())
+        {
+            for(uint32_t j = 0; j < node.PrimitiveCount; j++)
+            {
+                NodeStart[i] = Math::AABB(NodeStart[i], PrimitiveStart[indices[node.Offset + j]]);
+                NodeEnd[i]   = Math::AABB(NodeEnd[i], PrimitiveEnd[indices[node.Offset + j]]);
+            }
+        }
+        else
+        {
+            NodeStart[i] = Math::AABB(NodeStart[node.Offset], NodeStart[node.Offset + 1]);
+            NodeEnd[i]   = Math::AABB(NodeEnd[node.Offset], NodeEnd[node.Offset + 1]);
+        }
+    }
+}
+
+}    // namespace Objects
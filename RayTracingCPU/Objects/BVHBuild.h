@@ -0,0 +1,331 @@
+#pragma once
+
+#include <Math/AABB.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace Objects
+{
+
+class Hittable;
+
+enum class BVHSplitMethod : int
+{
+    Median = 0,    // Median split on the longest axis
+    SAH    = 1     // Binned Surface Area Heuristic
+};
+
+// Node layout the scene objects are compiled into.
+enum class BVHLayout : int
+{
+    Binary = 0,    // LinearBVH
+    BVH4   = 1,    // WideBVH<4>
+    BVH8   = 2     // WideBVH<8>
+};
+
+struct BVHBuildOptions
+{
+    static constexpr int MaxBinCount = 64;
+
+    BVHLayout      Layout              = BVHLayout::BVH8;
+    BVHSplitMethod SplitMethod         = BVHSplitMethod::SAH;
+    int            BinCount            = 16;     // Number of SAH bins per axis, [2, MaxBinCount]
+    double         TraversalCost       = 1.0;    // Relative cost of visiting an interior node
+    double         LeafCost            = 1.0;    // Relative cost of intersecting one primitive in a leaf
+    int            MaxPrimitivesInLeaf = 4;      // Only used by BVHs with multi-primitive leaves
+    int            MaxSAHDepth         = 32;     // Deeper nodes fall back to the median split to bound the tree depth
+    int            ParallelThreshold   = 4096;   // Subtrees with at least this many primitives are built as separate tasks
+};
+
+// Tree-quality numbers, so different builders can be compared on the same scene.
+struct BVHBuildStats
+{
+    size_t PrimitiveCount = 0;
+    size_t NodeCount      = 0;
+    size_t LeafCount      = 0;
+    int    MaxDepth       = 0;
+    double SAHCost        = 0.0;    // Expected cost of a random ray, relative to the root surface area
+    double BuildTimeMs    = 0.0;
+
+    void Log(std::string_view name) const;
+};
+
+// Returns the surface area of a box, zero for empty boxes.
+double SurfaceArea(const Math::AABB& box);
+
+// Whether the box is non-empty on all axes and all its bounds are finite.
+bool IsFiniteBox(const Math::AABB& box);
+
+inline Math::Point3 Centroid(const Math::AABB& box)
+{
+    return {(box.X.Min + box.X.Max) / 2, (box.Y.Min + box.Y.Max) / 2, (box.Z.Min + box.Z.Max) / 2};
+}
+
+// Convert bounds to float, rounding outwards, so the float box always contains the double one.
+inline float FloatRoundDown(const double value)
+{
+    const auto f = static_cast<float>(value);
+    return static_cast<double>(f) > value ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f;
+}
+
+inline float FloatRoundUp(const double value)
+{
+    const auto f = static_cast<float>(value);
+    return static_cast<double>(f) < value ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f;
+}
+
+// Relative error bound of the float slab test, see PBRT 3.9.2 "Conservative Ray-Bounds Intersections".
+constexpr float SlabErrorScale = 1.0f + 2.0f * (3.0f * std::numeric_limits<float>::epsilon() * 0.5f) / (1.0f - 3.0f * std::numeric_limits<float>::epsilon() * 0.5f);
+
+// Float bound at time 0 and its change until time 1 of a bound moving from start to end. Both are moved outwards by
+// more than the rounding error of bound + t * delta, so the float interpolation always contains the exact bound.
+inline void FloatMotionBound(const double start, const double end, const bool isMax, float& bound, float& delta)
+{
+    const double pad = (isMax ? 4.0 : -4.0) * std::numeric_limits<float>::epsilon() * (std::fabs(start) + std::fabs(end));
+    bound            = isMax ? FloatRoundUp(start + pad) : FloatRoundDown(start + pad);
+    delta            = static_cast<float>((isMax ? FloatRoundUp(end + pad) : FloatRoundDown(end + pad)) - static_cast<double>(bound));
+}
+
+namespace Impl
+{
+
+    inline const Math::Interval& AxisInterval(const Math::AABB& box, const int axis)
+    {
+        return axis == 0 ? box.X : (axis == 1 ? box.Y : box.Z);
+    }
+
+    // Plain min/max bounds used while binning, cheaper to grow than AABBs made of Intervals.
+    struct BinBounds
+    {
+        Math::Real Min[3] = {Math::Infinity, Math::Infinity, Math::Infinity};
+        Math::Real Max[3] = {-Math::Infinity, -Math::Infinity, -Math::Infinity};
+
+        void Grow(const BinBounds& other)
+        {
+            for(int c = 0; c < 3; c++)
+            {
+                Min[c] = std::min(Min[c], other.Min[c]);
+                Max[c] = std::max(Max[c], other.Max[c]);
+            }
+        }
+
+        double SurfaceArea() const
+        {
+            if(Min[0] > Max[0])
+                return 0.0;
+
+            const double dx = Max[0] - Min[0];
+            const double dy = Max[1] - Min[1];
+            const double dz = Max[2] - Min[2];
+            return 2.0 * (dx * dy + dy * dz + dz * dx);
+        }
+    };
+
+}    // namespace Impl
+
+// Partitions the items in [first, last) along the cheapest binned SAH split, see Wald, "On fast Construction of
+// SAH-based Bounding Volume Hierarchies" (2007). Returns the split position, or `last` if no split separates the
+// centroids or, when a leaf is allowed, if keeping all items in one leaf is cheaper than the best split.
+template <typename Iterator, typename BoundsFunction>
+Iterator PartitionSAH(Iterator first, Iterator last, BoundsFunction getBounds, const BVHBuildOptions& options, const bool allowLeaf)
+{
+    struct Bin
+    {
+        Impl::BinBounds Bounds;
+        size_t          Count = 0;
+    };
+
+    const auto count = static_cast<size_t>(std::distance(first, last));
+    if(count < 2)
+        return last;
+
+    Impl::BinBounds bounds;
+    Impl::BinBounds centroidBounds;
+    for(auto it = first; it != last; ++it)
+    {
+        const Math::AABB& box = getBounds(*it);
+        for(int c = 0; c < 3; c++)
+        {
+            const Math::Interval& interval = Impl::AxisInterval(box, c);
+            const Math::Real      centroid = 0.5 * (interval.Min + interval.Max);
+
+            bounds.Min[c]         = std::min(bounds.Min[c], interval.Min);
+            bounds.Max[c]         = std::max(bounds.Max[c], interval.Max);
+            centroidBounds.Min[c] = std::min(centroidBounds.Min[c], centroid);
+            centroidBounds.Max[c] = std::max(centroidBounds.Max[c], centroid);
+        }
+    }
+
+    const int    binCount   = std::clamp(options.BinCount, 2, BVHBuildOptions::MaxBinCount);
+    const double parentArea = bounds.SurfaceArea();
+
+    double scale[3];
+    for(int axis = 0; axis < 3; axis++)
+    {
+        const double extent = centroidBounds.Max[axis] - centroidBounds.Min[axis];
+        scale[axis]         = extent > 0.0 ? binCount / extent : 0.0;
+    }
+
+    const auto binIndex = [&](const Math::AABB& box, const int axis)
+    {
+        const Math::Interval& interval = Impl::AxisInterval(box, axis);
+        const Math::Real      centroid = 0.5 * (interval.Min + interval.Max);
+        const double          offset   = (centroid - centroidBounds.Min[axis]) * scale[axis];
+
+        // Clamped before the conversion, which is undefined for NaN and out-of-range values.
+        if(!(offset > 0.0))
+            return 0;
+        return offset < binCount - 1 ? static_cast<int>(offset) : binCount - 1;
+    };
+
+    // Bin all three axes in a single pass over the items.
+    std::array<std::array<Bin, BVHBuildOptions::MaxBinCount>, 3> bins;
+    for(auto it = first; it != last; ++it)
+    {
+        const Math::AABB& box = getBounds(*it);
+
+        Impl::BinBounds itemBounds;
+        for(int c = 0; c < 3; c++)
+        {
+            itemBounds.Min[c] = Impl::AxisInterval(box, c).Min;
+            itemBounds.Max[c] = Impl::AxisInterval(box, c).Max;
+        }
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            Bin& bin = bins[axis][binIndex(box, axis)];
+            bin.Bounds.Grow(itemBounds);
+            bin.Count++;
+        }
+    }
+
+    double bestCost = Math::Infinity;
+    int    bestAxis = -1;
+    int    bestBin  = 0;
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        if(scale[axis] <= 0.0)
+            continue;
+
+        // Sweep from the left to get the area and count below every split plane, then sweep from the right.
+        std::array<double, BVHBuildOptions::MaxBinCount> leftArea;
+        std::array<size_t, BVHBuildOptions::MaxBinCount> leftCount;
+        Impl::BinBounds                                  leftBounds;
+        size_t                                           leftTotal = 0;
+        for(int i = 0; i < binCount - 1; i++)
+        {
+            leftBounds.Grow(bins[axis][i].Bounds);
+            leftTotal    += bins[axis][i].Count;
+            leftArea[i]   = leftBounds.SurfaceArea();
+            leftCount[i]  = leftTotal;
+        }
+
+        Impl::BinBounds rightBounds;
+        size_t          rightTotal = 0;
+        for(int i = binCount - 1; i > 0; i--)
+        {
+            rightBounds.Grow(bins[axis][i].Bounds);
+            rightTotal += bins[axis][i].Count;
+
+            // Split between bin i - 1 and bin i
+            if(leftCount[i - 1] == 0 || rightTotal == 0)
+                continue;
+
+            const double cost = options.TraversalCost
+                                + options.LeafCost * (leftArea[i - 1] * static_cast<double>(leftCount[i - 1]) + rightBounds.SurfaceArea() * static_cast<double>(rightTotal)) / parentArea;
+            if(cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin  = i - 1;
+            }
+        }
+    }
+
+    if(bestAxis < 0)
+        return last;
+
+    if(allowLeaf && options.LeafCost * static_cast<double>(count) <= bestCost)
+        return last;
+
+    return std::partition(first, last, [&](const auto& item) { return binIndex(getBounds(item), bestAxis) <= bestBin; });
+}
+
+// Node of the intermediate tree produced by BVHBuilder. The two children of an interior node are always adjacent.
+struct BVHBuildNode
+{
+    Math::AABB Bounds;
+    uint32_t   Offset         = 0;    // Leaf: first entry in BVHBuilder::PrimitiveIndices(). Interior: index of the first child.
+    uint32_t   PrimitiveCount = 0;    // Zero for interior nodes
+
+    bool IsLeaf() const { return PrimitiveCount > 0; }
+};
+
+// Builds a binary BVH over a list of primitive bounds. The result is an intermediate tree that the concrete BVHs
+// convert into their own layout. Large subtrees are built in parallel, and all nodes come from a single pool that
+// is allocated up front, so no allocations happen during the build. Primitives with empty or non-finite bounds are
+// left out, so PrimitiveIndices() may be shorter than the input and Nodes() is empty if no primitive remains.
+class BVHBuilder
+{
+public:
+    // Upper bound for leaves of primitives with coincident centroids, which no split can separate.
+    static constexpr uint32_t MaxLeafSize = 255;
+
+    explicit BVHBuilder(const BVHBuildOptions& options = {});
+
+    void Build(const std::vector<Math::AABB>& primitiveBounds);
+
+    const std::vector<BVHBuildNode>& Nodes() const { return m_Nodes; }
+    const std::vector<uint32_t>&     PrimitiveIndices() const { return m_PrimitiveIndices; }
+    const BVHBuildStats&             Stats() const { return m_Stats; }
+
+private:
+    struct BuildPrimitive
+    {
+        Math::AABB   Bounds;
+        Math::Point3 Centroid;
+        uint32_t     Index;
+    };
+
+    BVHBuildOptions             m_Options;
+    BVHBuildStats               m_Stats;
+    std::vector<BuildPrimitive> m_BuildPrimitives;
+    std::vector<BVHBuildNode>   m_Nodes;
+    std::vector<uint32_t>       m_PrimitiveIndices;
+    std::atomic<uint32_t>       m_NodeCount    = 0;
+    int                         m_MaxTaskDepth = 0;
+
+    void BuildRecursive(uint32_t nodeIndex, size_t start, size_t end, int depth);
+    void AccumulateStats(uint32_t nodeIndex, double rootArea, int depth);
+};
+
+// Bounds at time 0 and time 1 of the primitives of a BVH and, after Compute(), of every node the builder made from
+// them. Primitives that do not move have the same bounds at both times.
+struct MotionBuildBounds
+{
+    std::vector<Math::AABB> PrimitiveStart;
+    std::vector<Math::AABB> PrimitiveEnd;
+    std::vector<Math::AABB> NodeStart;
+    std::vector<Math::AABB> NodeEnd;
+
+    // Fills the bounds to build the tree over and returns whether any primitive moves. These are the bounding boxes
+    // if nothing moves, and the bounds halfway through the motion otherwise.
+    bool Collect(const std::vector<std::shared_ptr<Hittable>>& primitives, std::vector<Math::AABB>& buildBounds);
+
+    // Bounds of the nodes at both times. The builder allocates children after their parents, so one backward pass
+    // over the nodes suffices.
+    void Compute(const BVHBuilder& builder);
+};
+
+}    // namespace Objects
@@ -1,7 +1,11 @@
 // ReSharper disable CppUnreachableCode
 #include "ConstantMedium.h"
 
+#include "HittableList.h"
+
 #include <Render/HitRecord.h>
+#include <Render/MaterialTable.h>
+#include <Utils/Log.h>
 
 namespace Objects
 {
@@ -60,8 +64,9 @@ bool ConstantMedium::Hit(const Render::Ray& ray, const Math::Interval rayT, Rend
         return false;
     }
 
-    rec.T = rec1.T + hitDistance / rayLength;
-    rec.P = ray.At(rec.T);
+    rec.T      = rec1.T + hitDistance / rayLength;
+    rec.P      = ray.At(rec.T);
+    rec.PError = 0;    // Inside the volume, there is no surface to leave
 
     if(debugging)
     {
@@ -70,9 +75,10 @@ bool ConstantMedium::Hit(const Render::Ray& ray, const Math::Interval rayT, Rend
                   << "rec.P = " << rec.P << '\n';
     }
 
-    rec.Normal    = Math::Vector3(1, 0, 0);    // arbitrary
-    rec.FrontFace = true;                      // also arbitrary
-    rec.SetMaterial(m_PhaseFunction);
+    rec.Normal        = Math::Vector3(1, 0, 0);    // arbitrary
+    rec.FrontFace     = true;                      // also arbitrary
+    rec.MaterialIndex = m_MaterialIndex;
+    rec.PrimitiveId   = m_PrimitiveId;
 
     return true;
 }
@@ -83,4 +89,25 @@ Math::AABB ConstantMedium::BoundingBox() const
     return m_Boundary->BoundingBox();
 }
 
+bool ConstantMedium::MotionBounds(Math::AABB& start, Math::AABB& end) const
+{
+    return m_Boundary->MotionBounds(start, end);
+}
+
+void ConstantMedium::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    // The boundary only delimits the volume, its own hits never reach the camera.
+    m_MaterialIndex = materials.Add(m_PhaseFunction);
+    m_PrimitiveId   = nextPrimitiveId++;
+}
+
+void ConstantMedium::CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const
+{
+    HittableList            boundaryEmitters;
+    std::vector<Math::Real> boundaryPowers;
+    m_Boundary->CollectEmitters(boundaryEmitters, boundaryPowers, material);
+    if(!boundaryEmitters.Objects.empty())
+        LOG_WARN("Constant medium: {} emitters of its boundary are neither rendered nor sampled as lights", boundaryEmitters.Objects.size());
+}
+
 }    // namespace Objects
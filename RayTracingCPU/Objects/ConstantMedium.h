@@ -10,14 +10,14 @@ namespace Objects
 class ConstantMedium final : public Hittable
 {
 public:
-    ConstantMedium(const std::shared_ptr<Hittable>& boundary, const double density, const std::shared_ptr<Render::Texture>& texture)
+    ConstantMedium(const std::shared_ptr<Hittable>& boundary, const Math::Real density, const std::shared_ptr<Render::Texture>& texture)
         : m_Boundary(boundary)
         , m_NegativeInvertedDensity(-1 / density)
         , m_PhaseFunction(std::make_shared<Render::Isotropic>(texture))
     {
     }
 
-    ConstantMedium(const std::shared_ptr<Hittable>& boundary, const double density, const Render::Color3& color)
+    ConstantMedium(const std::shared_ptr<Hittable>& boundary, const Math::Real density, const Render::Color3& color)
         : m_Boundary(boundary)
         , m_NegativeInvertedDensity(-1 / density)
         , m_PhaseFunction(std::make_shared<Render::Isotropic>(color))
@@ -26,11 +26,18 @@ public:
 
     bool       Hit(const Render::Ray& ray, Math::Interval rayT, Render::HitRecord& rec) const override;
     Math::AABB BoundingBox() const override;
+    bool       MotionBounds(Math::AABB& start, Math::AABB& end) const override;
+    void       AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
+
+    // A volume is no light, emitters of its boundary are only reported.
+    void CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const override;
 
 private:
     std::shared_ptr<Hittable>         m_Boundary;
-    double                            m_NegativeInvertedDensity;
+    Math::Real                        m_NegativeInvertedDensity;
     std::shared_ptr<Render::Material> m_PhaseFunction;
+    uint32_t                          m_MaterialIndex = 0;
+    uint32_t                          m_PrimitiveId   = 0;
 };
 
 }    // namespace Objects
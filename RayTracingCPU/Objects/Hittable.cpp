@@ -1,11 +1,13 @@
 #include "Hittable.h"
 
 #include <Math/Converters.h>
+#include <Render/HitRecord.h>
+#include <Render/RayPacket.h>
 
 namespace Objects
 {
 
-double Hittable::PDFValue(const Math::Vector3& origin, const Math::Vector3& direction) const
+Math::Real Hittable::PDFValue(const Math::Vector3& origin, const Math::Vector3& direction) const
 {
     return 0.0;
 }
@@ -15,4 +17,37 @@ Math::Vector3 Hittable::Random(const Math::Vector3& origin) const
     return {1, 0, 0};
 }
 
+void Hittable::NormalBounds(Math::Vector3& axis, Math::Real& cosTheta) const
+{
+    axis     = {0, 0, 1};
+    cosTheta = -1;
+}
+
+void Hittable::CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const
+{
+}
+
+bool Hittable::Occluded(const Render::Ray& r, const Math::Interval rayT) const
+{
+    Render::HitRecord rec;
+    return Hit(r, rayT, rec);
+}
+
+bool Hittable::MotionBounds(Math::AABB& start, Math::AABB& end) const
+{
+    return false;
+}
+
+void Hittable::HitPacket(const Render::RayPacket& packet, const Math::Interval rayT, Render::HitRecord* records, bool* hits) const
+{
+    for(int i = 0; i < packet.Size; i++)
+    {
+        hits[i] = Hit(packet.Rays[i], rayT, records[i]);
+    }
+}
+
+void Hittable::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+}
+
 }    // namespace Objects
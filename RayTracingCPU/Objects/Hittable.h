@@ -3,6 +3,10 @@
 #include <Math/AABB.h>
 #include <Math/Vector3.h>
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 namespace Math
 {
 class Interval;
@@ -11,12 +15,17 @@ class Interval;
 namespace Render
 {
 class HitRecord;
+class Material;
+class MaterialTable;
 class Ray;
+struct RayPacket;
 }    // namespace Math
 
 namespace Objects
 {
 
+class HittableList;
+
 class Hittable
 {
 public:
@@ -26,8 +35,34 @@ public:
     // virtual bool hit(const Render::Ray &r, double ray_tmin, double ray_tmax, Render::HitRecord &rec) const = 0;
     virtual bool          Hit(const Render::Ray& r, Math::Interval rayT, Render::HitRecord& rec) const = 0;
     virtual Math::AABB    BoundingBox() const                                                          = 0;
-    virtual double        PDFValue(const Math::Vector3& origin, const Math::Vector3& direction) const;
+    virtual Math::Real    PDFValue(const Math::Vector3& origin, const Math::Vector3& direction) const;
     virtual Math::Vector3 Random(const Math::Vector3& origin) const;
+
+    // Cone bounding the surface normals of an object used as a light, given by its axis and the cosine of its half
+    // angle. Light samplers skip lights facing away from a point. The default bounds all directions.
+    virtual void NormalBounds(Math::Vector3& axis, Math::Real& cosTheta) const;
+
+    // Adds a copy of every primitive whose material emits light to emitters, and its emitted power to powers, so that
+    // scenes find their lights without a hand-made list. Containers forward to their children, transforms wrap the
+    // emitters of their object in an Instance, and meshes add their emissive triangles. A material, if given, replaces
+    // those of the primitives, as the material of an enclosing Instance does.
+    virtual void CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const;
+
+    // Whether anything is hit inside rayT, for shadow and visibility rays. Stops at the first hit found instead of
+    // searching for the closest one and fills no record. The default runs Hit. Light samples test the world with it
+    // up to the sampled light, see Render::Camera::SampleLight().
+    virtual bool Occluded(const Render::Ray& r, Math::Interval rayT) const;
+
+    // Bounds at times 0 and 1 of an object moving linearly, the bounds at any time in between are interpolated from them.
+    // Returns false for objects that do not move, BoundingBox() then holds at all times.
+    virtual bool MotionBounds(Math::AABB& start, Math::AABB& end) const;
+
+    // Intersects all rays of the packet, hits[i] tells whether records[i] was filled. The default traces the rays one by one.
+    virtual void HitPacket(const Render::RayPacket& packet, Math::Interval rayT, Render::HitRecord* records, bool* hits) const;
+
+    // Adds the materials to the scene table and numbers the primitives, which then report both in their hit records.
+    // Containers forward to their children. Runs once per scene, before the world is compiled into a BVH.
+    virtual void AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId);
 };
 
 }    // namespace Objects
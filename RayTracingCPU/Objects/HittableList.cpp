@@ -40,14 +40,25 @@ bool HittableList::Hit(const Render::Ray& r, const Math::Interval rayT, Render::
     return hitAnything;
 }
 
+bool HittableList::Occluded(const Render::Ray& r, const Math::Interval rayT) const
+{
+    for(const auto& object : Objects)
+    {
+        if(object->Occluded(r, rayT))
+            return true;
+    }
+
+    return false;
+}
+
 Math::AABB HittableList::BoundingBox() const
 {
     return m_BoundingBox;
 }
 
-double HittableList::PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const
+Math::Real HittableList::PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const
 {
-    const auto weight = 1.0 / static_cast<double>(Objects.size());
+    const auto weight = 1.0 / static_cast<Math::Real>(Objects.size());
     auto       sum    = 0.0;
 
     for(const auto& object : Objects)
@@ -62,4 +73,16 @@ Math::Vector3 HittableList::Random(const Math::Vector3& origin) const
     return Objects[Utils::Random::Int(0, intSize - 1)]->Random(origin);
 }
 
+void HittableList::CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const
+{
+    for(const auto& object : Objects)
+        object->CollectEmitters(emitters, powers, material);
+}
+
+void HittableList::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    for(const auto& object : Objects)
+        object->AssignIds(materials, nextPrimitiveId);
+}
+
 }    // namespace Objects
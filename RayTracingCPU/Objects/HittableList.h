@@ -3,6 +3,7 @@
 #include "Hittable.h"
 
 #include <memory>
+#include <vector>
 
 namespace Objects
 {
@@ -19,9 +20,12 @@ public:
     void          Clear();
     void          Add(const std::shared_ptr<Hittable>& object);
     bool          Hit(const Render::Ray& r, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool          Occluded(const Render::Ray& r, Math::Interval rayT) const override;
     Math::AABB    BoundingBox() const override;
-    double        PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const override;
+    Math::Real    PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const override;
     Math::Vector3 Random(const Math::Vector3& origin) const override;
+    void          CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const override;
+    void          AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
 
 private:
     Math::AABB m_BoundingBox;
@@ -0,0 +1,148 @@
+#include "Instance.h"
+
+#include "BVHBuild.h"
+#include "HittableList.h"
+
+#include <Render/HitRecord.h>
+#include <Render/MaterialTable.h>
+
+#include <cmath>
+
+namespace Objects
+{
+
+Instance::Instance(const std::shared_ptr<Hittable>& object, const Math::Transform& objectToWorld, const std::shared_ptr<Render::Material>& material)
+    : m_Object(object)
+    , m_ObjectToWorld(objectToWorld)
+    , m_Material(material)
+{
+    if(const auto* instance = dynamic_cast<const Instance*>(object.get()))
+    {
+        m_Object        = instance->m_Object;
+        m_ObjectToWorld = objectToWorld * instance->m_ObjectToWorld;
+        if(!m_Material)
+            m_Material = instance->m_Material;
+    }
+
+    SetObjectToWorld(m_ObjectToWorld);
+}
+
+void Instance::SetObjectToWorld(const Math::Transform& objectToWorld)
+{
+    m_ObjectToWorld = objectToWorld;
+    m_WorldToObject = objectToWorld.Inverse();
+
+    // Corners of an empty box are infinite, and transforming them would give NaN or unbounded intervals.
+    const Math::AABB objectBox = m_Object->BoundingBox();
+    m_BoundingBox              = IsFiniteBox(objectBox) ? objectToWorld.ApplyBox(objectBox) : Math::AABB::Empty;
+}
+
+bool Instance::Hit(const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord& rec) const
+{
+    if(!m_Object->Hit(ObjectRay(ray), rayT, rec))
+        return false;
+
+    // Normals move with the inverse transpose, which keeps their side of the surface, so FrontFace stays valid.
+    rec.P      = m_ObjectToWorld.ApplyPoint(rec.P, rec.PError);
+    rec.Normal = UnitVector(m_ObjectToWorld.ApplyNormal(rec.Normal));
+    rec.PrimitiveId += m_FirstPrimitiveId;
+    if(m_Material)
+        rec.MaterialIndex = m_MaterialIndex;
+
+    return true;
+}
+
+bool Instance::Occluded(const Render::Ray& ray, const Math::Interval rayT) const
+{
+    return m_Object->Occluded(ObjectRay(ray), rayT);
+}
+
+Math::AABB Instance::BoundingBox() const
+{
+    return m_BoundingBox;
+}
+
+bool Instance::MotionBounds(Math::AABB& start, Math::AABB& end) const
+{
+    if(!m_Object->MotionBounds(start, end))
+        return false;
+
+    start = IsFiniteBox(start) ? m_ObjectToWorld.ApplyBox(start) : Math::AABB::Empty;
+    end   = IsFiniteBox(end) ? m_ObjectToWorld.ApplyBox(end) : Math::AABB::Empty;
+    return true;
+}
+
+void Instance::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    // A shared object is visited once per instance and numbered from zero every time, so all instances see the same
+    // ids. Each instance reserves its own range and offsets the ids of the object into it. The table adds each
+    // material once.
+    uint32_t objectPrimitiveCount = 0;
+    m_Object->AssignIds(materials, objectPrimitiveCount);
+    m_FirstPrimitiveId = nextPrimitiveId;
+    nextPrimitiveId += objectPrimitiveCount;
+
+    if(m_Material)
+        m_MaterialIndex = materials.Add(m_Material);
+}
+
+void Instance::CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const
+{
+    // The material of an enclosing instance wins, as it does on hits.
+    HittableList            objectEmitters;
+    std::vector<Math::Real> objectPowers;
+    m_Object->CollectEmitters(objectEmitters, objectPowers, material ? material : m_Material);
+
+    // A flat emitter with unit normal n changes its area by |det A| |A^-T n| under the linear part A. Curved emitters
+    // and meshes get the change of a uniform scale with the same volume change, |det A|^(2/3), which is only exact for
+    // rigid motions and uniform scales. Elsewhere it skews how often the light is picked, but not the result.
+    const Math::Real determinant = std::fabs(m_ObjectToWorld.Determinant());
+    const Math::Real volumeScale = std::pow(determinant, Math::Real(2) / 3);
+
+    for(size_t i = 0; i < objectEmitters.Objects.size(); i++)
+    {
+        Math::Vector3 normal;
+        Math::Real    cosTheta;
+        objectEmitters.Objects[i]->NormalBounds(normal, cosTheta);
+        const Math::Real areaScale = cosTheta >= 1 ? determinant * m_ObjectToWorld.ApplyNormal(normal).Length() : volumeScale;
+
+        emitters.Add(std::make_shared<Instance>(objectEmitters.Objects[i], m_ObjectToWorld));
+        powers.emplace_back(objectPowers[i] * areaScale);
+    }
+}
+
+void Instance::NormalBounds(Math::Vector3& axis, Math::Real& cosTheta) const
+{
+    m_Object->NormalBounds(axis, cosTheta);
+    if(cosTheta >= 1)
+    {
+        axis = UnitVector(m_ObjectToWorld.ApplyNormal(axis));
+    }
+    else
+    {
+        Hittable::NormalBounds(axis, cosTheta);
+    }
+}
+
+// A unit world direction w maps to the object direction B w, with B the linear part of the world to object transform.
+// Solid angles change by the Jacobian |det B| / |B w|^3 of that map, which is one for rigid motions and uniform scales.
+Math::Real Instance::PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const
+{
+    const Math::Vector3 objectDirection = m_WorldToObject.ApplyVector(UnitVector(direction));
+    const Math::Real    length          = objectDirection.Length();
+    const Math::Real    density         = m_Object->PDFValue(m_WorldToObject.ApplyPoint(origin), objectDirection);
+    return density > 0 ? density * std::fabs(m_WorldToObject.Determinant()) / (length * length * length) : 0;
+}
+
+Math::Vector3 Instance::Random(const Math::Point3& origin) const
+{
+    return m_ObjectToWorld.ApplyVector(m_Object->Random(m_WorldToObject.ApplyPoint(origin)));
+}
+
+// The direction is not normalized, so both rays reach the same point at the same t and rayT still applies.
+Render::Ray Instance::ObjectRay(const Render::Ray& ray) const
+{
+    return {m_WorldToObject.ApplyPoint(ray.Origin()), m_WorldToObject.ApplyVector(ray.Direction()), ray.Time()};
+}
+
+}    // namespace Objects
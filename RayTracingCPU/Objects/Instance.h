@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Hittable.h"
+
+#include <Math/Transform.h>
+
+#include <memory>
+
+namespace Render
+{
+class Material;
+}    // namespace Render
+
+namespace Objects
+{
+
+// Places a shared object, usually a prebuilt BVH or a TriangleMesh, with an affine transform. Rays are moved into the
+// object space instead of the object into world space, so any number of instances share one acceleration structure.
+// Instances of instances are collapsed at construction, a whole chain costs one transform of the ray. Every instance
+// has its own range of primitive ids, so hits on different instances of one object report different ids.
+class Instance final : public Hittable
+{
+public:
+    // A material, if given, replaces the materials of the object for this instance only.
+    Instance(const std::shared_ptr<Hittable>& object, const Math::Transform& objectToWorld, const std::shared_ptr<Render::Material>& material = nullptr);
+
+    bool       Hit(const Render::Ray& ray, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool       Occluded(const Render::Ray& ray, Math::Interval rayT) const override;
+    Math::AABB BoundingBox() const override;
+    bool       MotionBounds(Math::AABB& start, Math::AABB& end) const override;
+    void       AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
+
+    // Wraps every emitter of the object in an instance with the same transform. The powers are scaled by the change of
+    // area, exact for flat emitters and otherwise for rigid motions and uniform scales.
+    void       CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const override;
+
+    // Only a single normal is transformed, any wider cone bounds all directions.
+    void       NormalBounds(Math::Vector3& axis, Math::Real& cosTheta) const override;
+
+    // The density of the object is converted from object to world solid angles, which differ unless the transform is a
+    // rigid motion or a uniform scale.
+    Math::Real    PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const override;
+    Math::Vector3 Random(const Math::Point3& origin) const override;
+
+    const std::shared_ptr<Hittable>& Object() const { return m_Object; }
+    const Math::Transform&           ObjectToWorld() const { return m_ObjectToWorld; }
+
+    // Moves the instance. A structure built over it has to be updated afterwards, see TopLevelBVH::Update().
+    void SetObjectToWorld(const Math::Transform& objectToWorld);
+
+private:
+    std::shared_ptr<Hittable> m_Object;
+    Math::Transform           m_ObjectToWorld;
+    Math::Transform           m_WorldToObject;
+    Math::AABB                m_BoundingBox;
+
+    std::shared_ptr<Render::Material> m_Material;
+    uint32_t                          m_MaterialIndex    = 0;
+    uint32_t                          m_FirstPrimitiveId = 0;    // Added to the primitive ids of the object
+
+    Render::Ray ObjectRay(const Render::Ray& ray) const;
+};
+
+}    // namespace Objects
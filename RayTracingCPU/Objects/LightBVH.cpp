@@ -0,0 +1,383 @@
+#include "LightBVH.h"
+
+#include <Math/Constants.h>
+#include <Render/HitRecord.h>
+#include <Render/Ray.h>
+#include <Utils/Random.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Objects
+{
+
+namespace Impl
+{
+
+    inline Math::Real SafeSqrt(const Math::Real x)
+    {
+        return std::sqrt(std::max<Math::Real>(0, x));
+    }
+
+    inline Math::Real SafeAcos(const Math::Real x)
+    {
+        return std::acos(std::clamp<Math::Real>(x, -1, 1));
+    }
+
+    // Cosine and sine of max(0, a - b), from the sines and cosines of the angles a and b.
+    inline Math::Real CosSubClamped(const Math::Real sinA, const Math::Real cosA, const Math::Real sinB, const Math::Real cosB)
+    {
+        return cosA > cosB ? 1 : cosA * cosB + sinA * sinB;
+    }
+
+    inline Math::Real SinSubClamped(const Math::Real sinA, const Math::Real cosA, const Math::Real sinB, const Math::Real cosB)
+    {
+        return cosA > cosB ? 0 : sinA * cosB - cosA * sinB;
+    }
+
+    // Smallest cone containing both cones, the cone of all directions if the axes point apart.
+    LightCone Union(const LightCone& a, const LightCone& b)
+    {
+        if(a.Power <= 0 || b.Power <= 0)
+        {
+            LightCone result = a.Power <= 0 ? b : a;
+            result.Power     = a.Power + b.Power;
+            return result;
+        }
+
+        LightCone result;
+        result.Power = a.Power + b.Power;
+        if(a.CosTheta <= -1 || b.CosTheta <= -1)
+            return result;
+
+        // One cone may already contain the other.
+        const Math::Real thetaA = SafeAcos(a.CosTheta);
+        const Math::Real thetaB = SafeAcos(b.CosTheta);
+        const Math::Real thetaD = SafeAcos(DotProduct(a.Axis, b.Axis));
+        if(std::min(thetaD + thetaB, Math::Pi) <= thetaA)
+        {
+            result.Axis     = a.Axis;
+            result.CosTheta = a.CosTheta;
+            return result;
+        }
+        if(std::min(thetaD + thetaA, Math::Pi) <= thetaB)
+        {
+            result.Axis     = b.Axis;
+            result.CosTheta = b.CosTheta;
+            return result;
+        }
+
+        const Math::Real thetaO = (thetaA + thetaD + thetaB) / 2;
+        if(thetaO >= Math::Pi)
+            return result;
+
+        // Rotate the axis of a towards the axis of b, around the normal of the plane they span.
+        const Math::Vector3 rotationAxis = CrossProduct(a.Axis, b.Axis);
+        if(rotationAxis.LengthSquared() <= 0)
+            return result;
+
+        const Math::Real thetaR = thetaO - thetaA;
+        result.Axis             = UnitVector(a.Axis * std::cos(thetaR) + CrossProduct(UnitVector(rotationAxis), a.Axis) * std::sin(thetaR));
+        result.CosTheta         = std::cos(thetaO);
+        return result;
+    }
+
+}    // namespace Impl
+
+LightBVH::LightBVH(const HittableList& lights, const std::vector<Math::Real>& powers, const LightSelection selection)
+    : m_Lights(lights.Objects)
+    , m_Selection(selection)
+{
+    if(m_Lights.empty())
+        return;
+
+    std::vector<Math::AABB> lightBounds;
+    lightBounds.reserve(m_Lights.size());
+    for(const auto& light : m_Lights)
+    {
+        lightBounds.emplace_back(light->BoundingBox());
+    }
+
+    // The cones are only tight around single lights, so leaves hold one light unless their centroids coincide.
+    BVHBuildOptions options;
+    options.MaxPrimitivesInLeaf = 1;
+
+    BVHBuilder builder(options);
+    builder.Build(lightBounds);
+
+    m_Nodes        = builder.Nodes();
+    m_LightIndices = builder.PrimitiveIndices();
+    m_Stats        = builder.Stats();
+
+    m_LightPowers.resize(m_Lights.size(), 1);
+    if(powers.size() == m_Lights.size())
+        m_LightPowers = powers;
+
+    // The builder allocates children after their parents, so a backward pass sees every child before its parent.
+    m_NodeCones.resize(m_Nodes.size());
+    m_Parents.assign(m_Nodes.size(), 0);
+    m_LightLeaves.assign(m_Lights.size(), NoLeaf);
+    for(size_t i = m_Nodes.size(); i-- > 0;)
+    {
+        const auto& node = m_Nodes[i];
+        auto&       cone = m_NodeCones[i];
+        if(node.IsLeaf())
+        {
+            for(uint32_t j = 0; j < node.PrimitiveCount; j++)
+            {
+                const uint32_t light = m_LightIndices[node.Offset + j];
+                m_LightLeaves[light] = static_cast<uint32_t>(i);
+
+                LightCone lightCone;
+                m_Lights[light]->NormalBounds(lightCone.Axis, lightCone.CosTheta);
+                lightCone.Power = m_LightPowers[light];
+                cone            = j == 0 ? lightCone : Impl::Union(cone, lightCone);
+            }
+        }
+        else
+        {
+            m_Parents[node.Offset]     = static_cast<uint32_t>(i);
+            m_Parents[node.Offset + 1] = static_cast<uint32_t>(i);
+            cone                       = Impl::Union(m_NodeCones[node.Offset], m_NodeCones[node.Offset + 1]);
+        }
+    }
+
+    // Lights without bounds are not in the tree, so PDFValue() never reaches them and they must not be picked either.
+    if(m_Selection == LightSelection::Power)
+    {
+        std::vector<Math::Real> weights(m_Lights.size(), 0);
+        Math::Real              weightSum = 0;
+        for(size_t light = 0; light < m_Lights.size(); light++)
+        {
+            if(m_LightLeaves[light] != NoLeaf)
+            {
+                weights[light] = std::max<Math::Real>(m_LightPowers[light], 0);
+                weightSum += weights[light];
+            }
+        }
+
+        // Without any power, the lights in the tree are picked uniformly.
+        for(size_t light = 0; weightSum <= 0 && light < m_Lights.size(); light++)
+        {
+            weights[light] = m_LightLeaves[light] != NoLeaf ? 1 : 0;
+        }
+        m_AliasTable = Math::AliasTable(weights);
+    }
+
+    m_Stats.Log("LightBVH");
+}
+
+// Bounds the contribution of the node with the angle between its cone and the point, reduced by the angles the cone
+// and the bounds of the node subtend, see PBRT 12.6.3 "Bounding Volume Hierarchies for Light Sampling".
+Math::Real LightBVH::Importance(const Math::Point3& origin, const uint32_t node) const
+{
+    const LightCone& cone = m_NodeCones[node];
+    if(cone.Power <= 0)
+        return 0;
+
+    const Math::AABB&   bounds = m_Nodes[node].Bounds;
+    const Math::Vector3 diagonal(bounds.X.Size(), bounds.Y.Size(), bounds.Z.Size());
+    const Math::Vector3 toPoint = origin - Centroid(bounds);
+
+    // Points inside the bounding sphere of the node may be reached by any of its lights.
+    const Math::Real radiusSquared   = diagonal.LengthSquared() / 4;
+    const Math::Real distanceSquared = toPoint.LengthSquared();
+    if(distanceSquared <= radiusSquared)
+        return radiusSquared > 0 ? cone.Power / radiusSquared : cone.Power;
+
+    const Math::Real cosW = DotProduct(cone.Axis, toPoint) / std::sqrt(distanceSquared);
+    const Math::Real sinW = Impl::SafeSqrt(1 - cosW * cosW);
+    const Math::Real sinO = Impl::SafeSqrt(1 - cone.CosTheta * cone.CosTheta);
+    const Math::Real sinB = std::sqrt(radiusSquared / distanceSquared);
+    const Math::Real cosB = Impl::SafeSqrt(1 - sinB * sinB);
+
+    const Math::Real cosX = Impl::CosSubClamped(sinW, cosW, sinO, cone.CosTheta);
+    const Math::Real sinX = Impl::SinSubClamped(sinW, cosW, sinO, cone.CosTheta);
+    const Math::Real cosP = Impl::CosSubClamped(sinX, cosX, sinB, cosB);
+
+    // Diffuse lights emit nothing beyond 90 degrees from their normals.
+    if(cosP <= 0)
+        return 0;
+
+    return cone.Power * cosP / distanceSquared;
+}
+
+// Interior nodes without any importance split evenly, so the probabilities of all lights always sum up to one.
+Math::Real LightBVH::FirstChildProbability(const Math::Point3& origin, const BVHBuildNode& node) const
+{
+    const Math::Real first  = Importance(origin, node.Offset);
+    const Math::Real second = Importance(origin, node.Offset + 1);
+    return first + second > 0 ? first / (first + second) : Math::Real(0.5);
+}
+
+uint32_t LightBVH::Sample(const Math::Point3& origin, Math::Real u, Math::Real& pmf) const
+{
+    constexpr Math::Real OneMinusEpsilon = 1 - std::numeric_limits<Math::Real>::epsilon();
+
+    if(m_Selection == LightSelection::Power)
+        return m_AliasTable.Sample(u, pmf);
+
+    pmf             = 1;
+    uint32_t offset = 0;
+    while(!m_Nodes[offset].IsLeaf())
+    {
+        const auto&      node  = m_Nodes[offset];
+        const Math::Real first = FirstChildProbability(origin, node);
+
+        // Reuse the part of u below or above the split as the next number.
+        if(u < first)
+        {
+            offset = node.Offset;
+            u      = std::min(u / first, OneMinusEpsilon);
+            pmf *= first;
+        }
+        else
+        {
+            offset = node.Offset + 1;
+            u      = std::min((u - first) / (1 - first), OneMinusEpsilon);
+            pmf *= 1 - first;
+        }
+    }
+
+    // Lights sharing a leaf are picked by their power.
+    const auto& leaf      = m_Nodes[offset];
+    Math::Real  leafPower = m_NodeCones[offset].Power;
+    for(uint32_t j = 0; j + 1 < leaf.PrimitiveCount; j++)
+    {
+        const uint32_t   light       = m_LightIndices[leaf.Offset + j];
+        const Math::Real probability = leafPower > 0 ? m_LightPowers[light] / leafPower : Math::Real(1) / static_cast<Math::Real>(leaf.PrimitiveCount - j);
+        if(u < probability)
+        {
+            pmf *= probability;
+            return light;
+        }
+        u = std::min((u - probability) / (1 - probability), OneMinusEpsilon);
+        pmf *= 1 - probability;
+        leafPower -= m_LightPowers[light];
+    }
+
+    return m_LightIndices[leaf.Offset + leaf.PrimitiveCount - 1];
+}
+
+Math::Real LightBVH::PMF(const Math::Point3& origin, const uint32_t light) const
+{
+    if(m_Selection == LightSelection::Power)
+        return m_AliasTable.PMF(light);
+
+    // Lights without bounds are not in the tree and never picked.
+    uint32_t offset = m_LightLeaves[light];
+    if(offset == NoLeaf)
+        return 0;
+
+    Math::Real  pmf       = 1;
+    const auto& leaf      = m_Nodes[offset];
+    Math::Real  leafPower = m_NodeCones[offset].Power;
+    if(leaf.PrimitiveCount > 1)
+    {
+        pmf = leafPower > 0 ? m_LightPowers[light] / leafPower : Math::Real(1) / static_cast<Math::Real>(leaf.PrimitiveCount);
+    }
+
+    while(offset != 0)
+    {
+        const uint32_t   parent = m_Parents[offset];
+        const Math::Real first  = FirstChildProbability(origin, m_Nodes[parent]);
+        pmf *= offset == m_Nodes[parent].Offset ? first : 1 - first;
+        offset = parent;
+    }
+
+    return pmf;
+}
+
+bool LightBVH::Hit(const Render::Ray& r, const Math::Interval rayT, Render::HitRecord& rec) const
+{
+    if(m_Nodes.empty())
+        return false;
+
+    bool       hitAnything  = false;
+    Math::Real closestSoFar = rayT.Max;
+
+    uint32_t stack[64];
+    int      stackSize = 0;
+    stack[stackSize++] = 0;
+    while(stackSize > 0)
+    {
+        const auto& node = m_Nodes[stack[--stackSize]];
+        if(!node.Bounds.Hit(r, Math::Interval(rayT.Min, closestSoFar)))
+            continue;
+
+        if(node.IsLeaf())
+        {
+            for(uint32_t j = 0; j < node.PrimitiveCount; j++)
+            {
+                if(m_Lights[m_LightIndices[node.Offset + j]]->Hit(r, Math::Interval(rayT.Min, closestSoFar), rec))
+                {
+                    hitAnything  = true;
+                    closestSoFar = rec.T;
+                }
+            }
+        }
+        else
+        {
+            stack[stackSize++] = node.Offset;
+            stack[stackSize++] = node.Offset + 1;
+        }
+    }
+
+    return hitAnything;
+}
+
+Math::AABB LightBVH::BoundingBox() const
+{
+    return m_Nodes.empty() ? Math::AABB::Empty : m_Nodes[0].Bounds;
+}
+
+// The density of a direction sums over all lights it passes through, so only their leaves are visited.
+Math::Real LightBVH::PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const
+{
+    if(m_Nodes.empty())
+        return 0;
+
+    const Render::Ray ray(origin, direction);
+    Math::Real        sum = 0;
+
+    uint32_t stack[64];
+    int      stackSize = 0;
+    stack[stackSize++] = 0;
+    while(stackSize > 0)
+    {
+        const auto& node = m_Nodes[stack[--stackSize]];
+        if(!node.Bounds.Hit(ray, Math::Interval(0, Math::Infinity)))
+            continue;
+
+        if(node.IsLeaf())
+        {
+            for(uint32_t j = 0; j < node.PrimitiveCount; j++)
+            {
+                const uint32_t   light   = m_LightIndices[node.Offset + j];
+                const Math::Real density = m_Lights[light]->PDFValue(origin, direction);
+                if(density > 0)
+                    sum += PMF(origin, light) * density;
+            }
+        }
+        else
+        {
+            stack[stackSize++] = node.Offset;
+            stack[stackSize++] = node.Offset + 1;
+        }
+    }
+
+    return sum;
+}
+
+Math::Vector3 LightBVH::Random(const Math::Point3& origin) const
+{
+    if(m_Nodes.empty())
+        return {1, 0, 0};
+
+    Math::Real     pmf;
+    const uint32_t light = Sample(origin, static_cast<Math::Real>(Utils::Random::Double()), pmf);
+    return m_Lights[light]->Random(origin);
+}
+
+}    // namespace Objects
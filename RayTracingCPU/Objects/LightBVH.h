@@ -0,0 +1,79 @@
+#pragma once
+
+#include "BVHBuild.h"
+#include "Hittable.h"
+#include "HittableList.h"
+
+#include <Math/AliasTable.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Objects
+{
+
+// How a LightBVH picks the light for a shading point.
+enum class LightSelection : int
+{
+    Power      = 0,    // In proportion to the emitted power, from an alias table in O(1), the same for all points
+    Importance = 1     // Down the tree by the estimated contribution to the point, in O(log n)
+};
+
+// Power and orientation of the lights below a LightBVH node: the cone bounding their normals, given by its axis and
+// the cosine of its half angle, and the power they emit. All lights are assumed to emit like diffuse surfaces, into
+// the half sphere around each normal.
+struct LightCone
+{
+    Math::Vector3 Axis     = {0, 0, 1};
+    Math::Real    CosTheta = -1;    // -1 bounds all directions
+    Math::Real    Power    = 0;
+};
+
+// Light sampler over many lights, see Conty Estevez and Kulla, "Importance Sampling of Many Lights with Adaptive Tree
+// Splitting" (2018). A binary tree over the light bounds stores the power and normal cone of every node. Sampling by
+// importance walks down from the root and picks each child with a probability proportional to its estimated
+// contribution to the shading point, so one light costs O(log n) instead of the O(n) of a HittableList. Sampling by
+// power ignores the point and draws from an alias table instead. Either way PDFValue() only visits the lights the
+// direction passes through, and multiplies their density with the probability of picking them.
+class LightBVH final : public Hittable
+{
+public:
+    // Without powers, all lights get the same one.
+    explicit LightBVH(const HittableList& lights, const std::vector<Math::Real>& powers = {}, LightSelection selection = LightSelection::Power);
+
+    bool          Hit(const Render::Ray& r, Math::Interval rayT, Render::HitRecord& rec) const override;
+    Math::AABB    BoundingBox() const override;
+    Math::Real    PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const override;
+    Math::Vector3 Random(const Math::Point3& origin) const override;
+
+    // Picks a light for the shading point and returns its index, along with the probability of picking it.
+    uint32_t   Sample(const Math::Point3& origin, Math::Real u, Math::Real& pmf) const;
+    Math::Real PMF(const Math::Point3& origin, uint32_t light) const;
+
+    size_t               LightCount() const { return m_Lights.size(); }
+    LightSelection       Selection() const { return m_Selection; }
+    const BVHBuildStats& Stats() const { return m_Stats; }
+
+private:
+    static constexpr uint32_t NoLeaf = UINT32_MAX;
+
+    std::vector<std::shared_ptr<Hittable>> m_Lights;
+    std::vector<Math::Real>                m_LightPowers;
+    std::vector<BVHBuildNode>              m_Nodes;
+    std::vector<LightCone>                 m_NodeCones;       // Power and normals of the lights below each node
+    std::vector<uint32_t>                  m_Parents;         // Parent of each node, the root is its own parent
+    std::vector<uint32_t>                  m_LightIndices;    // Light of each leaf slot, ordered as referenced by leaves
+    std::vector<uint32_t>                  m_LightLeaves;     // Leaf node of each light
+    BVHBuildStats                          m_Stats;
+    Math::AliasTable                       m_AliasTable;    // Lights by power, for LightSelection::Power
+    LightSelection                         m_Selection;
+
+    // Estimated contribution of the lights below a node to the point, zero if none of them can reach it.
+    Math::Real Importance(const Math::Point3& origin, uint32_t node) const;
+
+    // Probability of walking from an interior node into its first child.
+    Math::Real FirstChildProbability(const Math::Point3& origin, const BVHBuildNode& node) const;
+};
+
+}    // namespace Objects
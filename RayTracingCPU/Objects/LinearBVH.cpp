@@ -0,0 +1,334 @@
+// ReSharper disable CppUseRangeAlgorithm
+#include "LinearBVH.h"
+
+#include "BVH.h"
+#include "SphereSet.h"
+#include "TriangleMesh.h"
+
+#include <Render/HitRecord.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Objects
+{
+
+namespace Impl
+{
+
+    void SetNodeBounds(LinearBVHNode& node, const Math::AABB& bounds)
+    {
+        for(int axis = 0; axis < 3; axis++)
+        {
+            node.BoundsMin[axis] = FloatRoundDown(bounds.AxisInterval(axis).Min);
+            node.BoundsMax[axis] = FloatRoundUp(bounds.AxisInterval(axis).Max);
+        }
+    }
+
+    // Slab test against the float bounds of a node.
+    bool IntersectNode(const float boundsMin[3], const float boundsMax[3], const float origin[3], const float invDirection[3], float tMin, float tMax)
+    {
+        for(int axis = 0; axis < 3; axis++)
+        {
+            auto t0 = (boundsMin[axis] - origin[axis]) * invDirection[axis];
+            auto t1 = (boundsMax[axis] - origin[axis]) * invDirection[axis];
+
+            if(invDirection[axis] < 0)
+                std::swap(t0, t1);
+
+            if(t0 > tMin)
+                tMin = t0;
+            if(t1 < tMax)
+                tMax = t1;
+
+            if(tMax < tMin)
+                return false;
+        }
+        return true;
+    }
+
+}    // namespace Impl
+
+LinearBVH::LinearBVH(const HittableList& list, const BVHBuildOptions& options)
+    : LinearBVH(list.Objects, options)
+{
+}
+
+LinearBVH::LinearBVH(const std::vector<std::shared_ptr<Hittable>>& srcObjects, const BVHBuildOptions& options)
+{
+    std::vector<std::shared_ptr<Hittable>> primitives;
+    for(const auto& object : srcObjects)
+    {
+        CollectPrimitives(object, primitives);
+    }
+
+    BVHBuilder builder(options);
+    Build(builder, std::move(primitives));
+
+    m_Stats = builder.Stats();
+    m_Stats.Log(options.SplitMethod == BVHSplitMethod::SAH ? "LinearBVH (SAH)" : "LinearBVH (Median)");
+}
+
+void LinearBVH::CollectPrimitives(const std::shared_ptr<Hittable>& object, std::vector<std::shared_ptr<Hittable>>& primitives)
+{
+    if(!object)
+        return;
+
+    if(const auto list = std::dynamic_pointer_cast<HittableList>(object))
+    {
+        for(const auto& child : list->Objects)
+        {
+            CollectPrimitives(child, primitives);
+        }
+        return;
+    }
+
+    if(const auto node = std::dynamic_pointer_cast<BVHNode>(object))
+    {
+        for(const auto& child : node->Objects())
+        {
+            CollectPrimitives(child, primitives);
+        }
+        return;
+    }
+
+    // Meshes without triangles, like models that failed to load, have no bounds to build over.
+    if(const auto mesh = std::dynamic_pointer_cast<TriangleMesh>(object); mesh && mesh->TriangleCount() == 0)
+        return;
+
+    // Large sets are split into blocks, so the tree is built over clusters of nearby spheres.
+    if(const auto spheres = std::dynamic_pointer_cast<SphereSet>(object); spheres && spheres->BlockCount() > 1)
+    {
+        for(const auto& cluster : spheres->Clusters().Objects)
+        {
+            primitives.emplace_back(cluster);
+        }
+        return;
+    }
+
+    primitives.emplace_back(object);
+}
+
+void LinearBVH::Build(BVHBuilder& builder, const std::vector<std::shared_ptr<Hittable>>& primitives)
+{
+    m_BoundingBox = Math::AABB::Empty;
+    m_Nodes.clear();
+    m_NodeMotions.clear();
+    m_Primitives.clear();
+    m_PrimitivePtrs.clear();
+
+    if(primitives.empty())
+        return;
+
+    std::vector<Math::AABB> primitiveBounds;
+    MotionBuildBounds       motion;
+    const bool              moving = motion.Collect(primitives, primitiveBounds);
+
+    builder.Build(primitiveBounds);
+    if(builder.Nodes().empty())
+        return;
+    if(moving)
+        motion.Compute(builder);
+
+    // Leaves of the build tree reference contiguous ranges of the primitive indices, so they keep their offsets.
+    m_Primitives.reserve(primitives.size());
+    m_PrimitivePtrs.reserve(primitives.size());
+    for(const auto index : builder.PrimitiveIndices())
+    {
+        m_Primitives.emplace_back(primitives[index]);
+        m_PrimitivePtrs.emplace_back(primitives[index].get());
+    }
+
+    m_Nodes.reserve(builder.Nodes().size());
+    if(moving)
+        m_NodeMotions.reserve(builder.Nodes().size());
+
+    Flatten(builder.Nodes(), moving ? &motion : nullptr, 0);
+    m_BoundingBox = builder.Nodes()[0].Bounds;
+
+    if(moving)
+    {
+        m_StartBox    = motion.NodeStart[0];
+        m_EndBox      = motion.NodeEnd[0];
+        m_BoundingBox = Math::AABB(m_StartBox, m_EndBox);
+    }
+}
+
+uint32_t LinearBVH::Flatten(const std::vector<BVHBuildNode>& buildNodes, const MotionBuildBounds* motion, const uint32_t buildNodeIndex)
+{
+    const auto& buildNode = buildNodes[buildNodeIndex];
+    const auto  nodeIndex = static_cast<uint32_t>(m_Nodes.size());
+    m_Nodes.emplace_back();
+    if(motion)
+    {
+        const Math::AABB& start      = motion->NodeStart[buildNodeIndex];
+        const Math::AABB& end        = motion->NodeEnd[buildNodeIndex];
+        auto&             node       = m_Nodes[nodeIndex];
+        auto&             nodeMotion = m_NodeMotions.emplace_back();
+        for(int axis = 0; axis < 3; axis++)
+        {
+            FloatMotionBound(start.AxisInterval(axis).Min, end.AxisInterval(axis).Min, false, node.BoundsMin[axis], nodeMotion.Delta[0][axis]);
+            FloatMotionBound(start.AxisInterval(axis).Max, end.AxisInterval(axis).Max, true, node.BoundsMax[axis], nodeMotion.Delta[1][axis]);
+        }
+    }
+    else
+    {
+        Impl::SetNodeBounds(m_Nodes[nodeIndex], buildNode.Bounds);
+    }
+
+    if(buildNode.IsLeaf())
+    {
+        auto& node          = m_Nodes[nodeIndex];
+        node.Offset         = buildNode.Offset;
+        node.PrimitiveCount = static_cast<uint16_t>(buildNode.PrimitiveCount);
+        return nodeIndex;
+    }
+
+    Flatten(buildNodes, motion, buildNode.Offset);
+    const auto secondChild = Flatten(buildNodes, motion, buildNode.Offset + 1);
+
+    // The SAH may split along any axis. Both splits put the lower half first, so the axis along which the second
+    // child lies furthest ahead of the first one is used to order the traversal.
+    const auto& firstBounds  = buildNodes[buildNode.Offset].Bounds;
+    const auto& secondBounds = buildNodes[buildNode.Offset + 1].Bounds;
+    const auto  separation   = Centroid(secondBounds) - Centroid(firstBounds);
+
+    int axis = 0;
+    if(separation.Y() > separation[axis])
+        axis = 1;
+    if(separation.Z() > separation[axis])
+        axis = 2;
+
+    auto& node          = m_Nodes[nodeIndex];
+    node.Offset         = secondChild;
+    node.PrimitiveCount = 0;
+    node.Axis           = static_cast<uint8_t>(axis);
+
+    return nodeIndex;
+}
+
+bool LinearBVH::Hit(const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord& rec) const
+{
+    return m_NodeMotions.empty() ? Traverse<false, false>(ray, rayT, &rec) : Traverse<true, false>(ray, rayT, &rec);
+}
+
+bool LinearBVH::Occluded(const Render::Ray& ray, const Math::Interval rayT) const
+{
+    return m_NodeMotions.empty() ? Traverse<false, true>(ray, rayT, nullptr) : Traverse<true, true>(ray, rayT, nullptr);
+}
+
+template <bool Motion, bool AnyHit>
+bool LinearBVH::Traverse(const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord* rec) const
+{
+    if(m_Nodes.empty())
+        return false;
+
+    const auto& rayOrigin    = ray.Origin();
+    const auto& rayDirection = ray.Direction();
+
+    const float origin[3]       = {static_cast<float>(rayOrigin[0]), static_cast<float>(rayOrigin[1]), static_cast<float>(rayOrigin[2])};
+    const float invDirection[3] = {static_cast<float>(1.0 / rayDirection[0]), static_cast<float>(1.0 / rayDirection[1]), static_cast<float>(1.0 / rayDirection[2])};
+    const bool  dirIsNeg[3]     = {invDirection[0] < 0, invDirection[1] < 0, invDirection[2] < 0};
+    const auto  tMin            = static_cast<float>(rayT.Min);
+    const auto  time            = static_cast<float>(ray.Time());
+
+    bool       hitAnything  = false;
+    Math::Real closestSoFar = rayT.Max;
+
+    uint32_t stack[64];
+    int      stackSize    = 0;
+    uint32_t currentIndex = 0;
+
+    while(true)
+    {
+        const LinearBVHNode& node = m_Nodes[currentIndex];
+
+        bool hitNode;
+        if constexpr(Motion)
+        {
+            // Bounds of the node at the time of the ray
+            const LinearBVHNodeMotion& nodeMotion = m_NodeMotions[currentIndex];
+
+            float boundsMin[3];
+            float boundsMax[3];
+            for(int axis = 0; axis < 3; axis++)
+            {
+                boundsMin[axis] = node.BoundsMin[axis] + time * nodeMotion.Delta[0][axis];
+                boundsMax[axis] = node.BoundsMax[axis] + time * nodeMotion.Delta[1][axis];
+            }
+            hitNode = Impl::IntersectNode(boundsMin, boundsMax, origin, invDirection, tMin, static_cast<float>(closestSoFar) * SlabErrorScale);
+        }
+        else
+        {
+            hitNode = Impl::IntersectNode(node.BoundsMin, node.BoundsMax, origin, invDirection, tMin, static_cast<float>(closestSoFar) * SlabErrorScale);
+        }
+
+        if(hitNode)
+        {
+            if(node.PrimitiveCount > 0)
+            {
+                for(uint32_t i = 0; i < node.PrimitiveCount; i++)
+                {
+                    if constexpr(AnyHit)
+                    {
+                        if(m_PrimitivePtrs[node.Offset + i]->Occluded(ray, rayT))
+                            return true;
+                    }
+                    else if(m_PrimitivePtrs[node.Offset + i]->Hit(ray, Math::Interval(rayT.Min, closestSoFar), *rec))
+                    {
+                        hitAnything  = true;
+                        closestSoFar = rec->T;
+                    }
+                }
+            }
+            else
+            {
+                // Visit the child closer to the ray origin first, so the far one is more likely to be culled.
+                if(dirIsNeg[node.Axis])
+                {
+                    stack[stackSize++] = currentIndex + 1;
+                    currentIndex       = node.Offset;
+                }
+                else
+                {
+                    stack[stackSize++] = node.Offset;
+                    currentIndex       = currentIndex + 1;
+                }
+                continue;
+            }
+        }
+
+        if(stackSize == 0)
+            break;
+        currentIndex = stack[--stackSize];
+    }
+
+    return hitAnything;
+}
+
+Math::AABB LinearBVH::BoundingBox() const
+{
+    return m_BoundingBox;
+}
+
+bool LinearBVH::MotionBounds(Math::AABB& start, Math::AABB& end) const
+{
+    if(m_NodeMotions.empty())
+        return false;
+
+    start = m_StartBox;
+    end   = m_EndBox;
+    return true;
+}
+
+// Scenes assign ids before compiling the world, this covers prebuilt trees placed by instances.
+void LinearBVH::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    for(const auto& primitive : m_Primitives)
+    {
+        primitive->AssignIds(materials, nextPrimitiveId);
+    }
+}
+
+}    // namespace Objects
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "BVHBuild.h"
+#include "Hittable.h"
+#include "HittableList.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Objects
+{
+
+// Node of the flattened BVH. Nodes are stored in depth-first order, so the first child of an interior node
+// always follows its parent directly and only the offset of the second child has to be stored.
+struct alignas(32) LinearBVHNode
+{
+    float    BoundsMin[3];
+    float    BoundsMax[3];
+    uint32_t Offset;            // Leaf: index of the first primitive. Interior: index of the second child.
+    uint16_t PrimitiveCount;    // Zero for interior nodes
+    uint8_t  Axis;              // Split axis of interior nodes
+    uint8_t  Pad;
+};
+
+static_assert(sizeof(LinearBVHNode) == 32, "LinearBVHNode must fit into half of a cache line");
+
+// Motion of the bounds of a LinearBVHNode, the bounds at time t are BoundsMin/BoundsMax + t * Delta.
+struct LinearBVHNodeMotion
+{
+    float Delta[2][3];    // [min, max][axis]
+};
+
+// Compiled, pointer-free BVH: one contiguous array of nodes with float bounds, traversed with an explicit stack.
+// Trees over moving primitives also store the motion of every node, see WideBVH.
+class LinearBVH final : public Hittable
+{
+public:
+    explicit LinearBVH(const HittableList& list, const BVHBuildOptions& options = {});
+    explicit LinearBVH(const std::vector<std::shared_ptr<Hittable>>& srcObjects, const BVHBuildOptions& options = {});
+
+    bool       Hit(const Render::Ray& ray, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool       Occluded(const Render::Ray& ray, Math::Interval rayT) const override;
+    Math::AABB BoundingBox() const override;
+    bool       MotionBounds(Math::AABB& start, Math::AABB& end) const override;
+    void       AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
+
+    size_t NodeCount() const { return m_Nodes.size(); }
+    size_t PrimitiveCount() const { return m_Primitives.size(); }
+
+    const BVHBuildStats& Stats() const { return m_Stats; }
+
+    // Expands nested lists and BVH nodes, so that the flattened tree is built over the leaf primitives only. Sphere
+    // sets larger than one block are replaced by their clusters.
+    static void CollectPrimitives(const std::shared_ptr<Hittable>& object, std::vector<std::shared_ptr<Hittable>>& primitives);
+
+private:
+    std::vector<LinearBVHNode>             m_Nodes;
+    std::vector<LinearBVHNodeMotion>       m_NodeMotions;    // Empty if nothing moves
+    std::vector<std::shared_ptr<Hittable>> m_Primitives;       // Keeps the primitives alive, ordered as referenced by leaves
+    std::vector<const Hittable*>           m_PrimitivePtrs;    // Raw pointers used during traversal
+    Math::AABB                             m_BoundingBox;
+    Math::AABB                             m_StartBox;    // Bounds at time 0 and time 1 of trees over moving primitives
+    Math::AABB                             m_EndBox;
+    BVHBuildStats                          m_Stats;
+
+    void     Build(BVHBuilder& builder, const std::vector<std::shared_ptr<Hittable>>& primitives);
+    uint32_t Flatten(const std::vector<BVHBuildNode>& buildNodes, const MotionBuildBounds* motion, uint32_t buildNodeIndex);
+
+    // Closest hit, or with AnyHit the first hit found, which ends the traversal and fills no record.
+    template <bool Motion, bool AnyHit>
+    bool Traverse(const Render::Ray& ray, Math::Interval rayT, Render::HitRecord* rec) const;
+};
+
+}    // namespace Objects
@@ -0,0 +1,173 @@
+#include "ModelLoader.h"
+
+#include <Render/DiffuseLight.h>
+#include <Render/ImageTexture.h>
+#include <Render/Lambertian.h>
+#include <Utils/Log.h>
+
+#include <tiny_obj_loader.h>
+
+#include <chrono>
+#include <filesystem>
+#include <unordered_map>
+
+namespace Objects
+{
+
+namespace Impl
+{
+
+    // Corner of an OBJ face, which indexes positions, normals and texture coordinates separately. Corners with the same
+    // three indices become one vertex of the mesh.
+    struct ObjCorner
+    {
+        int Position;
+        int Normal;
+        int TexCoord;
+
+        bool operator==(const ObjCorner&) const = default;
+    };
+
+    struct ObjCornerHash
+    {
+        size_t operator()(const ObjCorner& corner) const noexcept
+        {
+            const auto hash = static_cast<uint64_t>(static_cast<uint32_t>(corner.Position)) * 0x9E3779B97F4A7C15ull
+                            ^ static_cast<uint64_t>(static_cast<uint32_t>(corner.Normal)) * 0xC2B2AE3D27D4EB4Full
+                            ^ static_cast<uint64_t>(static_cast<uint32_t>(corner.TexCoord)) * 0x165667B19E3779F9ull;
+            return static_cast<size_t>(hash ^ (hash >> 32));
+        }
+    };
+
+    std::shared_ptr<Render::Material> ConvertMaterial(const tinyobj::material_t& material, const std::filesystem::path& materialPath)
+    {
+        const Render::Color3 emission(material.emission[0], material.emission[1], material.emission[2]);
+        if(emission.X() > 0 || emission.Y() > 0 || emission.Z() > 0)
+        {
+            return std::make_shared<Render::DiffuseLight>(emission);
+        }
+
+        if(!material.diffuse_texname.empty())
+        {
+            const auto texturePath = (materialPath / material.diffuse_texname).string();
+            return std::make_shared<Render::Lambertian>(std::make_shared<Render::ImageTexture>(texturePath));
+        }
+
+        return std::make_shared<Render::Lambertian>(Render::Color3(material.diffuse[0], material.diffuse[1], material.diffuse[2]));
+    }
+
+}    // namespace Impl
+
+TriangleMeshData LoadModel(const std::string& filename)
+{
+    LOG_INFO("Loading model '{}'", filename);
+
+    const auto                  timer        = std::chrono::high_resolution_clock::now();
+    const std::filesystem::path materialPath = std::filesystem::path(filename).parent_path();
+
+    TriangleMeshData   data;
+    tinyobj::ObjReader objReader;
+
+    if(!objReader.ParseFromFile(filename))
+    {
+        LOG_ERROR("Failed to load model '{}': {}", filename, objReader.Error());
+        return data;
+    }
+
+    if(!objReader.Warning().empty())
+    {
+        LOG_WARN("{}", objReader.Warning());
+    }
+
+    // Materials
+    for(const auto& material : objReader.GetMaterials())
+    {
+        data.Materials.emplace_back(Impl::ConvertMaterial(material, materialPath));
+    }
+
+    if(data.Materials.empty())
+    {
+        data.Materials.emplace_back(std::make_shared<Render::Lambertian>(Render::Color3(0.7, 0.7, 0.7)));
+    }
+
+    // Geometry, the reader triangulates all faces
+    const auto& objAttrib    = objReader.GetAttrib();
+    const bool  hasNormals   = !objAttrib.normals.empty();
+    const bool  hasTexCoords = !objAttrib.texcoords.empty();
+
+    std::unordered_map<Impl::ObjCorner, uint32_t, Impl::ObjCornerHash> uniqueCorners(objAttrib.vertices.size() / 3);
+
+    for(const auto& shape : objReader.GetShapes())
+    {
+        const auto& mesh = shape.mesh;
+
+        for(size_t face = 0; face < mesh.indices.size() / 3; face++)
+        {
+            for(size_t corner = 0; corner < 3; corner++)
+            {
+                const tinyobj::index_t& index = mesh.indices[3 * face + corner];
+
+                const auto [it, inserted] = uniqueCorners.try_emplace({index.vertex_index, index.normal_index, index.texcoord_index}, static_cast<uint32_t>(data.Positions.size()));
+                if(inserted)
+                {
+                    data.Positions.emplace_back(objAttrib.vertices[3 * index.vertex_index + 0],
+                                                objAttrib.vertices[3 * index.vertex_index + 1],
+                                                objAttrib.vertices[3 * index.vertex_index + 2]);
+
+                    // Corners without normal get a zero one and are shaded flat.
+                    if(hasNormals)
+                    {
+                        data.Normals.emplace_back(index.normal_index < 0 ? Math::Vector3() : Math::Vector3(objAttrib.normals[3 * index.normal_index + 0], objAttrib.normals[3 * index.normal_index + 1], objAttrib.normals[3 * index.normal_index + 2]));
+                    }
+
+                    if(hasTexCoords)
+                    {
+                        data.TexCoords.emplace_back(index.texcoord_index < 0 ? 0 : objAttrib.texcoords[2 * index.texcoord_index + 0]);
+                        data.TexCoords.emplace_back(index.texcoord_index < 0 ? 0 : objAttrib.texcoords[2 * index.texcoord_index + 1]);
+                    }
+                }
+
+                data.Indices.emplace_back(it->second);
+            }
+
+            const int materialId = face < mesh.material_ids.size() ? mesh.material_ids[face] : -1;
+            data.MaterialIds.emplace_back(materialId >= 0 && materialId < static_cast<int>(data.Materials.size()) ? materialId : 0);
+        }
+    }
+
+    // Like the GPU loader, models without normals get smooth ones, averaged over the faces around each vertex.
+    if(!hasNormals)
+    {
+        data.Normals.assign(data.Positions.size(), Math::Vector3());
+
+        for(size_t i = 0; i < data.Indices.size(); i += 3)
+        {
+            const Math::Point3& p0     = data.Positions[data.Indices[i + 0]];
+            const Math::Point3& p1     = data.Positions[data.Indices[i + 1]];
+            const Math::Point3& p2     = data.Positions[data.Indices[i + 2]];
+            const Math::Vector3 normal = CrossProduct(p1 - p0, p2 - p0);
+            if(normal.LengthSquared() == 0)
+                continue;
+
+            for(size_t corner = 0; corner < 3; corner++)
+            {
+                data.Normals[data.Indices[i + corner]] += UnitVector(normal);
+            }
+        }
+
+        for(auto& normal : data.Normals)
+        {
+            if(normal.LengthSquared() > 0)
+                normal = UnitVector(normal);
+        }
+    }
+
+    const auto elapsed   = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - timer).count();
+    const auto modelName = std::filesystem::path(filename).filename().string();
+    LOG_INFO("Model: '{}' (triangles: {}, unique vertices: {}, materials: {})", modelName, data.TriangleCount(), data.Positions.size(), data.Materials.size());
+    LOG_INFO("Model: '{}' loaded in {:.2f} seconds", modelName, elapsed);
+
+    return data;
+}
+
+}    // namespace Objects
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "TriangleMesh.h"
+
+#include <string>
+
+namespace Objects
+{
+
+// Loads a Wavefront OBJ model with tinyobjloader. Polygons are triangulated, the MTL materials become Lambertian or
+// DiffuseLight materials, and models without normals get smooth vertex normals. The result is empty if the file
+// can't be read.
+TriangleMeshData LoadModel(const std::string& filename);
+
+}    // namespace Objects
@@ -1,6 +1,10 @@
 #include "Quad.h"
 
+#include "HittableList.h"
+
 #include <Render/HitRecord.h>
+#include <Render/Material.h>
+#include <Render/MaterialTable.h>
 
 namespace Objects
 {
@@ -16,6 +20,7 @@ Quad::Quad(const Math::Point3& q, const Math::Vector3& u, const Math::Vector3& v
     m_D          = DotProduct(m_Normal, m_Q);
     m_W          = n / DotProduct(n, n);
     m_Area       = n.Length();
+    m_PError     = Math::Gamma(7) * (Math::MaxAbsComponent(m_Q) + Math::MaxAbsComponent(m_U) + Math::MaxAbsComponent(m_V));
 
     SetBoundingBox();
 }
@@ -33,6 +38,36 @@ Math::AABB Quad::BoundingBox() const
 }
 
 bool Quad::Hit(const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord& rec) const
+{
+    Math::Real t;
+    Math::Real alpha;
+    Math::Real beta;
+    if(!Intersect(ray, rayT, t, alpha, beta))
+        return false;
+
+    // Ray hits the 2D shape; set the rest of the hit record and return true.
+    // The point rebuilt from the plane coordinates lies on the plane up to the rounding of a few operations.
+    rec.T             = t;
+    rec.P             = m_Q + alpha * m_U + beta * m_V;
+    rec.PError        = m_PError;
+    rec.U             = alpha;
+    rec.V             = beta;
+    rec.MaterialIndex = m_MaterialIndex;
+    rec.PrimitiveId   = m_PrimitiveId;
+    rec.SetFaceNormal(ray, m_Normal);
+
+    return true;
+}
+
+bool Quad::Occluded(const Render::Ray& ray, const Math::Interval rayT) const
+{
+    Math::Real t;
+    Math::Real alpha;
+    Math::Real beta;
+    return Intersect(ray, rayT, t, alpha, beta);
+}
+
+bool Quad::Intersect(const Render::Ray& ray, const Math::Interval rayT, Math::Real& t, Math::Real& alpha, Math::Real& beta) const
 {
     const auto denom = DotProduct(m_Normal, ray.Direction());
 
@@ -41,49 +76,38 @@ bool Quad::Hit(const Render::Ray& ray, const Math::Interval rayT, Render::HitRec
         return false;
 
     // Return false if the hit point parameter t is outside the ray interval.
-    const auto t = (m_D - DotProduct(m_Normal, ray.Origin())) / denom;
-    if(!rayT.Contains(t))
+    t = (m_D - DotProduct(m_Normal, ray.Origin())) / denom;
+    if(!rayT.Surrounds(t))
         return false;
 
     // Determine the hit point lies within the planar shape using its plane coordinates.
     const auto          intersection      = ray.At(t);
     const Math::Vector3 planarHitptVector = intersection - m_Q;
-    const auto          alpha             = DotProduct(m_W, CrossProduct(planarHitptVector, m_V));
-    const auto          beta              = DotProduct(m_W, CrossProduct(m_U, planarHitptVector));
-
-    if(!IsInterior(alpha, beta, rec))
-        return false;
 
-    // Ray hits the 2D shape; set the rest of the hit record and return true.
-    rec.T = t;
-    rec.P = intersection;
-    rec.SetMaterial(m_Material);
-    rec.SetFaceNormal(ray, m_Normal);
+    alpha = DotProduct(m_W, CrossProduct(planarHitptVector, m_V));
+    beta  = DotProduct(m_W, CrossProduct(m_U, planarHitptVector));
 
-    return true;
+    return IsInterior(alpha, beta);
 }
 
-// Given the hit point in plane coordinates, return false if it is outside the
-// primitive, otherwise set the hit record UV coordinates and return true.
-bool Quad::IsInterior(const double a, const double b, Render::HitRecord& rec) const
+// Given the hit point in plane coordinates, return false if it is outside the primitive.
+bool Quad::IsInterior(const Math::Real a, const Math::Real b)
 {
-    if((a < 0) || (1 < a) || (b < 0) || (1 < b))
-        return false;
-
-    rec.U = a;
-    rec.V = b;
-    return true;
+    return !((a < 0) || (1 < a) || (b < 0) || (1 < b));
 }
 
-double Quad::PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const
+// Only the distance is needed, so the quad is intersected without filling a hit record.
+Math::Real Quad::PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const
 {
-    Render::HitRecord rec;
-    if(!this->Hit(Render::Ray(origin, direction), Math::Interval(0.001, Math::Infinity), rec))
+    Math::Real t;
+    Math::Real alpha;
+    Math::Real beta;
+    if(!Intersect(Render::Ray(origin, direction), Math::Interval(0, Math::Infinity), t, alpha, beta))
         return 0;
 
-    const auto distanceSquared = rec.T * rec.T * direction.LengthSquared();
+    const auto distanceSquared = t * t * direction.LengthSquared();
 
-    const auto cosine = std::fabs(DotProduct(direction, rec.Normal) / direction.Length());
+    const auto cosine = std::fabs(DotProduct(direction, m_Normal) / direction.Length());
 
     return distanceSquared / (cosine * m_Area);
 }
@@ -94,4 +118,28 @@ Math::Vector3 Quad::Random(const Math::Point3& origin) const
     return p - origin;
 }
 
+// Diffuse lights only emit from the front face, so the cone is the normal itself.
+void Quad::NormalBounds(Math::Vector3& axis, Math::Real& cosTheta) const
+{
+    axis     = m_Normal;
+    cosTheta = 1;
+}
+
+void Quad::CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const
+{
+    const auto&      emitterMaterial = material ? material : m_Material;
+    const Math::Real power           = emitterMaterial ? emitterMaterial->EmittedPower(m_Area, m_Q + m_U / 2 + m_V / 2) : 0;
+    if(power > 0)
+    {
+        emitters.Add(std::make_shared<Quad>(m_Q, m_U, m_V, emitterMaterial));
+        powers.emplace_back(power);
+    }
+}
+
+void Quad::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    m_MaterialIndex = materials.Add(m_Material);
+    m_PrimitiveId   = nextPrimitiveId++;
+}
+
 }    // namespace Objects
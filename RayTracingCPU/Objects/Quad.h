@@ -20,24 +20,34 @@ public:
     void       SetBoundingBox();
     Math::AABB BoundingBox() const override;
     bool       Hit(const Render::Ray& ray, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool       Occluded(const Render::Ray& ray, Math::Interval rayT) const override;
 
-    // Given the hit point in plane coordinates, return false if it is outside the
-    // primitive, otherwise set the hit record UV coordinates and return true.
-    bool IsInterior(double a, double b, Render::HitRecord& rec) const;
+    // Given the hit point in plane coordinates, return false if it is outside the primitive. The plane coordinates
+    // become the UV coordinates of the hit.
+    static bool IsInterior(Math::Real a, Math::Real b);
 
-    double        PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const override;
+    Math::Real    PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const override;
     Math::Vector3 Random(const Math::Point3& origin) const override;
+    void          NormalBounds(Math::Vector3& axis, Math::Real& cosTheta) const override;
+    void          CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const override;
+    void          AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
 
 private:
     Math::Point3                      m_Q;
     Math::Vector3                     m_U;
     Math::Vector3                     m_V;
     std::shared_ptr<Render::Material> m_Material;
+    uint32_t                          m_MaterialIndex = 0;
+    uint32_t                          m_PrimitiveId   = 0;
     Math::AABB                        m_BoundingBox;
     Math::Vector3                     m_Normal;
-    double                            m_D;
+    Math::Real                        m_D;
     Math::Vector3                     m_W;
-    double                            m_Area;
+    Math::Real                        m_Area;
+    Math::Real                        m_PError = 0;    // Bound on the rounding error of the coordinates of hit points
+
+    // Distance and plane coordinates of the hit, without filling a record.
+    bool Intersect(const Render::Ray& ray, Math::Interval rayT, Math::Real& t, Math::Real& alpha, Math::Real& beta) const;
 };
 
 }    // namespace Objects
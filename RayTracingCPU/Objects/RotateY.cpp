@@ -1,13 +1,18 @@
 #include "RotateY.h"
 
+#include "HittableList.h"
+#include "Instance.h"
+
 #include <Math/Converters.h>
+#include <Math/Transform.h>
 #include <Render/HitRecord.h>
 
 namespace Objects
 {
 
-RotateY::RotateY(const std::shared_ptr<Hittable>& object, const double angle)
+RotateY::RotateY(const std::shared_ptr<Hittable>& object, const Math::Real angle)
     : m_Object(object)
+    , m_Angle(angle)
 {
     const auto radians = Math::DegreesToRadians(angle);
     m_SinTheta         = std::sin(radians);
@@ -46,20 +51,8 @@ RotateY::RotateY(const std::shared_ptr<Hittable>& object, const double angle)
 
 bool RotateY::Hit(const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord& rec) const
 {
-    // Change the ray from world space to object space
-    auto origin    = ray.Origin();
-    auto direction = ray.Direction();
-
-    origin[0] = m_CosTheta * ray.Origin()[0] - m_SinTheta * ray.Origin()[2];
-    origin[2] = m_SinTheta * ray.Origin()[0] + m_CosTheta * ray.Origin()[2];
-
-    direction[0] = m_CosTheta * ray.Direction()[0] - m_SinTheta * ray.Direction()[2];
-    direction[2] = m_SinTheta * ray.Direction()[0] + m_CosTheta * ray.Direction()[2];
-
-    const Render::Ray rotatedRay(origin, direction, ray.Time());
-
     // Determine whether an intersection exists in object space (and if so, where)
-    if(!m_Object->Hit(rotatedRay, rayT, rec))
+    if(!m_Object->Hit(ObjectRay(ray), rayT, rec))
         return false;
 
     // Change the intersection point from object space to world space
@@ -67,20 +60,60 @@ bool RotateY::Hit(const Render::Ray& ray, const Math::Interval rayT, Render::Hit
     p[0]   = m_CosTheta * rec.P[0] + m_SinTheta * rec.P[2];
     p[2]   = -m_SinTheta * rec.P[0] + m_CosTheta * rec.P[2];
 
+    // The rotation carries the error of the point along and adds its own rounding
+    const auto pError = (std::fabs(m_CosTheta) + std::fabs(m_SinTheta)) * (rec.PError + Math::Gamma(3) * Math::MaxAbsComponent(rec.P));
+
     // Change the normal from object space to world space
     auto normal = rec.Normal;
     normal[0]   = m_CosTheta * rec.Normal[0] + m_SinTheta * rec.Normal[2];
     normal[2]   = -m_SinTheta * rec.Normal[0] + m_CosTheta * rec.Normal[2];
 
     rec.P      = p;
+    rec.PError = pError;
     rec.Normal = normal;
 
     return true;
 }
 
+bool RotateY::Occluded(const Render::Ray& ray, const Math::Interval rayT) const
+{
+    return m_Object->Occluded(ObjectRay(ray), rayT);
+}
+
 Math::AABB RotateY::BoundingBox() const
 {
     return m_BoundingBox;
 }
 
+void RotateY::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    m_Object->AssignIds(materials, nextPrimitiveId);
+}
+
+// Change the ray from world space to object space
+Render::Ray RotateY::ObjectRay(const Render::Ray& ray) const
+{
+    auto origin    = ray.Origin();
+    auto direction = ray.Direction();
+
+    origin[0] = m_CosTheta * ray.Origin()[0] - m_SinTheta * ray.Origin()[2];
+    origin[2] = m_SinTheta * ray.Origin()[0] + m_CosTheta * ray.Origin()[2];
+
+    direction[0] = m_CosTheta * ray.Direction()[0] - m_SinTheta * ray.Direction()[2];
+    direction[2] = m_SinTheta * ray.Direction()[0] + m_CosTheta * ray.Direction()[2];
+
+    return {origin, direction, ray.Time()};
+}
+
+void RotateY::CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const
+{
+    HittableList objectEmitters;
+    m_Object->CollectEmitters(objectEmitters, powers, material);
+
+    for(const auto& emitter : objectEmitters.Objects)
+    {
+        emitters.Add(std::make_shared<Instance>(emitter, Math::Transform::Rotate(m_Angle, Math::Vector3(0, 1, 0))));
+    }
+}
+
 }    // namespace Objects
@@ -10,15 +10,23 @@ namespace Objects
 class RotateY final : public Hittable
 {
 public:
-    RotateY(const std::shared_ptr<Hittable>& object, double angle);
+    RotateY(const std::shared_ptr<Hittable>& object, Math::Real angle);
     bool       Hit(const Render::Ray& ray, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool       Occluded(const Render::Ray& ray, Math::Interval rayT) const override;
     Math::AABB BoundingBox() const override;
+    void       AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
+
+    // Wraps every emitter of the object in a rotating Instance, which can be sampled as a light.
+    void       CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const override;
 
 private:
     std::shared_ptr<Hittable> m_Object;
-    double                    m_SinTheta;
-    double                    m_CosTheta;
+    Math::Real                m_Angle;
+    Math::Real                m_SinTheta;
+    Math::Real                m_CosTheta;
     Math::AABB                m_BoundingBox;
+
+    Render::Ray ObjectRay(const Render::Ray& ray) const;
 };
 
 }    // namespace Objects
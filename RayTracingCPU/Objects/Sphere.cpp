@@ -1,13 +1,17 @@
 #include "Sphere.h"
 
+#include "HittableList.h"
+
 #include <Math/ONB.h>
 #include <Render/HitRecord.h>
+#include <Render/Material.h>
+#include <Render/MaterialTable.h>
 
 namespace Objects
 {
 
 // Stationary Sphere
-Sphere::Sphere(const Math::Point3& center, const double radius, const std::shared_ptr<Render::Material>& material)
+Sphere::Sphere(const Math::Point3& center, const Math::Real radius, const std::shared_ptr<Render::Material>& material)
     : m_Center(center)
     , m_Radius(radius)
     , m_Material(material)
@@ -15,10 +19,11 @@ Sphere::Sphere(const Math::Point3& center, const double radius, const std::share
 {
     const auto rvec = Math::Vector3(radius, radius, radius);
     m_BoundingBox   = Math::AABB(center - rvec, center + rvec);
+    m_PError        = Math::Gamma(5) * (Math::MaxAbsComponent(center) + std::fabs(radius));
 }
 
 // Moving Sphere
-Sphere::Sphere(const Math::Point3& center, const Math::Point3& center2, const double radius, const std::shared_ptr<Render::Material>& material)
+Sphere::Sphere(const Math::Point3& center, const Math::Point3& center2, const Math::Real radius, const std::shared_ptr<Render::Material>& material)
     : m_Center(center)
     , m_Radius(radius)
     , m_Material(material)
@@ -29,42 +34,74 @@ Sphere::Sphere(const Math::Point3& center, const Math::Point3& center2, const do
     const Math::AABB box2(center2 - rvec, center2 + rvec);
     m_BoundingBox = Math::AABB(box1, box2);
 
-    m_CenterV = center - center2;
+    m_CenterV = center2 - center;
+    m_PError  = Math::Gamma(7) * (Math::MaxAbsComponent(center) + Math::MaxAbsComponent(m_CenterV) + std::fabs(radius));
 }
 
 bool Sphere::Hit(const Render::Ray& r, const Math::Interval rayT, Render::HitRecord& rec) const
 {
-    const Math::Point3  center = m_IsMoving ? SphereCenter(r.Time()) : m_Center;
-    const Math::Vector3 oc     = center - r.Origin();
-    const double        a      = r.Direction().LengthSquared();
-    const double        halfB  = DotProduct(r.Direction(), oc);
-    const double        c      = oc.LengthSquared() - m_Radius * m_Radius;
-
-    const double discriminant = halfB * halfB - a * c;
-    if(discriminant < 0)
+    Math::Point3 center;
+    Math::Real   root;
+    if(!Intersect(r, rayT, center, root))
+        return false;
+
+    // Project the hit point back onto the sphere, its error then only depends on the size and position of the sphere.
+    const Math::Vector3 radial = r.At(root) - center;
+
+    rec.T      = root;
+    rec.P      = center + radial * (std::fabs(m_Radius) / radial.Length());
+    rec.PError = m_PError;
+
+    const Math::Vector3 outwardNormal = (rec.P - center) / m_Radius;
+    rec.SetFaceNormal(r, outwardNormal);
+    GetSphereUV(outwardNormal, rec.U, rec.V);
+
+    rec.MaterialIndex = m_MaterialIndex;
+    rec.PrimitiveId   = m_PrimitiveId;
+
+    return true;
+}
+
+bool Sphere::Occluded(const Render::Ray& r, const Math::Interval rayT) const
+{
+    Math::Point3 center;
+    Math::Real   root;
+    return Intersect(r, rayT, center, root);
+}
+
+bool Sphere::Intersect(const Render::Ray& r, const Math::Interval rayT, Math::Point3& center, Math::Real& root) const
+{
+    center = m_IsMoving ? SphereCenter(r.Time()) : m_Center;
+
+    const Math::Vector3 oc    = center - r.Origin();
+    const Math::Real    a     = r.Direction().LengthSquared();
+    const Math::Real    halfB = DotProduct(r.Direction(), oc);
+    const Math::Real    c     = oc.LengthSquared() - m_Radius * m_Radius;
+
+    // Built from the offset of the center from the ray line, which loses less precision than halfB^2 - ac for small
+    // spheres far away, see Ray Tracing Gems chapter 7. Scaled by a, so misses are rejected without a division.
+    const Math::Vector3 l             = a * oc - halfB * r.Direction();
+    const Math::Real    aDiscriminant = a * a * m_Radius * m_Radius - l.LengthSquared();
+    if(aDiscriminant < 0)
     {
         return false;
     }
-    const auto sqrtd = sqrt(discriminant);
+    const auto sqrtd = sqrt(aDiscriminant / a);
+
+    // Roots without cancellation, so hits next to the ray origin keep their sign.
+    const Math::Real q     = halfB + std::copysign(sqrtd, halfB);
+    const Math::Real root0 = c / q;
+    const Math::Real root1 = q / a;
 
     // Find the nearest root that lies in the acceptable range.
-    double root = (halfB - sqrtd) / a;
+    root = std::min(root0, root1);
     if(!rayT.Surrounds(root))
     {
-        root = (halfB + sqrtd) / a;
+        root = std::max(root0, root1);
         if(!rayT.Surrounds(root))
             return false;
     }
 
-    rec.T = root;
-    rec.P = r.At(rec.T);
-
-    const Math::Vector3 outwardNormal = (rec.P - m_Center) / m_Radius;
-    rec.SetFaceNormal(r, outwardNormal);
-    GetSphereUV(outwardNormal, rec.U, rec.V);
-
-    rec.SetMaterial(m_Material);
-
     return true;
 }
 
@@ -73,11 +110,21 @@ Math::AABB Sphere::BoundingBox() const
     return m_BoundingBox;
 }
 
+bool Sphere::MotionBounds(Math::AABB& start, Math::AABB& end) const
+{
+    if(!m_IsMoving)
+        return false;
+
+    const auto rvec = Math::Vector3(m_Radius, m_Radius, m_Radius);
+    start           = Math::AABB(m_Center - rvec, m_Center + rvec);
+    end             = Math::AABB(m_Center + m_CenterV - rvec, m_Center + m_CenterV + rvec);
+    return true;
+}
+
 // This method only works for stationary spheres.
-double Sphere::PDFValue(const Math::Point3& o, const Math::Vector3& v) const
+Math::Real Sphere::PDFValue(const Math::Point3& o, const Math::Vector3& v) const
 {
-    Render::HitRecord rec;
-    if(!this->Hit(Render::Ray(o, v), Math::Interval(0.001, Math::Infinity), rec))
+    if(!Occluded(Render::Ray(o, v), Math::Interval(0, Math::Infinity)))
         return 0;
 
     const auto cosThetaMax = sqrt(1 - m_Radius * m_Radius / (m_Center - o).LengthSquared());
@@ -95,9 +142,26 @@ Math::Vector3 Sphere::Random(const Math::Point3& o) const
     return uvw.Local(RandomToSphere(m_Radius, distanceSquared));
 }
 
+void Sphere::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    m_MaterialIndex = materials.Add(m_Material);
+    m_PrimitiveId   = nextPrimitiveId++;
+}
+
+void Sphere::CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const
+{
+    const auto&      emitterMaterial = material ? material : m_Material;
+    const Math::Real power           = emitterMaterial ? emitterMaterial->EmittedPower(4 * Math::Pi * m_Radius * m_Radius, m_Center) : 0;
+    if(power > 0)
+    {
+        emitters.Add(m_IsMoving ? std::make_shared<Sphere>(m_Center, m_Center + m_CenterV, m_Radius, emitterMaterial) : std::make_shared<Sphere>(m_Center, m_Radius, emitterMaterial));
+        powers.emplace_back(power);
+    }
+}
+
 // Linearly interpolate from center1 to center2 according to time.
 // Where t=0 yields center1, and t=1 yields center2.
-Math::Point3 Sphere::SphereCenter(const double time) const
+Math::Point3 Sphere::SphereCenter(const Math::Real time) const
 {
     return m_Center + time * m_CenterV;
 }
@@ -108,7 +172,7 @@ Math::Point3 Sphere::SphereCenter(const double time) const
 //     <1 0 0> yields <0.50 0.50>       <-1  0  0> yields <0.00 0.50>
 //     <0 1 0> yields <0.50 1.00>       < 0 -1  0> yields <0.50 0.00>
 //     <0 0 1> yields <0.25 0.50>       < 0  0 -1> yields <0.75 0.50>
-void Sphere::GetSphereUV(const Math::Point3& p, double& u, double& v)
+void Sphere::GetSphereUV(const Math::Point3& p, Math::Real& u, Math::Real& v)
 {
     const auto theta = acos(-p.Y());
     const auto phi   = atan2(-p.Z(), p.X()) + Math::Pi;
@@ -117,15 +181,15 @@ void Sphere::GetSphereUV(const Math::Point3& p, double& u, double& v)
     v = theta / Math::Pi;
 }
 
-Math::Vector3 Sphere::RandomToSphere(const double radius, const double distanceSquared)
+Math::Vector3 Sphere::RandomToSphere(const Math::Real radius, const Math::Real distanceSquared)
 {
-    const auto r1 = Utils::Random::Double();
-    const auto r2 = Utils::Random::Double();
-    auto       z  = 1 + r2 * (sqrt(1 - radius * radius / distanceSquared) - 1);
+    const Math::Real r1 = Utils::Random::Double();
+    const Math::Real r2 = Utils::Random::Double();
+    const Math::Real z  = 1 + r2 * (std::sqrt(1 - radius * radius / distanceSquared) - 1);
 
-    const auto phi = 2 * Math::Pi * r1;
-    auto       x   = cos(phi) * sqrt(1 - z * z);
-    auto       y   = sin(phi) * sqrt(1 - z * z);
+    const Math::Real phi = 2 * Math::Pi * r1;
+    const Math::Real x   = std::cos(phi) * std::sqrt(1 - z * z);
+    const Math::Real y   = std::sin(phi) * std::sqrt(1 - z * z);
 
     return {x, y, z};
 }
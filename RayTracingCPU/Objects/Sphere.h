@@ -16,41 +16,52 @@ class Sphere final : public Hittable
 {
 public:
     // Stationary Sphere
-    Sphere(const Math::Point3& center, double radius, const std::shared_ptr<Render::Material>& material);
+    Sphere(const Math::Point3& center, Math::Real radius, const std::shared_ptr<Render::Material>& material);
 
     // Moving Sphere
-    Sphere(const Math::Point3& center, const Math::Point3& center2, double radius, const std::shared_ptr<Render::Material>& material);
+    Sphere(const Math::Point3& center, const Math::Point3& center2, Math::Real radius, const std::shared_ptr<Render::Material>& material);
 
     bool Hit(const Render::Ray& r, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool Occluded(const Render::Ray& r, Math::Interval rayT) const override;
 
     Math::AABB BoundingBox() const override;
+    bool       MotionBounds(Math::AABB& start, Math::AABB& end) const override;
 
     // This method only works for stationary spheres.
-    double PDFValue(const Math::Point3& o, const Math::Vector3& v) const override;
+    Math::Real PDFValue(const Math::Point3& o, const Math::Vector3& v) const override;
 
     Math::Vector3 Random(const Math::Point3& o) const override;
 
+    void AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
+    void CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const override;
+
+    // p: a given point on the sphere of radius one, centered at the origin.
+    // u: returned value [0,1] of angle around the Y axis from X=-1.
+    // v: returned value [0,1] of angle from Y=-1 to Y=+1.
+    //     <1 0 0> yields <0.50 0.50>       <-1  0  0> yields <0.00 0.50>
+    //     <0 1 0> yields <0.50 1.00>       < 0 -1  0> yields <0.50 0.00>
+    //     <0 0 1> yields <0.25 0.50>       < 0  0 -1> yields <0.75 0.50>
+    static void GetSphereUV(const Math::Point3& p, Math::Real& u, Math::Real& v);
+
 private:
     Math::Point3                      m_Center;
     Math::Vector3                     m_CenterV;
-    double                            m_Radius;
+    Math::Real                        m_Radius;
+    Math::Real                        m_PError = 0;    // Bound on the rounding error of the coordinates of hit points
     std::shared_ptr<Render::Material> m_Material;
+    uint32_t                          m_MaterialIndex = 0;
+    uint32_t                          m_PrimitiveId   = 0;
     bool                              m_IsMoving;
     Math::AABB                        m_BoundingBox;
 
     // Linearly interpolate from center1 to center2 according to time.
     // Where t=0 yields center1, and t=1 yields center2.
-    Math::Point3 SphereCenter(double time) const;
+    Math::Point3 SphereCenter(Math::Real time) const;
 
-    // p: a given point on the sphere of radius one, centered at the origin.
-    // u: returned value [0,1] of angle around the Y axis from X=-1.
-    // v: returned value [0,1] of angle from Y=-1 to Y=+1.
-    //     <1 0 0> yields <0.50 0.50>       <-1  0  0> yields <0.00 0.50>
-    //     <0 1 0> yields <0.50 1.00>       < 0 -1  0> yields <0.50 0.00>
-    //     <0 0 1> yields <0.25 0.50>       < 0  0 -1> yields <0.75 0.50>
-    static void GetSphereUV(const Math::Point3& p, double& u, double& v);
+    // Nearest root inside rayT and the center of the sphere at the time of the ray.
+    bool Intersect(const Render::Ray& r, Math::Interval rayT, Math::Point3& center, Math::Real& root) const;
 
-    static Math::Vector3 RandomToSphere(double radius, double distanceSquared);
+    static Math::Vector3 RandomToSphere(Math::Real radius, Math::Real distanceSquared);
 };
 
 }    // namespace Objects
@@ -0,0 +1,364 @@
+#include "SphereSet.h"
+
+#include "BVHBuild.h"
+#include "Sphere.h"
+
+#include <Math/SIMD.h>
+#include <Render/HitRecord.h>
+#include <Render/Material.h>
+#include <Render/MaterialTable.h>
+#include <Utils/CPUFeatures.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace Objects
+{
+
+namespace Impl
+{
+
+    // Same steps as Sphere::Hit, for all spheres of the block. Returns a bit mask of the spheres hit inside
+    // (tMin, tMax) and stores the distance of the nearest accepted root of each.
+    template <typename Lanes>
+    uint32_t IntersectBlock(const SphereBlock& block, const Render::Ray& ray, const Math::Real tMin, const Math::Real tMax, Math::Real t[SphereBlock::LaneCount])
+    {
+        using Type = typename Lanes::Type;
+
+        const Math::Real a     = ray.Direction().LengthSquared();
+        const Type       aLane = Lanes::Set(a);
+        const Type       aa    = Lanes::Set(a * a);
+        const Type       time  = Lanes::Set(ray.Time());
+        const Type       zero  = Lanes::Set(0);
+        const Type       tLow  = Lanes::Set(tMin);
+        const Type       tHigh = Lanes::Set(tMax);
+
+        Type origin[3];
+        Type direction[3];
+        for(int axis = 0; axis < 3; axis++)
+        {
+            origin[axis]    = Lanes::Set(ray.Origin()[axis]);
+            direction[axis] = Lanes::Set(ray.Direction()[axis]);
+        }
+
+        uint32_t mask = 0;
+        for(int group = 0; group < SphereBlock::LaneCount; group += Lanes::Size)
+        {
+            Type oc[3];
+            for(int axis = 0; axis < 3; axis++)
+            {
+                const Type center = Lanes::Add(Lanes::Load(&block.Center[axis][group]), Lanes::Mul(time, Lanes::Load(&block.Motion[axis][group])));
+                oc[axis]          = Lanes::Sub(center, origin[axis]);
+            }
+
+            const Type radius          = Lanes::Load(&block.Radius[group]);
+            const Type halfB           = Lanes::Add(Lanes::Add(Lanes::Mul(direction[0], oc[0]), Lanes::Mul(direction[1], oc[1])), Lanes::Mul(direction[2], oc[2]));
+            const Type ocLengthSquared = Lanes::Add(Lanes::Add(Lanes::Mul(oc[0], oc[0]), Lanes::Mul(oc[1], oc[1])), Lanes::Mul(oc[2], oc[2]));
+            const Type c               = Lanes::Sub(ocLengthSquared, Lanes::Mul(radius, radius));
+
+            Type l[3];
+            for(int axis = 0; axis < 3; axis++)
+            {
+                l[axis] = Lanes::Sub(Lanes::Mul(aLane, oc[axis]), Lanes::Mul(halfB, direction[axis]));
+            }
+            const Type lLengthSquared = Lanes::Add(Lanes::Add(Lanes::Mul(l[0], l[0]), Lanes::Mul(l[1], l[1])), Lanes::Mul(l[2], l[2]));
+            const Type aDiscriminant  = Lanes::Sub(Lanes::Mul(Lanes::Mul(aa, radius), radius), lLengthSquared);
+
+            // Most rays miss all spheres of a group, the divisions are only paid for groups with a candidate.
+            const auto candidates = Lanes::GreaterEqual(aDiscriminant, zero);
+            if(Lanes::MoveMask(candidates) == 0)
+                continue;
+
+            // Missed lanes are clamped, so the square root never sees a negative number.
+            const Type sqrtd    = Lanes::Sqrt(Lanes::Div(Lanes::Max(aDiscriminant, zero), aLane));
+            const Type q        = Lanes::Add(halfB, Lanes::CopySign(sqrtd, halfB));
+            const Type root0    = Lanes::Div(c, q);
+            const Type root1    = Lanes::Div(q, aLane);
+            const Type rootNear = Lanes::Min(root0, root1);
+            const Type rootFar  = Lanes::Max(root0, root1);
+
+            const auto nearInside = Lanes::And(Lanes::Less(tLow, rootNear), Lanes::Less(rootNear, tHigh));
+            const auto farInside  = Lanes::And(Lanes::Less(tLow, rootFar), Lanes::Less(rootFar, tHigh));
+            const auto hit        = Lanes::And(candidates, Lanes::Or(nearInside, farInside));
+
+            Lanes::Store(&t[group], Lanes::Select(nearInside, rootNear, rootFar));
+            mask |= Lanes::MoveMask(hit) << group;
+        }
+        return mask;
+    }
+
+    template <typename Lanes>
+    bool IntersectSpheres(const SphereBlock* blocks, const size_t count, const Render::Ray& ray, const Math::Real tMin, Math::Real& closestSoFar, uint32_t& index)
+    {
+        bool hitAnything = false;
+        for(size_t block = 0; block < count; block++)
+        {
+            alignas(32) Math::Real t[SphereBlock::LaneCount];
+            for(uint32_t mask = IntersectBlock<Lanes>(blocks[block], ray, tMin, closestSoFar, t); mask != 0; mask &= mask - 1)
+            {
+                const int lane = std::countr_zero(mask);
+                if(t[lane] < closestSoFar)
+                {
+                    hitAnything  = true;
+                    closestSoFar = t[lane];
+                    index        = static_cast<uint32_t>(block * SphereBlock::LaneCount + lane);
+                }
+            }
+        }
+        return hitAnything;
+    }
+
+    template <typename Lanes>
+    bool AnySphere(const SphereBlock* blocks, const size_t count, const Render::Ray& ray, const Math::Real tMin, const Math::Real tMax)
+    {
+        for(size_t block = 0; block < count; block++)
+        {
+            alignas(32) Math::Real t[SphereBlock::LaneCount];
+            if(IntersectBlock<Lanes>(blocks[block], ray, tMin, tMax, t) != 0)
+                return true;
+        }
+        return false;
+    }
+
+#if RT_ARCH_X86
+    RT_TARGET_AVX2 RT_FLATTEN bool IntersectSpheresAVX2(const SphereBlock* blocks, const size_t count, const Render::Ray& ray, const Math::Real tMin, Math::Real& closestSoFar, uint32_t& index)
+    {
+        return IntersectSpheres<Math::SIMD::AVX2Lanes>(blocks, count, ray, tMin, closestSoFar, index);
+    }
+
+    RT_TARGET_AVX2 RT_FLATTEN bool AnySphereAVX2(const SphereBlock* blocks, const size_t count, const Render::Ray& ray, const Math::Real tMin, const Math::Real tMax)
+    {
+        return AnySphere<Math::SIMD::AVX2Lanes>(blocks, count, ray, tMin, tMax);
+    }
+#endif
+
+    // Picks the widest lanes the CPU supports.
+    SphereSet::IntersectFunction SelectSphereKernel()
+    {
+#if RT_ARCH_X86
+        if(Utils::GetCPUFeatures().AVX2)
+            return &IntersectSpheresAVX2;
+
+        if(Utils::GetCPUFeatures().SSE2)
+            return &IntersectSpheres<Math::SIMD::SSELanes>;
+#endif
+
+        return &IntersectSpheres<Math::SIMD::ScalarLanes>;
+    }
+
+    SphereSet::OccludedFunction SelectOccludedKernel()
+    {
+#if RT_ARCH_X86
+        if(Utils::GetCPUFeatures().AVX2)
+            return &AnySphereAVX2;
+
+        if(Utils::GetCPUFeatures().SSE2)
+            return &AnySphere<Math::SIMD::SSELanes>;
+#endif
+
+        return &AnySphere<Math::SIMD::ScalarLanes>;
+    }
+
+}    // namespace Impl
+
+SphereSet::SphereSet()
+    : m_Intersect(Impl::SelectSphereKernel())
+    , m_Occluded(Impl::SelectOccludedKernel())
+{
+}
+
+void SphereSet::Add(const Math::Point3& center, const Math::Real radius, const std::shared_ptr<Render::Material>& material)
+{
+    const Math::Real pError = Math::Gamma(5) * (Math::MaxAbsComponent(center) + std::fabs(radius));
+    AddSphere(center, Math::Vector3(0, 0, 0), radius, pError, material);
+}
+
+void SphereSet::Add(const Math::Point3& center, const Math::Point3& center2, const Math::Real radius, const std::shared_ptr<Render::Material>& material)
+{
+    const Math::Vector3 motion = center2 - center;
+    const Math::Real    pError = Math::Gamma(7) * (Math::MaxAbsComponent(center) + Math::MaxAbsComponent(motion) + std::fabs(radius));
+    AddSphere(center, motion, radius, pError, material);
+}
+
+bool SphereSet::Hit(const Render::Ray& r, const Math::Interval rayT, Render::HitRecord& rec) const
+{
+    Math::Real closestSoFar = rayT.Max;
+    uint32_t   index        = 0;
+    if(!m_Intersect(m_Blocks.data(), m_Blocks.size(), r, rayT.Min, closestSoFar, index))
+        return false;
+
+    // The record is filled for the nearest sphere only, the same way as in Sphere::Hit.
+    const Math::Point3  center = SphereCenter(index, r.Time());
+    const Math::Real    radius = m_Radius[index];
+    const Math::Vector3 radial = r.At(closestSoFar) - center;
+
+    rec.T      = closestSoFar;
+    rec.P      = center + radial * (std::fabs(radius) / radial.Length());
+    rec.PError = m_PError[index];
+
+    const Math::Vector3 outwardNormal = (rec.P - center) / radius;
+    rec.SetFaceNormal(r, outwardNormal);
+    Sphere::GetSphereUV(outwardNormal, rec.U, rec.V);
+
+    rec.MaterialIndex = m_MaterialIndices[index];
+    rec.PrimitiveId   = m_PrimitiveIds[index];
+
+    return true;
+}
+
+bool SphereSet::Occluded(const Render::Ray& r, const Math::Interval rayT) const
+{
+    return m_Occluded(m_Blocks.data(), m_Blocks.size(), r, rayT.Min, rayT.Max);
+}
+
+Math::AABB SphereSet::BoundingBox() const
+{
+    return m_BoundingBox;
+}
+
+bool SphereSet::MotionBounds(Math::AABB& start, Math::AABB& end) const
+{
+    if(!m_IsMoving)
+        return false;
+
+    start = m_StartBox;
+    end   = m_EndBox;
+    return true;
+}
+
+void SphereSet::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    for(size_t i = 0; i < Size(); i++)
+    {
+        m_MaterialIndices[i] = materials.Add(m_Materials[i]);
+        m_PrimitiveIds[i]    = nextPrimitiveId++;
+    }
+}
+
+// Light sampling needs the PDFValue and Random of single spheres, so every emitter is copied into a Sphere.
+void SphereSet::CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const
+{
+    for(size_t i = 0; i < Size(); i++)
+    {
+        const auto&        emitterMaterial = material ? material : m_Materials[i];
+        const Math::Real   radius          = m_Radius[i];
+        const Math::Point3 center          = SphereCenter(i, 0);
+        const Math::Real   power           = emitterMaterial ? emitterMaterial->EmittedPower(4 * Math::Pi * radius * radius, center) : 0;
+        if(power <= 0)
+            continue;
+
+        if(m_IsMoving)
+            emitters.Add(std::make_shared<Sphere>(center, SphereCenter(i, 1), radius, emitterMaterial));
+        else
+            emitters.Add(std::make_shared<Sphere>(center, radius, emitterMaterial));
+        powers.emplace_back(power);
+    }
+}
+
+HittableList SphereSet::Clusters() const
+{
+    HittableList clusters;
+    if(Size() == 0)
+        return clusters;
+
+    // Moving spheres are grouped by where they are halfway through their motion.
+    std::vector<Math::AABB> sphereBounds(Size());
+    for(size_t i = 0; i < Size(); i++)
+    {
+        sphereBounds[i] = SphereBounds(i, 0.5);
+    }
+
+    // Testing a full block costs about as much as testing one primitive, so every range that fits into a block
+    // becomes a leaf, and the SAH only decides how the larger ranges are split.
+    BVHBuildOptions options;
+    options.LeafCost            = options.TraversalCost / LaneCount;
+    options.MaxPrimitivesInLeaf = LaneCount;
+
+    BVHBuilder builder(options);
+    builder.Build(sphereBounds);
+
+    for(const auto& node : builder.Nodes())
+    {
+        if(!node.IsLeaf())
+            continue;
+
+        const auto cluster = std::make_shared<SphereSet>();
+        for(uint32_t i = 0; i < node.PrimitiveCount; i++)
+        {
+            cluster->CopySphere(*this, builder.PrimitiveIndices()[node.Offset + i]);
+        }
+        clusters.Add(cluster);
+    }
+
+    return clusters;
+}
+
+void SphereSet::AddSphere(const Math::Point3& center, const Math::Vector3& motion, const Math::Real radius, const Math::Real pError, const std::shared_ptr<Render::Material>& material)
+{
+    const size_t index = Size();
+    const int    lane  = static_cast<int>(index % LaneCount);
+    if(lane == 0)
+    {
+        SphereBlock& block = m_Blocks.emplace_back();
+        for(int axis = 0; axis < 3; axis++)
+        {
+            std::fill_n(block.Center[axis], LaneCount, std::numeric_limits<Math::Real>::quiet_NaN());
+            std::fill_n(block.Motion[axis], LaneCount, Math::Real(0));
+        }
+        std::fill_n(block.Radius, LaneCount, Math::Real(0));
+    }
+
+    SphereBlock& block = m_Blocks.back();
+    for(int axis = 0; axis < 3; axis++)
+    {
+        block.Center[axis][lane] = center[axis];
+        block.Motion[axis][lane] = motion[axis];
+    }
+    block.Radius[lane] = radius;
+
+    m_Radius.emplace_back(radius);
+    m_PError.emplace_back(pError);
+    m_Materials.emplace_back(material);
+    m_MaterialIndices.emplace_back(0);
+    m_PrimitiveIds.emplace_back(0);
+
+    m_StartBox    = Math::AABB(m_StartBox, SphereBounds(index, 0));
+    m_EndBox      = Math::AABB(m_EndBox, SphereBounds(index, 1));
+    m_BoundingBox = Math::AABB(m_StartBox, m_EndBox);
+    m_IsMoving    = m_IsMoving || motion.LengthSquared() > 0;
+}
+
+void SphereSet::CopySphere(const SphereSet& other, const size_t index)
+{
+    const SphereBlock& block = other.m_Blocks[index / LaneCount];
+    const size_t       lane  = index % LaneCount;
+
+    const Math::Vector3 motion(block.Motion[0][lane], block.Motion[1][lane], block.Motion[2][lane]);
+    AddSphere(other.SphereCenter(index, 0), motion, other.m_Radius[index], other.m_PError[index], other.m_Materials[index]);
+
+    m_MaterialIndices.back() = other.m_MaterialIndices[index];
+    m_PrimitiveIds.back()    = other.m_PrimitiveIds[index];
+}
+
+// Linearly interpolate from center1 to center2 according to time.
+Math::Point3 SphereSet::SphereCenter(const size_t index, const Math::Real time) const
+{
+    const SphereBlock& block = m_Blocks[index / LaneCount];
+    const size_t       lane  = index % LaneCount;
+
+    return {block.Center[0][lane] + time * block.Motion[0][lane],
+            block.Center[1][lane] + time * block.Motion[1][lane],
+            block.Center[2][lane] + time * block.Motion[2][lane]};
+}
+
+Math::AABB SphereSet::SphereBounds(const size_t index, const Math::Real time) const
+{
+    const Math::Real   radius = m_Radius[index];
+    const auto         rvec   = Math::Vector3(radius, radius, radius);
+    const Math::Point3 center = SphereCenter(index, time);
+    return {center - rvec, center + rvec};
+}
+
+}    // namespace Objects
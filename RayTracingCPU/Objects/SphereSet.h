@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Hittable.h"
+#include "HittableList.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Render
+{
+class Material;
+}
+
+namespace Objects
+{
+
+// Spheres stored as SoA lanes, as many as fit into one AVX register: eight in float and four in double precision.
+// One ray is tested against all of them with a few SIMD instructions. Unused lanes have NaN centers, which fail the
+// discriminant test for any ray.
+struct alignas(32) SphereBlock
+{
+    static constexpr int LaneCount = 32 / sizeof(Math::Real);
+
+    Math::Real Center[3][LaneCount];    // [axis][sphere], position at time 0
+    Math::Real Motion[3][LaneCount];    // [axis][sphere], offset of the center at time 1, zero for stationary spheres
+    Math::Real Radius[LaneCount];
+};
+
+// Many spheres in one primitive: the geometry lives in SphereBlocks, the materials and ids in plain arrays next to
+// them. A ray is intersected with a whole block at once and only the record of the nearest sphere is filled. The
+// intersection kernel is picked once at construction, like the one of WideBVH.
+class SphereSet final : public Hittable
+{
+public:
+    static constexpr int LaneCount = SphereBlock::LaneCount;
+
+    SphereSet();
+
+    // Stationary Sphere
+    void Add(const Math::Point3& center, Math::Real radius, const std::shared_ptr<Render::Material>& material);
+
+    // Moving Sphere, at center for t=0 and at center2 for t=1
+    void Add(const Math::Point3& center, const Math::Point3& center2, Math::Real radius, const std::shared_ptr<Render::Material>& material);
+
+    bool       Hit(const Render::Ray& r, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool       Occluded(const Render::Ray& r, Math::Interval rayT) const override;
+    Math::AABB BoundingBox() const override;
+    bool       MotionBounds(Math::AABB& start, Math::AABB& end) const override;
+    void       AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
+    void       CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const override;
+
+    size_t Size() const { return m_Radius.size(); }
+    size_t BlockCount() const { return m_Blocks.size(); }
+
+    // Splits the set into spatially coherent sets of one block each, to be used as the leaves of a BVH. Only spheres
+    // sharing the same center can end up in larger sets.
+    // Material indices and primitive ids are kept, so the split can happen before or after AssignIds.
+    HittableList Clusters() const;
+
+    // Index of the nearest sphere hit in the first count blocks, closestSoFar is lowered to its distance.
+    using IntersectFunction = bool (*)(const SphereBlock* blocks, size_t count, const Render::Ray& ray, Math::Real tMin, Math::Real& closestSoFar, uint32_t& index);
+
+    // Whether any sphere is hit in the first count blocks, stops at the first block with a hit.
+    using OccludedFunction = bool (*)(const SphereBlock* blocks, size_t count, const Render::Ray& ray, Math::Real tMin, Math::Real tMax);
+
+private:
+    std::vector<SphereBlock>                       m_Blocks;
+    std::vector<Math::Real>                        m_Radius;    // Unpadded copies of the per-sphere data for the hit records
+    std::vector<Math::Real>                        m_PError;
+    std::vector<std::shared_ptr<Render::Material>> m_Materials;
+    std::vector<uint32_t>                          m_MaterialIndices;
+    std::vector<uint32_t>                          m_PrimitiveIds;
+    Math::AABB                                     m_BoundingBox;
+    Math::AABB                                     m_StartBox;    // Bounds at time 0 and time 1
+    Math::AABB                                     m_EndBox;
+    bool                                           m_IsMoving  = false;
+    IntersectFunction                              m_Intersect = nullptr;
+    OccludedFunction                               m_Occluded  = nullptr;
+
+    void         AddSphere(const Math::Point3& center, const Math::Vector3& motion, Math::Real radius, Math::Real pError, const std::shared_ptr<Render::Material>& material);
+    void         CopySphere(const SphereSet& other, size_t index);
+    Math::Point3 SphereCenter(size_t index, Math::Real time) const;
+    Math::AABB   SphereBounds(size_t index, Math::Real time) const;
+};
+
+}    // namespace Objects
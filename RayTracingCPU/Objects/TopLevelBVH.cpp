@@ -0,0 +1,212 @@
+#include "TopLevelBVH.h"
+
+#include <Render/HitRecord.h>
+#include <Render/RayPacket.h>
+
+namespace Objects
+{
+
+TopLevelBVH::TopLevelBVH(std::vector<std::shared_ptr<Instance>> instances, std::shared_ptr<Hittable> staticObjects, const BVHBuildOptions& options)
+    : m_Instances(std::move(instances))
+    , m_StaticObjects(std::move(staticObjects))
+    , m_Options(options)
+{
+    // Every entry is a whole structure, so leaves hold one entry and the tree culls and orders them individually.
+    m_Options.MaxPrimitivesInLeaf = 1;
+
+    for(const auto& instance : m_Instances)
+    {
+        m_Entries.emplace_back(instance.get());
+    }
+    if(m_StaticObjects)
+    {
+        m_Entries.emplace_back(m_StaticObjects.get());
+    }
+
+    Rebuild();
+    m_Stats.Log("TopLevelBVH");
+}
+
+void TopLevelBVH::SetTransform(const size_t instance, const Math::Transform& objectToWorld)
+{
+    m_Instances[instance]->SetObjectToWorld(objectToWorld);
+}
+
+void TopLevelBVH::Update()
+{
+    Refit();
+
+    if(SAHCost() > RebuildThreshold * m_Stats.SAHCost)
+        Rebuild();
+}
+
+void TopLevelBVH::UpdateEntryBounds()
+{
+    m_EntryBounds.resize(m_Entries.size());
+    for(size_t i = 0; i < m_Entries.size(); i++)
+    {
+        m_EntryBounds[i] = m_Entries[i]->BoundingBox();
+    }
+}
+
+void TopLevelBVH::Refit()
+{
+    UpdateEntryBounds();
+
+    // The builder allocates children after their parents, so a backward pass sees every child before its parent.
+    for(size_t i = m_Nodes.size(); i-- > 0;)
+    {
+        auto& node = m_Nodes[i];
+        if(node.IsLeaf())
+        {
+            node.Bounds = Math::AABB::Empty;
+            for(uint32_t j = 0; j < node.PrimitiveCount; j++)
+            {
+                node.Bounds = Math::AABB(node.Bounds, m_EntryBounds[m_EntryIndices[node.Offset + j]]);
+            }
+        }
+        else
+        {
+            node.Bounds = Math::AABB(m_Nodes[node.Offset].Bounds, m_Nodes[node.Offset + 1].Bounds);
+        }
+    }
+}
+
+void TopLevelBVH::Rebuild()
+{
+    UpdateEntryBounds();
+
+    BVHBuilder builder(m_Options);
+    builder.Build(m_EntryBounds);
+
+    m_Nodes        = builder.Nodes();
+    m_EntryIndices = builder.PrimitiveIndices();
+    m_Stats        = builder.Stats();
+}
+
+// Same cost model as BVHBuildStats::SAHCost, evaluated on the current bounds.
+double TopLevelBVH::SAHCost() const
+{
+    if(m_Nodes.empty())
+        return 0.0;
+
+    const double rootArea = SurfaceArea(m_Nodes[0].Bounds);
+    double       cost     = 0.0;
+    for(const auto& node : m_Nodes)
+    {
+        const double relArea = rootArea > 0.0 ? SurfaceArea(node.Bounds) / rootArea : 1.0;
+        cost += node.IsLeaf() ? m_Options.LeafCost * relArea * static_cast<double>(node.PrimitiveCount) : m_Options.TraversalCost * relArea;
+    }
+    return cost;
+}
+
+bool TopLevelBVH::Hit(const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord& rec) const
+{
+    return Traverse<false>(ray, rayT, &rec, nullptr);
+}
+
+bool TopLevelBVH::Occluded(const Render::Ray& ray, const Math::Interval rayT) const
+{
+    return Traverse<true>(ray, rayT, nullptr, nullptr);
+}
+
+// The static objects keep their packet traversal, the instances are then traced ray by ray against the closest hits.
+void TopLevelBVH::HitPacket(const Render::RayPacket& packet, const Math::Interval rayT, Render::HitRecord* records, bool* hits) const
+{
+    if(!m_StaticObjects)
+    {
+        Hittable::HitPacket(packet, rayT, records, hits);
+        return;
+    }
+
+    m_StaticObjects->HitPacket(packet, rayT, records, hits);
+    for(int i = 0; i < packet.Size; i++)
+    {
+        const Math::Interval interval(rayT.Min, hits[i] ? records[i].T : rayT.Max);
+        hits[i] = Traverse<false>(packet.Rays[i], interval, &records[i], m_StaticObjects.get()) || hits[i];
+    }
+}
+
+template <bool AnyHit>
+bool TopLevelBVH::Traverse(const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord* rec, const Hittable* skip) const
+{
+    if(m_Nodes.empty())
+        return false;
+
+    bool       hitAnything  = false;
+    Math::Real closestSoFar = rayT.Max;
+
+    uint32_t stack[64];
+    int      stackSize    = 0;
+    uint32_t currentIndex = 0;
+
+    while(true)
+    {
+        const BVHBuildNode& node = m_Nodes[currentIndex];
+
+        if(node.Bounds.Hit(ray, Math::Interval(rayT.Min, closestSoFar)))
+        {
+            if(node.IsLeaf())
+            {
+                for(uint32_t i = 0; i < node.PrimitiveCount; i++)
+                {
+                    const Hittable* entry = m_Entries[m_EntryIndices[node.Offset + i]];
+                    if(entry == skip)
+                        continue;
+
+                    if constexpr(AnyHit)
+                    {
+                        if(entry->Occluded(ray, rayT))
+                            return true;
+                    }
+                    else if(entry->Hit(ray, Math::Interval(rayT.Min, closestSoFar), *rec))
+                    {
+                        hitAnything  = true;
+                        closestSoFar = rec->T;
+                    }
+                }
+            }
+            else
+            {
+                // Visit the child whose center lies closer along the ray first, its hit then culls the other one.
+                const auto separation = Centroid(m_Nodes[node.Offset + 1].Bounds) - Centroid(m_Nodes[node.Offset].Bounds);
+                if(DotProduct(separation, ray.Direction()) < 0)
+                {
+                    stack[stackSize++] = node.Offset;
+                    currentIndex       = node.Offset + 1;
+                }
+                else
+                {
+                    stack[stackSize++] = node.Offset + 1;
+                    currentIndex       = node.Offset;
+                }
+                continue;
+            }
+        }
+
+        if(stackSize == 0)
+            break;
+        currentIndex = stack[--stackSize];
+    }
+
+    return hitAnything;
+}
+
+Math::AABB TopLevelBVH::BoundingBox() const
+{
+    return m_Nodes.empty() ? Math::AABB::Empty : m_Nodes[0].Bounds;
+}
+
+void TopLevelBVH::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    for(const auto& instance : m_Instances)
+    {
+        instance->AssignIds(materials, nextPrimitiveId);
+    }
+    if(m_StaticObjects)
+    {
+        m_StaticObjects->AssignIds(materials, nextPrimitiveId);
+    }
+}
+
+}    // namespace Objects
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "BVHBuild.h"
+#include "Hittable.h"
+#include "Instance.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Objects
+{
+
+// Top level of a two-level BVH, the CPU counterpart of RayTracing::TopLevelAccelerationStructure. The bottom levels
+// are the objects of the instances, built once, plus an optional BVH of everything that never moves. The top level is
+// a small binary tree over the world bounds of these entries, so moving an instance only refits or rebuilds that tree.
+// Updates must not run while other threads trace rays through it.
+class TopLevelBVH final : public Hittable
+{
+public:
+    // Refitted trees whose SAH cost grew by more than this factor since the last build are rebuilt by Update().
+    static constexpr double RebuildThreshold = 1.5;
+
+    explicit TopLevelBVH(std::vector<std::shared_ptr<Instance>> instances, std::shared_ptr<Hittable> staticObjects = nullptr, const BVHBuildOptions& options = {});
+
+    bool       Hit(const Render::Ray& ray, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool       Occluded(const Render::Ray& ray, Math::Interval rayT) const override;
+    Math::AABB BoundingBox() const override;
+    void       AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
+    void       HitPacket(const Render::RayPacket& packet, Math::Interval rayT, Render::HitRecord* records, bool* hits) const override;
+
+    size_t                                        InstanceCount() const { return m_Instances.size(); }
+    const std::vector<std::shared_ptr<Instance>>& Instances() const { return m_Instances; }
+
+    // Moves one instance. The tree is out of date until the next Update(), Refit() or Rebuild().
+    void SetTransform(size_t instance, const Math::Transform& objectToWorld);
+
+    // Refits the tree to the moved instances, or rebuilds it when the refitted tree got too loose.
+    void Update();
+
+    // Recomputes the node bounds bottom-up and keeps the topology.
+    void Refit();
+
+    // Builds a new tree over the current bounds.
+    void Rebuild();
+
+    const BVHBuildStats& Stats() const { return m_Stats; }
+
+private:
+    std::vector<std::shared_ptr<Instance>> m_Instances;
+    std::shared_ptr<Hittable>              m_StaticObjects;
+    std::vector<const Hittable*>           m_Entries;    // Instances followed by the static objects, indexed by the builder
+    std::vector<Math::AABB>                m_EntryBounds;
+    std::vector<BVHBuildNode>              m_Nodes;
+    std::vector<uint32_t>                  m_EntryIndices;
+    BVHBuildOptions                        m_Options;
+    BVHBuildStats                          m_Stats;
+
+    // Closest hit over all entries but skip, which the caller has already intersected. With AnyHit the first hit
+    // found ends the traversal and no record is filled.
+    template <bool AnyHit>
+    bool   Traverse(const Render::Ray& ray, Math::Interval rayT, Render::HitRecord* rec, const Hittable* skip) const;
+    void   UpdateEntryBounds();
+    double SAHCost() const;
+};
+
+}    // namespace Objects
@@ -1,5 +1,9 @@
 #include "Translate.h"
 
+#include "HittableList.h"
+#include "Instance.h"
+
+#include <Math/Transform.h>
 #include <Render/HitRecord.h>
 
 namespace Objects
@@ -23,13 +27,36 @@ bool Translate::Hit(const Render::Ray& ray, const Math::Interval rayT, Render::H
 
     // Move the intersection point forwards by the offset
     rec.P += m_Offset;
+    rec.PError += Math::Gamma(1) * Math::MaxAbsComponent(rec.P);
 
     return true;
 }
 
+bool Translate::Occluded(const Render::Ray& ray, const Math::Interval rayT) const
+{
+    const Render::Ray offsetRay(ray.Origin() - m_Offset, ray.Direction(), ray.Time());
+    return m_Object->Occluded(offsetRay, rayT);
+}
+
 Math::AABB Translate::BoundingBox() const
 {
     return m_BoundingBox;
 }
 
+void Translate::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    m_Object->AssignIds(materials, nextPrimitiveId);
+}
+
+void Translate::CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const
+{
+    HittableList objectEmitters;
+    m_Object->CollectEmitters(objectEmitters, powers, material);
+
+    for(const auto& emitter : objectEmitters.Objects)
+    {
+        emitters.Add(std::make_shared<Instance>(emitter, Math::Transform::Translate(m_Offset)));
+    }
+}
+
 }    // namespace Objects
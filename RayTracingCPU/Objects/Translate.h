@@ -12,7 +12,12 @@ class Translate final : public Hittable
 public:
     Translate(const std::shared_ptr<Hittable>& object, const Math::Vector3& displacement);
     bool       Hit(const Render::Ray& ray, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool       Occluded(const Render::Ray& ray, Math::Interval rayT) const override;
     Math::AABB BoundingBox() const override;
+    void       AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
+
+    // Wraps every emitter of the object in a translating Instance, which can be sampled as a light.
+    void       CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const override;
 
 private:
     std::shared_ptr<Hittable> m_Object;
@@ -0,0 +1,510 @@
+#include "TriangleMesh.h"
+
+#include "BVHBuild.h"
+#include "HittableList.h"
+#include "WideBVH.h"
+
+#include <Math/SIMD.h>
+#include <Math/Transform.h>
+#include <Render/HitRecord.h>
+#include <Render/Material.h>
+#include <Render/MaterialTable.h>
+#include <Render/RayPacket.h>
+#include <Utils/CPUFeatures.h>
+#include <Utils/Log.h>
+#include <Utils/Random.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace Objects
+{
+
+namespace Impl
+{
+
+    // Watertight ray/triangle test of Woop, Benthin and Wald (pbrt section 6.5.3), for all triangles of the block.
+    // The vertices are moved into a space where the ray starts at the origin and runs along +z, so the hit test
+    // reduces to 2D edge functions. Neighbouring triangles compute the same edge function for their shared edge,
+    // which leaves no cracks between them.
+    template <typename Lanes>
+    bool IntersectTriangles(const TriangleBlock& block, const Render::Ray& ray, const Math::Real tMin, Math::Real& closestSoFar, int& hitLane, Math::Real barycentrics[3])
+    {
+        using Type = typename Lanes::Type;
+
+        // The largest direction component becomes z, the other two axes are sheared so that the ray has no x and y.
+        const Math::Vector3& d  = ray.Direction();
+        const int            kz = std::fabs(d.X()) > std::fabs(d.Y()) ? (std::fabs(d.X()) > std::fabs(d.Z()) ? 0 : 2) : (std::fabs(d.Y()) > std::fabs(d.Z()) ? 1 : 2);
+        const int            kx = kz == 2 ? 0 : kz + 1;
+        const int            ky = kx == 2 ? 0 : kx + 1;
+
+        const Type shearX  = Lanes::Set(-d[kx] / d[kz]);
+        const Type shearY  = Lanes::Set(-d[ky] / d[kz]);
+        const Type shearZ  = Lanes::Set(1 / d[kz]);
+        const Type originX = Lanes::Set(ray.Origin()[kx]);
+        const Type originY = Lanes::Set(ray.Origin()[ky]);
+        const Type originZ = Lanes::Set(ray.Origin()[kz]);
+        const Type zero    = Lanes::Set(0);
+        const Type one     = Lanes::Set(1);
+        const Type two     = Lanes::Set(2);
+        const Type three   = Lanes::Set(3);
+        const Type gamma2  = Lanes::Set(Math::Gamma(2));
+        const Type gamma3  = Lanes::Set(Math::Gamma(3));
+        const Type gamma5  = Lanes::Set(Math::Gamma(5));
+        const Type tLow    = Lanes::Set(tMin);
+
+        bool hitAnything = false;
+        for(int group = 0; group < TriangleBlock::LaneCount; group += Lanes::Size)
+        {
+            Type x[3];
+            Type y[3];
+            Type z[3];
+            for(int corner = 0; corner < 3; corner++)
+            {
+                z[corner] = Lanes::Sub(Lanes::Load(&block.Vertex[corner][kz][group]), originZ);
+                x[corner] = Lanes::Add(Lanes::Sub(Lanes::Load(&block.Vertex[corner][kx][group]), originX), Lanes::Mul(shearX, z[corner]));
+                y[corner] = Lanes::Add(Lanes::Sub(Lanes::Load(&block.Vertex[corner][ky][group]), originY), Lanes::Mul(shearY, z[corner]));
+            }
+
+            // Edge functions, the ray passes through the triangle when none of them has a different sign.
+            const Type e0 = Lanes::Sub(Lanes::Mul(x[1], y[2]), Lanes::Mul(y[1], x[2]));
+            const Type e1 = Lanes::Sub(Lanes::Mul(x[2], y[0]), Lanes::Mul(y[2], x[0]));
+            const Type e2 = Lanes::Sub(Lanes::Mul(x[0], y[1]), Lanes::Mul(y[0], x[1]));
+
+            const auto negative   = Lanes::Or(Lanes::Or(Lanes::Less(e0, zero), Lanes::Less(e1, zero)), Lanes::Less(e2, zero));
+            const auto positive   = Lanes::Or(Lanes::Or(Lanes::Less(zero, e0), Lanes::Less(zero, e1)), Lanes::Less(zero, e2));
+            const Type det        = Lanes::Add(Lanes::Add(e0, e1), e2);
+            const auto nonZero    = Lanes::Or(Lanes::Less(det, zero), Lanes::Less(zero, det));
+            const auto candidates = Lanes::AndNot(Lanes::And(negative, positive), nonZero);
+
+            // Most rays miss all triangles of a group, the distances are only computed for groups with a candidate.
+            if(Lanes::MoveMask(candidates) == 0)
+                continue;
+
+            for(int corner = 0; corner < 3; corner++)
+            {
+                z[corner] = Lanes::Mul(shearZ, z[corner]);
+            }
+            const Type tScaled = Lanes::Add(Lanes::Add(Lanes::Mul(e0, z[0]), Lanes::Mul(e1, z[1])), Lanes::Mul(e2, z[2]));
+            const Type invDet  = Lanes::Div(one, det);
+            const Type t       = Lanes::Mul(tScaled, invDet);
+
+            // Conservative bound on the rounding error of t, so that hits right behind the ray origin are rejected.
+            const Type maxX   = Lanes::Max(Lanes::Max(Lanes::Abs(x[0]), Lanes::Abs(x[1])), Lanes::Abs(x[2]));
+            const Type maxY   = Lanes::Max(Lanes::Max(Lanes::Abs(y[0]), Lanes::Abs(y[1])), Lanes::Abs(y[2]));
+            const Type maxZ   = Lanes::Max(Lanes::Max(Lanes::Abs(z[0]), Lanes::Abs(z[1])), Lanes::Abs(z[2]));
+            const Type maxE   = Lanes::Max(Lanes::Max(Lanes::Abs(e0), Lanes::Abs(e1)), Lanes::Abs(e2));
+            const Type deltaX = Lanes::Mul(gamma5, Lanes::Add(maxX, maxZ));
+            const Type deltaY = Lanes::Mul(gamma5, Lanes::Add(maxY, maxZ));
+            const Type deltaZ = Lanes::Mul(gamma3, maxZ);
+            const Type deltaE = Lanes::Mul(two, Lanes::Add(Lanes::Mul(Lanes::Mul(gamma2, maxX), maxY), Lanes::Add(Lanes::Mul(deltaY, maxX), Lanes::Mul(deltaX, maxY))));
+            const Type deltaT = Lanes::Mul(Lanes::Mul(three, Lanes::Add(Lanes::Mul(Lanes::Mul(gamma3, maxE), maxZ), Lanes::Add(Lanes::Mul(deltaE, maxZ), Lanes::Mul(deltaZ, maxE)))), Lanes::Abs(invDet));
+
+            const auto inside = Lanes::And(Lanes::Less(Lanes::Max(tLow, deltaT), t), Lanes::Less(t, Lanes::Set(closestSoFar)));
+            const auto hit    = Lanes::And(candidates, inside);
+
+            uint32_t mask = Lanes::MoveMask(hit);
+            if(mask == 0)
+                continue;
+
+            alignas(32) Math::Real tLanes[Lanes::Size];
+            alignas(32) Math::Real b[3][Lanes::Size];
+            Lanes::Store(tLanes, t);
+            Lanes::Store(b[0], Lanes::Mul(e0, invDet));
+            Lanes::Store(b[1], Lanes::Mul(e1, invDet));
+            Lanes::Store(b[2], Lanes::Mul(e2, invDet));
+
+            for(; mask != 0; mask &= mask - 1)
+            {
+                const int lane = std::countr_zero(mask);
+                if(tLanes[lane] < closestSoFar)
+                {
+                    hitAnything     = true;
+                    closestSoFar    = tLanes[lane];
+                    hitLane         = group + lane;
+                    barycentrics[0] = b[0][lane];
+                    barycentrics[1] = b[1][lane];
+                    barycentrics[2] = b[2][lane];
+                }
+            }
+        }
+        return hitAnything;
+    }
+
+#if RT_ARCH_X86
+    RT_TARGET_AVX2 RT_FLATTEN bool IntersectTrianglesAVX2(const TriangleBlock& block, const Render::Ray& ray, const Math::Real tMin, Math::Real& closestSoFar, int& hitLane, Math::Real barycentrics[3])
+    {
+        return IntersectTriangles<Math::SIMD::AVX2Lanes>(block, ray, tMin, closestSoFar, hitLane, barycentrics);
+    }
+#endif
+
+    // Picks the widest lanes the CPU supports.
+    TriangleMesh::IntersectFunction SelectTriangleKernel()
+    {
+#if RT_ARCH_X86
+        if(Utils::GetCPUFeatures().AVX2)
+            return &IntersectTrianglesAVX2;
+
+        if(Utils::GetCPUFeatures().SSE2)
+            return &IntersectTriangles<Math::SIMD::SSELanes>;
+#endif
+
+        return &IntersectTriangles<Math::SIMD::ScalarLanes>;
+    }
+
+}    // namespace Impl
+
+// Leaf of the mesh BVH: one block of triangles, which fills the hit record through the mesh.
+class TriangleMesh::Cluster final : public Hittable
+{
+public:
+    Cluster(const TriangleMesh& mesh, const TriangleBlock& block, const Math::AABB& boundingBox)
+        : m_Block(block)
+        , m_Mesh(mesh)
+        , m_BoundingBox(boundingBox)
+    {
+    }
+
+    bool Hit(const Render::Ray& r, const Math::Interval rayT, Render::HitRecord& rec) const override
+    {
+        Math::Real closestSoFar = rayT.Max;
+        int        lane         = 0;
+        Math::Real barycentrics[3];
+        if(!m_Mesh.m_Intersect(m_Block, r, rayT.Min, closestSoFar, lane, barycentrics))
+            return false;
+
+        m_Mesh.FillHitRecord(r, m_Block.Triangle[lane], closestSoFar, barycentrics, rec);
+        return true;
+    }
+
+    // The kernel tests the whole block at once, a hit only skips the record.
+    bool Occluded(const Render::Ray& r, const Math::Interval rayT) const override
+    {
+        Math::Real closestSoFar = rayT.Max;
+        int        lane         = 0;
+        Math::Real barycentrics[3];
+        return m_Mesh.m_Intersect(m_Block, r, rayT.Min, closestSoFar, lane, barycentrics);
+    }
+
+    Math::AABB BoundingBox() const override { return m_BoundingBox; }
+
+private:
+    TriangleBlock       m_Block;
+    const TriangleMesh& m_Mesh;
+    Math::AABB          m_BoundingBox;
+};
+
+void TriangleMeshData::Transform(const Math::Transform& transform)
+{
+    for(auto& position : Positions)
+    {
+        position = transform.ApplyPoint(position);
+    }
+
+    for(auto& normal : Normals)
+    {
+        normal = UnitVector(transform.ApplyNormal(normal));
+    }
+
+    if(transform.SwapsHandedness())
+    {
+        for(size_t i = 0; i < Indices.size(); i += 3)
+        {
+            std::swap(Indices[i + 1], Indices[i + 2]);
+        }
+    }
+}
+
+void TriangleMeshData::SetMaterial(const std::shared_ptr<Render::Material>& material)
+{
+    Materials = {material};
+    MaterialIds.assign(TriangleCount(), 0);
+}
+
+TriangleMesh::TriangleMesh(TriangleMeshData data)
+    : m_Data(std::move(data))
+    , m_MaterialIndices(m_Data.Materials.size(), 0)
+    , m_Intersect(Impl::SelectTriangleKernel())
+{
+    m_Data.MaterialIds.resize(TriangleCount(), 0);
+
+    // Triangles without area can't be hit and have no normal, they are left out of the BVH.
+    std::vector<uint32_t>   triangles;
+    std::vector<Math::AABB> triangleBounds;
+    triangles.reserve(TriangleCount());
+    triangleBounds.reserve(TriangleCount());
+
+    size_t invalidCount = 0;
+    for(uint32_t triangle = 0; triangle < TriangleCount(); triangle++)
+    {
+        const uint32_t* index = &m_Data.Indices[3 * triangle];
+        if(std::max({index[0], index[1], index[2]}) >= m_Data.Positions.size() || m_Data.MaterialIds[triangle] >= m_Data.Materials.size())
+        {
+            invalidCount++;
+            continue;
+        }
+
+        const Math::Point3& p0 = m_Data.Positions[index[0]];
+        const Math::Point3& p1 = m_Data.Positions[index[1]];
+        const Math::Point3& p2 = m_Data.Positions[index[2]];
+        if(CrossProduct(p1 - p0, p2 - p0).LengthSquared() == 0)
+            continue;
+
+        triangles.emplace_back(triangle);
+        triangleBounds.emplace_back(Math::AABB(p0, p1), Math::AABB(p2, p2));
+    }
+
+    if(invalidCount > 0)
+    {
+        LOG_ERROR("Triangle mesh: skipped {} triangles with out-of-range vertex or material indices", invalidCount);
+    }
+
+    if(triangles.empty())
+        return;
+
+    // Same leaf policy as SphereSet::Clusters: every range that fits into a block becomes a leaf.
+    BVHBuildOptions options;
+    options.LeafCost            = options.TraversalCost / LaneCount;
+    options.MaxPrimitivesInLeaf = LaneCount;
+
+    BVHBuilder builder(options);
+    builder.Build(triangleBounds);
+
+    std::vector<std::shared_ptr<Hittable>> clusters;
+    for(const auto& node : builder.Nodes())
+    {
+        if(!node.IsLeaf())
+            continue;
+
+        // Leaves of triangles with the same centroid can exceed one block, they are split into several clusters.
+        for(uint32_t first = 0; first < node.PrimitiveCount; first += LaneCount)
+        {
+            TriangleBlock block;
+            for(int corner = 0; corner < 3; corner++)
+            {
+                for(int axis = 0; axis < 3; axis++)
+                {
+                    std::fill_n(block.Vertex[corner][axis], LaneCount, std::numeric_limits<Math::Real>::quiet_NaN());
+                }
+            }
+            std::fill_n(block.Triangle, LaneCount, 0u);
+
+            Math::AABB     boundingBox;
+            const uint32_t count = std::min<uint32_t>(LaneCount, node.PrimitiveCount - first);
+            for(uint32_t lane = 0; lane < count; lane++)
+            {
+                const uint32_t  primitive = builder.PrimitiveIndices()[node.Offset + first + lane];
+                const uint32_t  triangle  = triangles[primitive];
+                const uint32_t* index     = &m_Data.Indices[3 * triangle];
+                for(int corner = 0; corner < 3; corner++)
+                {
+                    for(int axis = 0; axis < 3; axis++)
+                    {
+                        block.Vertex[corner][axis][lane] = m_Data.Positions[index[corner]][axis];
+                    }
+                }
+                block.Triangle[lane] = triangle;
+                boundingBox          = Math::AABB(boundingBox, triangleBounds[primitive]);
+            }
+
+            clusters.emplace_back(std::make_shared<Cluster>(*this, block, boundingBox));
+        }
+    }
+
+    m_BVH = std::make_shared<BVH8>(clusters);
+}
+
+bool TriangleMesh::Hit(const Render::Ray& r, const Math::Interval rayT, Render::HitRecord& rec) const
+{
+    return m_BVH && m_BVH->Hit(r, rayT, rec);
+}
+
+bool TriangleMesh::Occluded(const Render::Ray& r, const Math::Interval rayT) const
+{
+    return m_BVH && m_BVH->Occluded(r, rayT);
+}
+
+Math::AABB TriangleMesh::BoundingBox() const
+{
+    return m_BVH ? m_BVH->BoundingBox() : Math::AABB::Empty;
+}
+
+void TriangleMesh::HitPacket(const Render::RayPacket& packet, const Math::Interval rayT, Render::HitRecord* records, bool* hits) const
+{
+    if(m_BVH)
+    {
+        m_BVH->HitPacket(packet, rayT, records, hits);
+        return;
+    }
+    std::fill_n(hits, packet.Size, false);
+}
+
+void TriangleMesh::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    for(size_t i = 0; i < m_Data.Materials.size(); i++)
+    {
+        m_MaterialIndices[i] = materials.Add(m_Data.Materials[i]);
+    }
+    m_FirstPrimitiveId = nextPrimitiveId;
+    nextPrimitiveId += static_cast<uint32_t>(TriangleCount());
+}
+
+void TriangleMesh::CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const
+{
+    if(!m_BVH)
+        return;
+
+    // Every emissive triangle gets its own vertices, the emitter mesh does not share them with the rest of the mesh.
+    TriangleMeshData        lightData;
+    std::vector<Math::Real> areas;
+    Math::Real              power = 0;
+    lightData.Materials           = material ? std::vector<std::shared_ptr<Render::Material>> {material} : m_Data.Materials;
+
+    for(uint32_t triangle = 0; triangle < TriangleCount(); triangle++)
+    {
+        const uint32_t* index = &m_Data.Indices[3 * triangle];
+        if(std::max({index[0], index[1], index[2]}) >= m_Data.Positions.size() || m_Data.MaterialIds[triangle] >= m_Data.Materials.size())
+            continue;
+
+        const uint32_t      materialId = material ? 0 : m_Data.MaterialIds[triangle];
+        const auto&         emitter    = lightData.Materials[materialId];
+        const Math::Point3& p0         = m_Data.Positions[index[0]];
+        const Math::Point3& p1         = m_Data.Positions[index[1]];
+        const Math::Point3& p2         = m_Data.Positions[index[2]];
+        const Math::Real    area       = CrossProduct(p1 - p0, p2 - p0).Length() / 2;
+        const Math::Real    trianglePower = emitter && area > 0 ? emitter->EmittedPower(area, (p0 + p1 + p2) / 3) : 0;
+        if(trianglePower <= 0)
+            continue;
+
+        for(int corner = 0; corner < 3; corner++)
+        {
+            lightData.Indices.emplace_back(static_cast<uint32_t>(lightData.Positions.size()));
+            lightData.Positions.emplace_back(m_Data.Positions[index[corner]]);
+            if(!m_Data.Normals.empty())
+                lightData.Normals.emplace_back(m_Data.Normals[index[corner]]);
+            if(!m_Data.TexCoords.empty())
+            {
+                lightData.TexCoords.emplace_back(m_Data.TexCoords[2 * index[corner]]);
+                lightData.TexCoords.emplace_back(m_Data.TexCoords[2 * index[corner] + 1]);
+            }
+        }
+        lightData.MaterialIds.emplace_back(materialId);
+        areas.emplace_back(area);
+        power += trianglePower;
+    }
+
+    if(areas.empty())
+        return;
+
+    const auto lightMesh = std::make_shared<TriangleMesh>(std::move(lightData));
+    for(const Math::Real area : areas)
+    {
+        lightMesh->m_LightArea += area;
+    }
+    lightMesh->m_LightTriangles = Math::AliasTable(areas);
+
+    emitters.Add(lightMesh);
+    powers.emplace_back(power);
+}
+
+Math::Real TriangleMesh::PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const
+{
+    if(m_LightArea <= 0)
+        return 0;
+
+    // Points are sampled uniformly over the area, so every triangle the direction passes through adds the density of
+    // its point converted to solid angle. Hits are strictly beyond the previous one, so the loop ends.
+    const Render::Ray ray(origin, direction);
+    Render::HitRecord rec;
+    Math::Real        density = 0;
+    Math::Real        tMin    = 0;
+    while(Hit(ray, Math::Interval(tMin, Math::Infinity), rec))
+    {
+        const uint32_t*     index  = &m_Data.Indices[3 * (rec.PrimitiveId - m_FirstPrimitiveId)];
+        const Math::Vector3 normal = UnitVector(CrossProduct(m_Data.Positions[index[1]] - m_Data.Positions[index[0]], m_Data.Positions[index[2]] - m_Data.Positions[index[0]]));
+        const Math::Real    cosine = std::fabs(DotProduct(direction, normal) / direction.Length());
+        if(cosine > 0)
+            density += rec.T * rec.T * direction.LengthSquared() / (cosine * m_LightArea);
+        tMin = rec.T;
+    }
+    return density;
+}
+
+Math::Vector3 TriangleMesh::Random(const Math::Point3& origin) const
+{
+    if(m_LightArea <= 0)
+        return {1, 0, 0};
+
+    Math::Real      pmf;
+    const uint32_t  triangle = m_LightTriangles.Sample(static_cast<Math::Real>(Utils::Random::Double()), pmf);
+    const uint32_t* index    = &m_Data.Indices[3 * triangle];
+
+    // Uniform point on the triangle, see pbrt section A.5.5.
+    const Math::Real root = std::sqrt(static_cast<Math::Real>(Utils::Random::Double()));
+    const Math::Real b0   = 1 - root;
+    const Math::Real b1   = root * static_cast<Math::Real>(Utils::Random::Double());
+    const Math::Point3 p  = b0 * m_Data.Positions[index[0]] + b1 * m_Data.Positions[index[1]] + (1 - b0 - b1) * m_Data.Positions[index[2]];
+    return p - origin;
+}
+
+void TriangleMesh::FillHitRecord(const Render::Ray& r, const uint32_t triangle, const Math::Real t, const Math::Real barycentrics[3], Render::HitRecord& rec) const
+{
+    const uint32_t*     index = &m_Data.Indices[3 * triangle];
+    const Math::Point3& p0    = m_Data.Positions[index[0]];
+    const Math::Point3& p1    = m_Data.Positions[index[1]];
+    const Math::Point3& p2    = m_Data.Positions[index[2]];
+    const Math::Real    b0    = barycentrics[0];
+    const Math::Real    b1    = barycentrics[1];
+    const Math::Real    b2    = barycentrics[2];
+
+    // The hit point is interpolated from the vertices rather than computed along the ray, which bounds its error by
+    // the size of the coordinates alone (pbrt section 6.8.5).
+    rec.T      = t;
+    rec.P      = b0 * p0 + b1 * p1 + b2 * p2;
+    rec.PError = Math::Gamma(7) * (std::fabs(b0) * Math::MaxAbsComponent(p0) + std::fabs(b1) * Math::MaxAbsComponent(p1) + std::fabs(b2) * Math::MaxAbsComponent(p2));
+
+    Math::Vector3 outwardNormal = UnitVector(CrossProduct(p0 - p2, p1 - p2));
+    Math::Vector3 shadingNormal;
+    if(!m_Data.Normals.empty())
+    {
+        shadingNormal = b0 * m_Data.Normals[index[0]] + b1 * m_Data.Normals[index[1]] + b2 * m_Data.Normals[index[2]];
+    }
+
+    if(shadingNormal.LengthSquared() == 0)
+    {
+        rec.SetFaceNormal(r, outwardNormal);
+    }
+    else
+    {
+        // The interpolated normal decides which side is outside and is used for shading. Spawned rays are offset
+        // along it, so the error bound is widened until the offset still clears the surface along the true normal.
+        shadingNormal           = UnitVector(shadingNormal);
+        const Math::Real cosine = DotProduct(outwardNormal, shadingNormal);
+        if(cosine < 0)
+            outwardNormal = -outwardNormal;
+
+        rec.SetFaceNormal(r, outwardNormal);
+        rec.Normal = rec.FrontFace ? shadingNormal : -shadingNormal;
+        rec.PError /= std::max(std::fabs(cosine), Math::Real(0.1));
+    }
+
+    if(m_Data.TexCoords.empty())
+    {
+        // Corners at (0, 0), (1, 0) and (1, 1)
+        rec.U = b1 + b2;
+        rec.V = b2;
+    }
+    else
+    {
+        const Math::Real* uv = m_Data.TexCoords.data();
+        rec.U                = b0 * uv[2 * index[0]] + b1 * uv[2 * index[1]] + b2 * uv[2 * index[2]];
+        rec.V                = b0 * uv[2 * index[0] + 1] + b1 * uv[2 * index[1] + 1] + b2 * uv[2 * index[2] + 1];
+    }
+
+    rec.MaterialIndex = m_MaterialIndices[m_Data.MaterialIds[triangle]];
+    rec.PrimitiveId   = m_FirstPrimitiveId + triangle;
+}
+
+}    // namespace Objects
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Hittable.h"
+
+#include <Math/AliasTable.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Math
+{
+class Transform;
+}
+
+namespace Render
+{
+class Material;
+}
+
+namespace Objects
+{
+
+// Indexed triangle list whose vertex attributes are shared by all triangles using them. Normals and texture coordinates
+// are optional: meshes without normals are shaded flat, meshes without texture coordinates get barycentric ones.
+struct TriangleMeshData
+{
+    std::vector<Math::Point3>                      Positions;
+    std::vector<Math::Vector3>                     Normals;        // One per position, or none
+    std::vector<Math::Real>                        TexCoords;      // Two per position (u, v), or none
+    std::vector<uint32_t>                          Indices;        // Three per triangle, counterclockwise seen from the front
+    std::vector<uint32_t>                          MaterialIds;    // One per triangle, into Materials
+    std::vector<std::shared_ptr<Render::Material>> Materials;
+
+    size_t TriangleCount() const { return Indices.size() / 3; }
+
+    // Bakes the transform into the positions and normals. Mirroring transforms also flip the winding, so the front
+    // faces stay in front.
+    void Transform(const Math::Transform& transform);
+
+    // Replaces all materials of the mesh by one.
+    void SetMaterial(const std::shared_ptr<Render::Material>& material);
+};
+
+// Triangles stored as SoA lanes, as many as fit into one AVX register: eight in float and four in double precision.
+// Unused lanes have NaN vertices, which fail the edge tests for any ray.
+struct alignas(32) TriangleBlock
+{
+    static constexpr int LaneCount = 32 / sizeof(Math::Real);
+
+    Math::Real Vertex[3][3][LaneCount];    // [corner][axis][triangle]
+    uint32_t   Triangle[LaneCount];        // Index of the triangle in the mesh data
+};
+
+// Triangle mesh with its own BVH8, so a model of millions of triangles is a single primitive of the scene BVH. The
+// leaves of the mesh BVH are TriangleBlocks of nearby triangles, intersected with the watertight test of Woop et al.
+// (pbrt section 6.5.3) in a SIMD kernel picked once at construction. Only the record of the nearest hit is filled.
+class TriangleMesh final : public Hittable
+{
+public:
+    static constexpr int LaneCount = TriangleBlock::LaneCount;
+
+    explicit TriangleMesh(TriangleMeshData data);
+
+    // Leaves of the mesh BVH point back to the mesh.
+    TriangleMesh(const TriangleMesh&)            = delete;
+    TriangleMesh& operator=(const TriangleMesh&) = delete;
+
+    bool       Hit(const Render::Ray& r, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool       Occluded(const Render::Ray& r, Math::Interval rayT) const override;
+    Math::AABB BoundingBox() const override;
+    void       HitPacket(const Render::RayPacket& packet, Math::Interval rayT, Render::HitRecord* records, bool* hits) const override;
+    void       AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
+
+    // Adds one mesh of all emissive triangles, which samples its triangles by area when used as a light.
+    void CollectEmitters(HittableList& emitters, std::vector<Math::Real>& powers, const std::shared_ptr<Render::Material>& material) const override;
+
+    // Only meshes made by CollectEmitters() can be sampled. The density of a direction sums over all triangles it
+    // passes through.
+    Math::Real    PDFValue(const Math::Point3& origin, const Math::Vector3& direction) const override;
+    Math::Vector3 Random(const Math::Point3& origin) const override;
+
+    const TriangleMeshData& Data() const { return m_Data; }
+    size_t                  TriangleCount() const { return m_Data.TriangleCount(); }
+
+    // Lane of the nearest triangle hit in the block, closestSoFar is lowered to its distance. The barycentric
+    // coordinates of the hit point are returned for the three corners.
+    using IntersectFunction = bool (*)(const TriangleBlock& block, const Render::Ray& ray, Math::Real tMin, Math::Real& closestSoFar, int& lane, Math::Real barycentrics[3]);
+
+private:
+    class Cluster;
+
+    TriangleMeshData          m_Data;
+    std::shared_ptr<Hittable> m_BVH;                // Null for meshes without any valid triangle
+    std::vector<uint32_t>     m_MaterialIndices;    // Scene material index of each mesh material
+    uint32_t                  m_FirstPrimitiveId = 0;
+    IntersectFunction         m_Intersect        = nullptr;
+    Math::AliasTable          m_LightTriangles;    // Triangles by area, for meshes sampled as lights
+    Math::Real                m_LightArea = 0;
+
+    void FillHitRecord(const Render::Ray& r, uint32_t triangle, Math::Real t, const Math::Real barycentrics[3], Render::HitRecord& rec) const;
+};
+
+}    // namespace Objects
@@ -0,0 +1,722 @@
+// ReSharper disable CppUseRangeAlgorithm
+#include "WideBVH.h"
+
+#include "LinearBVH.h"
+
+#include <Render/HitRecord.h>
+#include <Render/RayPacket.h>
+#include <Utils/CPUFeatures.h>
+
+#if RT_ARCH_X86
+    #include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <string>
+
+namespace Objects
+{
+
+namespace Impl
+{
+
+    // Ray prepared for the slab tests of the wide nodes.
+    struct WideRay
+    {
+        float Origin[3];
+        float InvDirection[3];
+        float InvDirectionFar[3];    // Scaled by SlabErrorScale, so the far distances are rounded outwards for free
+        int   Near[3];               // Index of the bound hit first on every axis: 0 for positive directions, 1 for negative
+
+        WideRay() = default;
+
+        explicit WideRay(const Render::Ray& ray)
+        {
+            for(int axis = 0; axis < 3; axis++)
+            {
+                Origin[axis]          = static_cast<float>(ray.Origin()[axis]);
+                InvDirection[axis]    = static_cast<float>(1.0 / ray.Direction()[axis]);
+                InvDirectionFar[axis] = InvDirection[axis] * SlabErrorScale;
+                Near[axis]            = std::signbit(InvDirection[axis]) ? 1 : 0;
+            }
+        }
+    };
+
+    // All kernels return a bit mask of the children hit by the ray and store their entry distances. The new distance
+    // is always the first operand of min/max, so NaNs from 0 * inf are dropped in favor of the running value.
+
+    struct ScalarKernel
+    {
+        static constexpr const char* Name = "Scalar";
+
+        template <int Width>
+        static uint32_t Intersect(const WideBVHNode<Width>& node, const WideRay& ray, const float tMin, const float tMax, float tNear[Width])
+        {
+            uint32_t mask = 0;
+            for(int child = 0; child < Width; child++)
+            {
+                float childNear = tMin;
+                float childFar  = tMax;
+                for(int axis = 0; axis < 3; axis++)
+                {
+                    const float t0 = (node.Bounds[ray.Near[axis]][axis][child] - ray.Origin[axis]) * ray.InvDirection[axis];
+                    const float t1 = (node.Bounds[1 - ray.Near[axis]][axis][child] - ray.Origin[axis]) * ray.InvDirectionFar[axis];
+
+                    childNear = t0 > childNear ? t0 : childNear;
+                    childFar  = t1 < childFar ? t1 : childFar;
+                }
+
+                tNear[child] = childNear;
+                if(childNear <= childFar)
+                    mask |= 1u << child;
+            }
+            return mask;
+        }
+    };
+
+#if RT_ARCH_X86
+    // SSE is part of x86-64, so this kernel needs no dispatch. 8-wide nodes are processed as two groups of four.
+    struct SSEKernel
+    {
+        static constexpr const char* Name = "SSE";
+
+        template <int Width>
+        static uint32_t Intersect(const WideBVHNode<Width>& node, const WideRay& ray, const float tMin, const float tMax, float tNear[Width])
+        {
+            uint32_t mask = 0;
+            for(int group = 0; group < Width; group += 4)
+            {
+                __m128 childNear = _mm_set1_ps(tMin);
+                __m128 childFar  = _mm_set1_ps(tMax);
+                for(int axis = 0; axis < 3; axis++)
+                {
+                    const __m128 origin = _mm_set1_ps(ray.Origin[axis]);
+                    const __m128 t0     = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.Bounds[ray.Near[axis]][axis][group]), origin), _mm_set1_ps(ray.InvDirection[axis]));
+                    const __m128 t1     = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.Bounds[1 - ray.Near[axis]][axis][group]), origin), _mm_set1_ps(ray.InvDirectionFar[axis]));
+
+                    childNear = _mm_max_ps(t0, childNear);
+                    childFar  = _mm_min_ps(t1, childFar);
+                }
+
+                _mm_storeu_ps(&tNear[group], childNear);
+                mask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(childNear, childFar))) << group;
+            }
+            return mask;
+        }
+    };
+
+    struct AVX2Kernel
+    {
+        static constexpr const char* Name = "AVX2";
+
+        RT_TARGET_AVX2 static uint32_t Intersect(const WideBVHNode<8>& node, const WideRay& ray, const float tMin, const float tMax, float tNear[8])
+        {
+            __m256 childNear = _mm256_set1_ps(tMin);
+            __m256 childFar  = _mm256_set1_ps(tMax);
+            for(int axis = 0; axis < 3; axis++)
+            {
+                const __m256 origin = _mm256_set1_ps(ray.Origin[axis]);
+                const __m256 t0     = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.Bounds[ray.Near[axis]][axis]), origin), _mm256_set1_ps(ray.InvDirection[axis]));
+                const __m256 t1     = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(node.Bounds[1 - ray.Near[axis]][axis]), origin), _mm256_set1_ps(ray.InvDirectionFar[axis]));
+
+                childNear = _mm256_max_ps(t0, childNear);
+                childFar  = _mm256_min_ps(t1, childFar);
+            }
+
+            _mm256_storeu_ps(tNear, childNear);
+            return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(childNear, childFar, _CMP_LE_OQ)));
+        }
+    };
+#endif
+
+    // Child bounds of a node of a moving tree at the given time.
+    template <int Width>
+    void InterpolateBounds(const WideBVHNode<Width>& node, const WideBVHNodeMotion<Width>& motion, const float time, WideBVHNode<Width>& result)
+    {
+        const float* bounds = &node.Bounds[0][0][0];
+        const float* delta  = &motion.Delta[0][0][0];
+        float*       out    = &result.Bounds[0][0][0];
+        for(int i = 0; i < 2 * 3 * Width; i++)
+        {
+            out[i] = bounds[i] + time * delta[i];
+        }
+    }
+
+    // Closest hit, or with AnyHit the first hit found, which ends the traversal and fills no record.
+    template <int Width, typename Kernel, bool Motion, bool AnyHit>
+    bool TraverseWideBVHRay(const WideBVH<Width>& bvh, const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord* rec)
+    {
+        const auto& nodes      = bvh.Nodes();
+        const auto& motions    = bvh.NodeMotions();
+        const auto& primitives = bvh.PrimitivePtrs();
+        if(nodes.empty())
+            return false;
+
+        const WideRay wideRay(ray);
+        const auto    tMin = static_cast<float>(rayT.Min);
+        const auto    time = static_cast<float>(ray.Time());
+
+        bool       hitAnything  = false;
+        Math::Real closestSoFar = rayT.Max;
+
+        struct StackEntry
+        {
+            uint32_t Node;
+            float    TNear;
+        };
+
+        // Every level pushes at most Width - 1 entries more than it pops.
+        StackEntry stack[64 * Width];
+        int        stackSize = 0;
+        stack[stackSize++]   = {0, tMin};
+
+        while(stackSize > 0)
+        {
+            const StackEntry entry = stack[--stackSize];
+            const float      tMax  = static_cast<float>(closestSoFar);
+
+            // The entry distance was computed before closer hits were found, so far subtrees are culled here.
+            if(entry.TNear > tMax * SlabErrorScale)
+                continue;
+
+            const auto& node = nodes[entry.Node];
+
+            alignas(32) float tNear[Width];
+            uint32_t          mask;
+            if constexpr(Motion)
+            {
+                WideBVHNode<Width> bounds;
+                InterpolateBounds(node, motions[entry.Node], time, bounds);
+                mask = Kernel::Intersect(bounds, wideRay, tMin, tMax, tNear);
+            }
+            else
+            {
+                mask = Kernel::Intersect(node, wideRay, tMin, tMax, tNear);
+            }
+
+            StackEntry children[Width];
+            int        childCount = 0;
+            while(mask != 0)
+            {
+                const int child  = std::countr_zero(mask);
+                mask            &= mask - 1;
+
+                if(node.PrimitiveCount[child] == 0)
+                {
+                    children[childCount++] = {node.Offset[child], tNear[child]};
+                    continue;
+                }
+
+                for(uint32_t i = 0; i < node.PrimitiveCount[child]; i++)
+                {
+                    if constexpr(AnyHit)
+                    {
+                        if(primitives[node.Offset[child] + i]->Occluded(ray, rayT))
+                            return true;
+                    }
+                    else if(primitives[node.Offset[child] + i]->Hit(ray, Math::Interval(rayT.Min, closestSoFar), *rec))
+                    {
+                        hitAnything  = true;
+                        closestSoFar = rec->T;
+                    }
+                }
+            }
+
+            // Push the farthest child first, so the nearest one is visited next.
+            for(int i = 1; i < childCount; i++)
+            {
+                const StackEntry child = children[i];
+                int              j     = i - 1;
+                for(; j >= 0 && children[j].TNear < child.TNear; j--)
+                {
+                    children[j + 1] = children[j];
+                }
+                children[j + 1] = child;
+            }
+            for(int i = 0; i < childCount; i++)
+            {
+                stack[stackSize++] = children[i];
+            }
+        }
+
+        return hitAnything;
+    }
+
+    template <int Width, typename Kernel, bool Motion>
+    bool TraverseWideBVH(const WideBVH<Width>& bvh, const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord& rec)
+    {
+        return TraverseWideBVHRay<Width, Kernel, Motion, false>(bvh, ray, rayT, &rec);
+    }
+
+    template <int Width, typename Kernel, bool Motion>
+    bool OccludedWideBVH(const WideBVH<Width>& bvh, const Render::Ray& ray, const Math::Interval rayT)
+    {
+        return TraverseWideBVHRay<Width, Kernel, Motion, true>(bvh, ray, rayT, nullptr);
+    }
+
+    // Interval bounds of the origins and inverse directions of a packet. They are only usable if the direction
+    // signs agree on every axis, which holds for the primary rays of a pixel block almost everywhere.
+    struct PacketInterval
+    {
+        bool  Valid = true;
+        int   Near[3];
+        float OriginMin[3];
+        float OriginMax[3];
+        float InvDirectionMin[3];
+        float InvDirectionMax[3];
+
+        PacketInterval(const WideRay* rays, const int size)
+        {
+            for(int axis = 0; axis < 3; axis++)
+            {
+                Near[axis]            = rays[0].Near[axis];
+                OriginMin[axis]       = OriginMax[axis] = rays[0].Origin[axis];
+                InvDirectionMin[axis] = InvDirectionMax[axis] = rays[0].InvDirection[axis];
+                for(int i = 1; i < size; i++)
+                {
+                    Valid                 = Valid && rays[i].Near[axis] == Near[axis];
+                    OriginMin[axis]       = std::min(OriginMin[axis], rays[i].Origin[axis]);
+                    OriginMax[axis]       = std::max(OriginMax[axis], rays[i].Origin[axis]);
+                    InvDirectionMin[axis] = std::min(InvDirectionMin[axis], rays[i].InvDirection[axis]);
+                    InvDirectionMax[axis] = std::max(InvDirectionMax[axis], rays[i].InvDirection[axis]);
+                }
+
+                // Axis-parallel rays would turn the interval products into NaNs.
+                Valid = Valid && std::isfinite(InvDirectionMin[axis]) && std::isfinite(InvDirectionMax[axis]);
+            }
+        }
+
+        // Returns the children that may be hit by any ray of the packet, using interval arithmetic on the slabs.
+        template <int Width>
+        uint32_t Intersect(const WideBVHNode<Width>& node, const float tMin, const float tMax) const
+        {
+            uint32_t mask = 0;
+            for(int child = 0; child < Width; child++)
+            {
+                float childNear = tMin;
+                float childFar  = tMax;
+                for(int axis = 0; axis < 3; axis++)
+                {
+                    const float nearMin = node.Bounds[Near[axis]][axis][child] - OriginMax[axis];
+                    const float nearMax = node.Bounds[Near[axis]][axis][child] - OriginMin[axis];
+                    const float farMin  = node.Bounds[1 - Near[axis]][axis][child] - OriginMax[axis];
+                    const float farMax  = node.Bounds[1 - Near[axis]][axis][child] - OriginMin[axis];
+
+                    const float t0 = std::min(std::min(nearMin * InvDirectionMin[axis], nearMin * InvDirectionMax[axis]), std::min(nearMax * InvDirectionMin[axis], nearMax * InvDirectionMax[axis]));
+                    const float t1 = std::max(std::max(farMin * InvDirectionMin[axis], farMin * InvDirectionMax[axis]), std::max(farMax * InvDirectionMin[axis], farMax * InvDirectionMax[axis]));
+
+                    // Rounded outwards once more than the far distances of the single rays, so that the interval
+                    // test never culls a child which one of the rays would hit.
+                    childNear = std::max(childNear, t0);
+                    childFar  = std::min(childFar, t1 * SlabErrorScale * SlabErrorScale);
+                }
+
+                if(childNear <= childFar)
+                    mask |= 1u << child;
+            }
+            return mask;
+        }
+    };
+
+    template <int Width, typename Kernel>
+    void TraverseWideBVHPacket(const WideBVH<Width>& bvh, const Render::RayPacket& packet, const Math::Interval rayT, Render::HitRecord* records, bool* hits)
+    {
+        const auto& nodes      = bvh.Nodes();
+        const auto& primitives = bvh.PrimitivePtrs();
+        const int   size       = packet.Size;
+
+        std::fill_n(hits, size, false);
+        if(nodes.empty() || size == 0)
+            return;
+
+        WideRay    wideRays[Render::RayPacket::MaxSize];
+        Math::Real closestSoFar[Render::RayPacket::MaxSize];
+        for(int i = 0; i < size; i++)
+        {
+            wideRays[i]     = WideRay(packet.Rays[i]);
+            closestSoFar[i] = rayT.Max;
+        }
+
+        const PacketInterval interval(wideRays, size);
+        const auto           tMin = static_cast<float>(rayT.Min);
+
+        // Every stack entry carries the rays that still hit the node.
+        struct StackEntry
+        {
+            uint32_t Node;
+            uint32_t RayMask;
+            float    TNear;
+        };
+
+        StackEntry stack[64 * Width];
+        int        stackSize = 0;
+        stack[stackSize++]   = {0, (1u << size) - 1, tMin};
+
+        while(stackSize > 0)
+        {
+            const StackEntry entry = stack[--stackSize];
+            const auto&      node  = nodes[entry.Node];
+
+            // The farthest hit of the rays still active bounds the packet interval.
+            Math::Real packetMax = 0.0;
+            for(uint32_t rayMask = entry.RayMask; rayMask != 0; rayMask &= rayMask - 1)
+            {
+                packetMax = std::max(packetMax, closestSoFar[std::countr_zero(rayMask)]);
+            }
+            if(entry.TNear > static_cast<float>(packetMax) * SlabErrorScale)
+                continue;
+
+            const uint32_t candidates = interval.Valid ? interval.Intersect(node, tMin, static_cast<float>(packetMax)) : (1u << Width) - 1;
+            if(candidates == 0)
+                continue;
+
+            uint32_t childRays[Width] = {};
+            float    childNear[Width];
+            std::fill_n(childNear, Width, std::numeric_limits<float>::infinity());
+
+            for(uint32_t rayMask = entry.RayMask; rayMask != 0; rayMask &= rayMask - 1)
+            {
+                const int ray = std::countr_zero(rayMask);
+
+                alignas(32) float tNear[Width];
+                for(uint32_t mask = Kernel::Intersect(node, wideRays[ray], tMin, static_cast<float>(closestSoFar[ray]), tNear) & candidates; mask != 0; mask &= mask - 1)
+                {
+                    const int child   = std::countr_zero(mask);
+                    childRays[child] |= 1u << ray;
+                    childNear[child]  = std::min(childNear[child], tNear[child]);
+                }
+            }
+
+            StackEntry children[Width];
+            int        childCount = 0;
+            for(int child = 0; child < Width; child++)
+            {
+                if(childRays[child] == 0)
+                    continue;
+
+                if(node.PrimitiveCount[child] == 0)
+                {
+                    children[childCount++] = {node.Offset[child], childRays[child], childNear[child]};
+                    continue;
+                }
+
+                for(uint32_t rayMask = childRays[child]; rayMask != 0; rayMask &= rayMask - 1)
+                {
+                    const int ray = std::countr_zero(rayMask);
+                    for(uint32_t i = 0; i < node.PrimitiveCount[child]; i++)
+                    {
+                        if(primitives[node.Offset[child] + i]->Hit(packet.Rays[ray], Math::Interval(rayT.Min, closestSoFar[ray]), records[ray]))
+                        {
+                            hits[ray]         = true;
+                            closestSoFar[ray] = records[ray].T;
+                        }
+                    }
+                }
+            }
+
+            // Push the farthest child first, so the nearest one is visited next.
+            for(int i = 1; i < childCount; i++)
+            {
+                const StackEntry child = children[i];
+                int              j     = i - 1;
+                for(; j >= 0 && children[j].TNear < child.TNear; j--)
+                {
+                    children[j + 1] = children[j];
+                }
+                children[j + 1] = child;
+            }
+            for(int i = 0; i < childCount; i++)
+            {
+                stack[stackSize++] = children[i];
+            }
+        }
+    }
+
+    // The rays of a packet have times of their own, so packets through a moving tree are traced ray by ray.
+    template <int Width, typename Kernel>
+    void TraverseWideBVHMotionPacket(const WideBVH<Width>& bvh, const Render::RayPacket& packet, const Math::Interval rayT, Render::HitRecord* records, bool* hits)
+    {
+        for(int i = 0; i < packet.Size; i++)
+        {
+            hits[i] = TraverseWideBVH<Width, Kernel, true>(bvh, packet.Rays[i], rayT, records[i]);
+        }
+    }
+
+#if RT_ARCH_X86
+    template <bool Motion>
+    RT_TARGET_AVX2 RT_FLATTEN bool TraverseBVH8AVX2(const WideBVH<8>& bvh, const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord& rec)
+    {
+        return TraverseWideBVH<8, AVX2Kernel, Motion>(bvh, ray, rayT, rec);
+    }
+
+    template <bool Motion>
+    RT_TARGET_AVX2 RT_FLATTEN bool OccludedBVH8AVX2(const WideBVH<8>& bvh, const Render::Ray& ray, const Math::Interval rayT)
+    {
+        return OccludedWideBVH<8, AVX2Kernel, Motion>(bvh, ray, rayT);
+    }
+
+    RT_TARGET_AVX2 RT_FLATTEN void TraverseBVH8PacketAVX2(const WideBVH<8>& bvh, const Render::RayPacket& packet, const Math::Interval rayT, Render::HitRecord* records, bool* hits)
+    {
+        TraverseWideBVHPacket<8, AVX2Kernel>(bvh, packet, rayT, records, hits);
+    }
+
+    RT_TARGET_AVX2 RT_FLATTEN void TraverseBVH8MotionPacketAVX2(const WideBVH<8>& bvh, const Render::RayPacket& packet, const Math::Interval rayT, Render::HitRecord* records, bool* hits)
+    {
+        TraverseWideBVHMotionPacket<8, AVX2Kernel>(bvh, packet, rayT, records, hits);
+    }
+#endif
+
+    template <int Width, typename Kernel>
+    void SelectTraversal(const bool moving, typename WideBVH<Width>::TraverseFunction& traverse, typename WideBVH<Width>::TraversePacketFunction& traversePacket, typename WideBVH<Width>::OccludedFunction& occluded)
+    {
+        traverse       = moving ? &TraverseWideBVH<Width, Kernel, true> : &TraverseWideBVH<Width, Kernel, false>;
+        traversePacket = moving ? &TraverseWideBVHMotionPacket<Width, Kernel> : &TraverseWideBVHPacket<Width, Kernel>;
+        occluded       = moving ? &OccludedWideBVH<Width, Kernel, true> : &OccludedWideBVH<Width, Kernel, false>;
+    }
+
+    // Picks the fastest kernel the CPU supports and returns its name.
+    template <int Width>
+    const char* SelectKernel(const bool moving, typename WideBVH<Width>::TraverseFunction& traverse, typename WideBVH<Width>::TraversePacketFunction& traversePacket, typename WideBVH<Width>::OccludedFunction& occluded)
+    {
+#if RT_ARCH_X86
+        if constexpr(Width == 8)
+        {
+            if(Utils::GetCPUFeatures().AVX2)
+            {
+                traverse       = moving ? &TraverseBVH8AVX2<true> : &TraverseBVH8AVX2<false>;
+                traversePacket = moving ? &TraverseBVH8MotionPacketAVX2 : &TraverseBVH8PacketAVX2;
+                occluded       = moving ? &OccludedBVH8AVX2<true> : &OccludedBVH8AVX2<false>;
+                return AVX2Kernel::Name;
+            }
+        }
+
+        if(Utils::GetCPUFeatures().SSE2)
+        {
+            SelectTraversal<Width, SSEKernel>(moving, traverse, traversePacket, occluded);
+            return SSEKernel::Name;
+        }
+#endif
+
+        SelectTraversal<Width, ScalarKernel>(moving, traverse, traversePacket, occluded);
+        return ScalarKernel::Name;
+    }
+
+    // Unused child slots get inverted bounds, which fail the slab test for any ray direction.
+    template <int Width>
+    void ClearNode(WideBVHNode<Width>& node)
+    {
+        for(int axis = 0; axis < 3; axis++)
+        {
+            for(int child = 0; child < Width; child++)
+            {
+                node.Bounds[0][axis][child] = std::numeric_limits<float>::infinity();
+                node.Bounds[1][axis][child] = -std::numeric_limits<float>::infinity();
+            }
+        }
+        std::fill_n(node.Offset, Width, 0u);
+        std::fill_n(node.PrimitiveCount, Width, static_cast<uint8_t>(0));
+    }
+
+}    // namespace Impl
+
+template <int Width>
+WideBVH<Width>::WideBVH(const HittableList& list, const BVHBuildOptions& options)
+    : WideBVH(list.Objects, options)
+{
+}
+
+template <int Width>
+WideBVH<Width>::WideBVH(const std::vector<std::shared_ptr<Hittable>>& srcObjects, const BVHBuildOptions& options)
+{
+    std::vector<std::shared_ptr<Hittable>> primitives;
+    for(const auto& object : srcObjects)
+    {
+        LinearBVH::CollectPrimitives(object, primitives);
+    }
+
+    BVHBuilder builder(options);
+    Build(builder, primitives);
+
+    const bool  moving     = !m_NodeMotions.empty();
+    const char* kernelName = Impl::SelectKernel<Width>(moving, m_Traverse, m_TraversePacket, m_Occluded);
+
+    m_Stats           = builder.Stats();
+    m_Stats.NodeCount = m_Nodes.size();
+    m_Stats.Log("BVH" + std::to_string(Width) + (options.SplitMethod == BVHSplitMethod::SAH ? " (SAH, " : " (Median, ") + kernelName + (moving ? ", motion)" : ")"));
+}
+
+template <int Width>
+void WideBVH<Width>::Build(BVHBuilder& builder, const std::vector<std::shared_ptr<Hittable>>& primitives)
+{
+    m_BoundingBox = Math::AABB::Empty;
+    m_Nodes.clear();
+    m_NodeMotions.clear();
+    m_Primitives.clear();
+    m_PrimitivePtrs.clear();
+
+    if(primitives.empty())
+        return;
+
+    std::vector<Math::AABB> primitiveBounds;
+    MotionBuildBounds       motion;
+    const bool              moving = motion.Collect(primitives, primitiveBounds);
+
+    builder.Build(primitiveBounds);
+    if(builder.Nodes().empty())
+        return;
+    if(moving)
+        motion.Compute(builder);
+
+    m_Primitives.reserve(primitives.size());
+    m_PrimitivePtrs.reserve(primitives.size());
+    for(const auto index : builder.PrimitiveIndices())
+    {
+        m_Primitives.emplace_back(primitives[index]);
+        m_PrimitivePtrs.emplace_back(primitives[index].get());
+    }
+
+    Collapse(builder.Nodes(), moving ? &motion : nullptr, 0);
+    m_BoundingBox = builder.Nodes()[0].Bounds;
+
+    if(moving)
+    {
+        m_StartBox    = motion.NodeStart[0];
+        m_EndBox      = motion.NodeEnd[0];
+        m_BoundingBox = Math::AABB(m_StartBox, m_EndBox);
+    }
+}
+
+template <int Width>
+uint32_t WideBVH<Width>::Collapse(const std::vector<BVHBuildNode>& buildNodes, const MotionBuildBounds* motion, const uint32_t buildNodeIndex)
+{
+    const auto nodeIndex = static_cast<uint32_t>(m_Nodes.size());
+    m_Nodes.emplace_back();
+    Impl::ClearNode(m_Nodes[nodeIndex]);
+    if(motion)
+        m_NodeMotions.emplace_back() = {};
+
+    // Start from the two children of the binary node and keep opening the largest interior child until all slots
+    // are used, so the wide node covers the upper levels of the binary tree below it.
+    uint32_t children[Width];
+    int      childCount = 0;
+
+    const auto& buildNode = buildNodes[buildNodeIndex];
+    if(buildNode.IsLeaf())
+    {
+        children[childCount++] = buildNodeIndex;
+    }
+    else
+    {
+        children[childCount++] = buildNode.Offset;
+        children[childCount++] = buildNode.Offset + 1;
+    }
+
+    while(childCount < Width)
+    {
+        int    largest     = -1;
+        double largestArea = -1.0;
+        for(int i = 0; i < childCount; i++)
+        {
+            const auto& child = buildNodes[children[i]];
+            if(!child.IsLeaf() && SurfaceArea(child.Bounds) > largestArea)
+            {
+                largest     = i;
+                largestArea = SurfaceArea(child.Bounds);
+            }
+        }
+
+        if(largest < 0)
+            break;
+
+        const uint32_t opened  = children[largest];
+        children[largest]      = buildNodes[opened].Offset;
+        children[childCount++] = buildNodes[opened].Offset + 1;
+    }
+
+    for(int i = 0; i < childCount; i++)
+    {
+        const auto& child = buildNodes[children[i]];
+
+        uint32_t offset = child.Offset;
+        if(!child.IsLeaf())
+            offset = Collapse(buildNodes, motion, children[i]);
+
+        // The node vector may have grown, so the node is looked up again after the recursion.
+        auto& node = m_Nodes[nodeIndex];
+        if(motion)
+        {
+            const Math::AABB& start      = motion->NodeStart[children[i]];
+            const Math::AABB& end        = motion->NodeEnd[children[i]];
+            auto&             nodeMotion = m_NodeMotions[nodeIndex];
+            for(int axis = 0; axis < 3; axis++)
+            {
+                FloatMotionBound(start.AxisInterval(axis).Min, end.AxisInterval(axis).Min, false, node.Bounds[0][axis][i], nodeMotion.Delta[0][axis][i]);
+                FloatMotionBound(start.AxisInterval(axis).Max, end.AxisInterval(axis).Max, true, node.Bounds[1][axis][i], nodeMotion.Delta[1][axis][i]);
+            }
+        }
+        else
+        {
+            for(int axis = 0; axis < 3; axis++)
+            {
+                node.Bounds[0][axis][i] = FloatRoundDown(child.Bounds.AxisInterval(axis).Min);
+                node.Bounds[1][axis][i] = FloatRoundUp(child.Bounds.AxisInterval(axis).Max);
+            }
+        }
+        node.Offset[i]         = offset;
+        node.PrimitiveCount[i] = static_cast<uint8_t>(child.PrimitiveCount);
+    }
+
+    return nodeIndex;
+}
+
+template <int Width>
+bool WideBVH<Width>::Hit(const Render::Ray& ray, const Math::Interval rayT, Render::HitRecord& rec) const
+{
+    return m_Traverse(*this, ray, rayT, rec);
+}
+
+template <int Width>
+bool WideBVH<Width>::Occluded(const Render::Ray& ray, const Math::Interval rayT) const
+{
+    return m_Occluded(*this, ray, rayT);
+}
+
+template <int Width>
+void WideBVH<Width>::HitPacket(const Render::RayPacket& packet, const Math::Interval rayT, Render::HitRecord* records, bool* hits) const
+{
+    m_TraversePacket(*this, packet, rayT, records, hits);
+}
+
+template <int Width>
+Math::AABB WideBVH<Width>::BoundingBox() const
+{
+    return m_BoundingBox;
+}
+
+template <int Width>
+bool WideBVH<Width>::MotionBounds(Math::AABB& start, Math::AABB& end) const
+{
+    if(m_NodeMotions.empty())
+        return false;
+
+    start = m_StartBox;
+    end   = m_EndBox;
+    return true;
+}
+
+// Scenes assign ids before compiling the world, this covers prebuilt trees placed by instances.
+template <int Width>
+void WideBVH<Width>::AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId)
+{
+    for(const auto& primitive : m_Primitives)
+    {
+        primitive->AssignIds(materials, nextPrimitiveId);
+    }
+}
+
+template class WideBVH<4>;
+template class WideBVH<8>;
+
+}    // namespace Objects
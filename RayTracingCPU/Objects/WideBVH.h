@@ -0,0 +1,94 @@
+#pragma once
+
+#include "BVHBuild.h"
+#include "Hittable.h"
+#include "HittableList.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Objects
+{
+
+// Node of a BVH with up to Width children. The child bounds are stored as SoA float lanes, so that one ray can be
+// tested against all children of a node with a single SIMD instruction per slab.
+template <int Width>
+struct alignas(32) WideBVHNode
+{
+    float    Bounds[2][3][Width];      // [min, max][axis][child], unused slots have inverted bounds and are never hit
+    uint32_t Offset[Width];            // Leaf child: index of the first primitive. Interior child: index of the node.
+    uint8_t  PrimitiveCount[Width];    // Zero for interior children and unused slots
+};
+
+static_assert(sizeof(WideBVHNode<4>) == 128, "WideBVHNode<4> must fit into two cache lines");
+static_assert(sizeof(WideBVHNode<8>) == 256, "WideBVHNode<8> must fit into four cache lines");
+
+// Motion of the child bounds of a WideBVHNode, for trees over moving primitives. The node then holds the bounds at
+// time 0, and the bounds at time t are Bounds + t * Delta. Both are widened by the rounding error of that product.
+template <int Width>
+struct alignas(32) WideBVHNodeMotion
+{
+    float Delta[2][3][Width];    // [min, max][axis][child], zero for unused slots
+};
+
+// BVH4/BVH8 collapsed from the binary build tree. The traversal kernel is picked once at construction from the
+// instruction sets of the CPU: AVX2 for 8-wide nodes, SSE for 4-wide nodes, and a scalar loop everywhere else.
+// If any primitive moves, the tree is built over the bounds halfway through the motion and every node stores the
+// motion of its child bounds, which the rays interpolate at their own time instead of testing the whole swept box.
+template <int Width>
+class WideBVH final : public Hittable
+{
+public:
+    static_assert(Width == 4 || Width == 8, "WideBVH supports 4 and 8 children per node");
+
+    using Node       = WideBVHNode<Width>;
+    using NodeMotion = WideBVHNodeMotion<Width>;
+
+    explicit WideBVH(const HittableList& list, const BVHBuildOptions& options = {});
+    explicit WideBVH(const std::vector<std::shared_ptr<Hittable>>& srcObjects, const BVHBuildOptions& options = {});
+
+    bool       Hit(const Render::Ray& ray, Math::Interval rayT, Render::HitRecord& rec) const override;
+    bool       Occluded(const Render::Ray& ray, Math::Interval rayT) const override;
+    Math::AABB BoundingBox() const override;
+    bool       MotionBounds(Math::AABB& start, Math::AABB& end) const override;
+    void       AssignIds(Render::MaterialTable& materials, uint32_t& nextPrimitiveId) override;
+
+    // Traverses the tree once for the whole packet. Children missed by the interval bounds of all rays are culled
+    // without testing the rays one by one.
+    void HitPacket(const Render::RayPacket& packet, Math::Interval rayT, Render::HitRecord* records, bool* hits) const override;
+
+    size_t NodeCount() const { return m_Nodes.size(); }
+    size_t PrimitiveCount() const { return m_Primitives.size(); }
+
+    const std::vector<Node>&            Nodes() const { return m_Nodes; }
+    const std::vector<NodeMotion>&      NodeMotions() const { return m_NodeMotions; }    // Empty if nothing moves
+    const std::vector<const Hittable*>& PrimitivePtrs() const { return m_PrimitivePtrs; }
+    const BVHBuildStats&                Stats() const { return m_Stats; }
+
+    // Traversal of one ray and of a ray packet, and the any-hit traversal, implemented once per SIMD kernel.
+    using TraverseFunction       = bool (*)(const WideBVH& bvh, const Render::Ray& ray, Math::Interval rayT, Render::HitRecord& rec);
+    using TraversePacketFunction = void (*)(const WideBVH& bvh, const Render::RayPacket& packet, Math::Interval rayT, Render::HitRecord* records, bool* hits);
+    using OccludedFunction       = bool (*)(const WideBVH& bvh, const Render::Ray& ray, Math::Interval rayT);
+
+private:
+    std::vector<Node>                      m_Nodes;
+    std::vector<NodeMotion>                m_NodeMotions;
+    std::vector<std::shared_ptr<Hittable>> m_Primitives;       // Keeps the primitives alive, ordered as referenced by leaves
+    std::vector<const Hittable*>           m_PrimitivePtrs;    // Raw pointers used during traversal
+    Math::AABB                             m_BoundingBox;
+    Math::AABB                             m_StartBox;    // Bounds at time 0 and time 1 of trees over moving primitives
+    Math::AABB                             m_EndBox;
+    BVHBuildStats                          m_Stats;
+    TraverseFunction                       m_Traverse       = nullptr;
+    TraversePacketFunction                 m_TraversePacket = nullptr;
+    OccludedFunction                       m_Occluded       = nullptr;
+
+    void     Build(BVHBuilder& builder, const std::vector<std::shared_ptr<Hittable>>& primitives);
+    uint32_t Collapse(const std::vector<BVHBuildNode>& buildNodes, const MotionBuildBounds* motion, uint32_t buildNodeIndex);
+};
+
+using BVH4 = WideBVH<4>;
+using BVH8 = WideBVH<8>;
+
+}    // namespace Objects
@@ -2,10 +2,11 @@
 
 #include "HitRecord.h"
 #include "Material.h"
+#include "MaterialTable.h"
+#include "RayPacket.h"
 #include "ScatterRecord.h"
 
 #include <Math/Converters.h>
-#include <Math/CosinePDF.h>
 #include <Math/HittablePDF.h>
 #include <Math/MixturePDF.h>
 #include <Objects/Hittable.h>
@@ -13,9 +14,26 @@
 #include <Utils/Log.h>
 #include <Utils/Random.h>
 
+#include <algorithm>
+
 namespace Render
 {
 
+namespace Impl
+{
+
+    // Relative distance short of the light at which shadow rays stop.
+    constexpr Math::Real ShadowRayEpsilon = 1e-4;
+
+    // Weight of a sample taken with density pdf against a second strategy with density otherPDF, one sample each.
+    Math::Real PowerHeuristic(const Math::Real pdf, const Math::Real otherPDF)
+    {
+        const Math::Real pdfSquared = pdf * pdf;
+        return pdfSquared / (pdfSquared + otherPDF * otherPDF);
+    }
+
+}    // namespace Impl
+
 // TODO: Original Renderer. Need to take PPM code from here.
 // void Camera::Render(const Hittable& world, const hittable& lights)
 // {
@@ -67,6 +85,10 @@ void Camera::Initialize()
     SqrtSppScale      = 1.0 / (SqrtSpp * SqrtSpp);
     m_RecipSqrtSpp    = 1.0 / SqrtSpp;
 
+    // The variance of a pixel needs at least two samples.
+    AdaptiveMinSpp = std::max(AdaptiveMinSpp, 2);
+    AdaptiveMaxSpp = std::max(AdaptiveMaxSpp, AdaptiveMinSpp);
+
     // Calculate the u,v,w unit basis vectors for the camera coordinate frame.
     m_W = Math::UnitVector(LookFrom - LookAt);
     m_U = Math::UnitVector(Math::CrossProduct(VUp, m_W));
@@ -91,29 +113,101 @@ void Camera::Initialize()
     // LOG_INFO("Camera. PDF={}, ULight={}, SqrtSpp={}, RecipSqrtSpp={}, Samples={}", UsePDF, UseUnidirectionalLight,SqrtSpp, m_RecipSqrtSpp, SamplesPerPixel);
 }
 
-uint32_t Camera::GetPixel(const uint32_t x, const uint32_t y, const Objects::Hittable& world, const Objects::HittableList& lights) const
+Color3 Camera::GetPixel(const uint32_t x, const uint32_t y, const Objects::Hittable& world, const Objects::HittableList& lights) const
 {
     Color3 pixelColor(0, 0, 0);
+    for(int sample = 0; sample < PixelSampleCount(); sample++)
+    {
+        pixelColor += SamplePixel(x, y, sample, world, lights);
+    }
+    return pixelColor * this->PixelSamplesScale;
+}
+
+Color3 Camera::SamplePixel(const uint32_t x, const uint32_t y, const int sample, const Objects::Hittable& world, const Objects::HittableList& lights) const
+{
+    BeginSampleStream(x, y, sample, SampleStage::CameraRay);
+    const Ray r = SamplingType == SamplerType::Stratified ? GetRay(static_cast<int>(x), static_cast<int>(y), sample % SqrtSpp, sample / SqrtSpp)
+                                                          : GetRay(static_cast<int>(x), static_cast<int>(y));
+
+    BeginSampleStream(x, y, sample, SampleStage::Path);
+    const Color3 color = RayColor(r, MaxDepth, world, lights);
+
+    EndSampleStream();
+    return color;
+}
+
+void Camera::SamplePixelBlock(const uint32_t x, const uint32_t y, Color3* colors, const Objects::Hittable& world, const Objects::HittableList& lights) const
+{
+    const int blockWidth  = PacketWidth();
+    const int blockHeight = PacketHeight();
+
+    // Blocks on the right and bottom edges of the image are clipped.
+    const int width  = std::min(blockWidth, ImageWidth - static_cast<int>(x));
+    const int height = std::min(blockHeight, m_ImageHeight - static_cast<int>(y));
+
+    // The accumulation sampler renders one sample per frame, the frame number picks its random stream.
+    int sampleCount = SamplesPerPixel;
+    int firstSample = 0;
     if(SamplingType == SamplerType::Stratified)
     {
-        for(int yS = 0; yS < this->SqrtSpp; yS++)
+        sampleCount = SqrtSpp * SqrtSpp;
+    }
+    else if(SamplingType == SamplerType::Accumulation)
+    {
+        sampleCount = 1;
+        firstSample = SamplesPerPixel - 1;
+    }
+
+    RayPacket packet;
+    packet.Size = width * height;
+
+    HitRecord records[RayPacket::MaxSize];
+    bool      hits[RayPacket::MaxSize];
+
+    for(int sample = firstSample; sample < firstSample + sampleCount; sample++)
+    {
+        for(int j = 0; j < height; j++)
         {
-            for(int xS = 0; xS < this->SqrtSpp; xS++)
+            for(int i = 0; i < width; i++)
             {
-                Ray r = this->GetRay(static_cast<int>(x), static_cast<int>(y), xS, yS);
-                pixelColor += this->RayColor(r, this->MaxDepth, world, lights);
+                const int px = static_cast<int>(x) + i;
+                const int py = static_cast<int>(y) + j;
+
+                BeginSampleStream(px, py, sample, SampleStage::CameraRay);
+                packet.Rays[j * width + i] = SamplingType == SamplerType::Stratified ? GetRay(px, py, sample % SqrtSpp, sample / SqrtSpp) : GetRay(px, py);
             }
         }
-    }
-    else
-    {
-        for(int sample = 0; sample < this->SamplesPerPixel; sample++)
+
+        world.HitPacket(packet, Math::Interval(0, Math::Infinity), records, hits);
+
+        for(int j = 0; j < height; j++)
         {
-            Ray r = this->GetRay(static_cast<int>(x), static_cast<int>(y));
-            pixelColor += this->RayColor(r, this->MaxDepth, world, lights);
+            for(int i = 0; i < width; i++)
+            {
+                const int index = j * width + i;
+
+                BeginSampleStream(x + i, y + j, sample, SampleStage::Path);
+                if(MaxDepth > 0)
+                    colors[j * blockWidth + i] += hits[index] ? ShadeHit(packet.Rays[index], records[index], MaxDepth, world, lights) : Background;
+            }
         }
     }
-    return GetColorRGBA(pixelColor, this->PixelSamplesScale);
+    EndSampleStream();
+}
+
+void Camera::BeginSampleStream(const uint32_t x, const uint32_t y, const int sample, const SampleStage stage) const
+{
+    if(!DeterministicSampling)
+        return;
+
+    const uint64_t pixel = static_cast<uint64_t>(y) * static_cast<uint64_t>(ImageWidth) + x;
+    Utils::Random::BeginStream(Utils::Random::StreamKey(Seed, pixel, static_cast<uint32_t>(sample), static_cast<uint32_t>(stage)));
+}
+
+void Camera::EndSampleStream() const
+{
+    if(DeterministicSampling)
+        Utils::Random::EndStream();
 }
 
 // Construct a camera ray originating from the defocus disk and directed at a randomly
@@ -140,9 +234,9 @@ Ray Camera::GetRay(const int x, const int y, const int xS, const int yS) const
                              + ((x + pixelSampleOffset.X()) * m_PixelDeltaU)
                              + ((y + pixelSampleOffset.Y()) * m_PixelDeltaV);
 
-    auto       rayOrigin    = (DefocusAngle <= 0) ? m_Center : DefocusDiskSample();
-    const auto rayDirection = pixelSample - rayOrigin;
-    const auto rayTime      = Utils::Random::Double();
+    auto             rayOrigin    = (DefocusAngle <= 0) ? m_Center : DefocusDiskSample();
+    const auto       rayDirection = pixelSample - rayOrigin;
+    const Math::Real rayTime      = Utils::Random::Double();
 
     return {rayOrigin, rayDirection, rayTime};
 }
@@ -157,11 +251,13 @@ Color3 Camera::RayColorGradientBackground(const Ray& r, const int depth, const O
 
     HitRecord rec;
 
-    if(world.Hit(r, Math::Interval(0.001, Math::Infinity), rec))
+    if(world.Hit(r, Math::Interval(0, Math::Infinity), rec))
     {
+        const Material* material = GetMaterial(rec);
+
         Ray    scattered;
         Color3 attenuation;
-        if(rec.GetMaterial()->Scatter(r, rec, attenuation, scattered))
+        if(material->Scatter(r, rec, attenuation, scattered))
         {
             return attenuation * RayColorGradientBackground(scattered, depth - 1, world);
         }
@@ -186,80 +282,262 @@ Color3 Camera::RayColor(const Ray& r, const int depth, const Objects::Hittable&
     HitRecord rec;
 
     // If the ray hits nothing, return the background color.
-    if(!world.Hit(r, Math::Interval(0.001, Math::Infinity), rec))
+    if(!world.Hit(r, Math::Interval(0, Math::Infinity), rec))
     {
         return Background;
     }
 
-    Color3 colorFromEmission;
-    Color3 colorFromScatter;
+    return ShadeHit(r, rec, depth, world, lights);
+}
 
-    if(UseUnidirectionalLight)
+Color3 Camera::ShadeHit(const Ray& r, HitRecord& rec, const int depth, const Objects::Hittable& world, const Objects::HittableList& lights) const
+{
+    // Next-event estimation needs the densities of the materials.
+    if(Integrator == IntegratorType::NextEvent && UsePDF)
     {
-        colorFromEmission = rec.GetMaterial()->Emitted(r, rec, rec.U, rec.V, rec.P);
+        return TracePathNextEvent(r, rec, depth, world, lights);
     }
-    else
+
+    if(Integrator != IntegratorType::Recursive)
     {
-        colorFromEmission = rec.GetMaterial()->Emitted(rec.U, rec.V, rec.P);
+        return TracePath(r, rec, depth, world, lights);
     }
 
-    if(UsePDF)
+    const Material* material = GetMaterial(rec);
+    const Color3    emitted  = EmittedColor(*material, r, rec);
+
+    Ray    scattered;
+    Color3 weight;
+    if(!ScatterRay(*material, r, rec, lights, scattered, weight))
     {
-        ScatterRecord srec;
+        return emitted;
+    }
+
+    return emitted + weight * RayColor(scattered, depth - 1, world, lights);
+}
+
+Color3 Camera::TracePath(Ray r, HitRecord rec, int depth, const Objects::Hittable& world, const Objects::HittableList& lights) const
+{
+    Color3 color(0, 0, 0);
+    Color3 throughput(1, 1, 1);
+
+    for(int bounce = 0;; bounce++)
+    {
+        const Material* material = GetMaterial(rec);
+        color += throughput * EmittedColor(*material, r, rec);
 
-        if(!rec.GetMaterial()->Scatter(r, rec, srec))
+        Ray    scattered;
+        Color3 weight;
+        if(!ScatterRay(*material, r, rec, lights, scattered, weight) || --depth <= 0)
+        {
+            break;
+        }
+        throughput = throughput * weight;
+        if(!ContinuePath(bounce, throughput))
         {
-            return colorFromEmission;
+            break;
         }
 
-        if(srec.SkipPDF)
+        r = scattered;
+        if(!world.Hit(r, Math::Interval(0, Math::Infinity), rec))
         {
-            return srec.Attenuation * RayColor(srec.SkipPDFRay, depth - 1, world, lights);
+            color += throughput * Background;
+            break;
         }
+    }
+
+    return color;
+}
+
+Color3 Camera::TracePathNextEvent(Ray r, HitRecord rec, int depth, const Objects::Hittable& world, const Objects::HittableList& lights) const
+{
+    const bool sampleLights = !lights.Objects.empty();
+
+    Color3       color(0, 0, 0);
+    Color3       throughput(1, 1, 1);
+    Math::Real   scatterPDF = 0;    // Density of the material sample that reached rec, zero for camera rays and specular bounces
+    Math::Point3 scatterOrigin;
 
-        std::shared_ptr<Math::PDF> pdfPtr;
-        if(lights.Objects.empty())
+    for(int bounce = 0;; bounce++)
+    {
+        const Material* material = GetMaterial(rec);
+
+        // The light sample of the previous bounce may have reached this emitter too, the weights of both add up to one.
+        Color3 emitted = EmittedColor(*material, r, rec);
+        if(sampleLights && scatterPDF > 0 && emitted.LengthSquared() > 0)
         {
-            // const CosinePDF surfacePDF(rec.Normal);
-            // const Ray       scattered = Ray(rec.P, surfacePDF.Generate(), r.Time());
-            // const auto      pdfVal    = surfacePDF.Value(scattered.Direction());
-            pdfPtr = std::make_shared<Math::CosinePDF>(rec.Normal);
+            emitted *= Impl::PowerHeuristic(scatterPDF, lights.PDFValue(scatterOrigin, r.Direction()));
         }
-        else
+        color += throughput * emitted;
+
+        ScatterRecord srec;
+        if(!material->Scatter(r, rec, srec) || --depth <= 0)
+        {
+            break;
+        }
+
+        Ray    scattered;
+        Color3 weight;
+        if(srec.SkipPDF)
         {
-            pdfPtr = std::make_shared<Math::HittablePDF>(lights, rec.P);
+            scattered  = srec.SkipPDFRay;
+            weight     = srec.Attenuation;
+            scatterPDF = 0;
         }
+        else
+        {
+            if(sampleLights)
+            {
+                color += throughput * SampleLight(*material, r, rec, srec, world, lights);
+            }
 
-        const Math::MixturePDF mixedPDF(pdfPtr, srec.PDFPtr);
+            scattered  = rec.SpawnRay(srec.ScatterPDF.Generate(), r.Time());
+            scatterPDF = srec.ScatterPDF.Value(scattered.Direction());
+
+            // Scattering is impossible
+            if(std::isnan(scatterPDF) || scatterPDF <= 0)
+            {
+                break;
+            }
+
+            weight        = srec.Attenuation * material->ScatteringPDF(r, rec, scattered) / scatterPDF;
+            scatterOrigin = rec.P;
+        }
 
-        const Ray  scattered = Ray(rec.P, mixedPDF.Generate(), r.Time());
-        const auto pdfVal    = mixedPDF.Value(scattered.Direction());
+        throughput = throughput * weight;
+        if(!ContinuePath(bounce, throughput))
+        {
+            break;
+        }
 
-        // Scattering is impossible
-        if(std::isnan(pdfVal) || Math::DoubleUtils::isEqual(pdfVal, 0.0, Math::DoubleUtils::DefaultTolerance()))
+        r = scattered;
+        if(!world.Hit(r, Math::Interval(0, Math::Infinity), rec))
         {
-            return colorFromEmission;
+            color += throughput * Background;
+            break;
         }
+    }
+
+    return color;
+}
 
-        const double scatteringPDF = rec.GetMaterial()->ScatteringPDF(r, rec, scattered);
+bool Camera::ContinuePath(const int bounce, Color3& throughput) const
+{
+    if(!UseRussianRoulette || bounce < RussianRouletteDepth)
+    {
+        return true;
+    }
 
-        const Color3 sampleColor = RayColor(scattered, depth - 1, world, lights);
-        colorFromScatter         = (srec.Attenuation * scatteringPDF * sampleColor) / pdfVal;
+    const Math::Real survival = std::min<Math::Real>(1, std::max({throughput.X(), throughput.Y(), throughput.Z()}));
+    if(Utils::Random::Double() >= survival)
+    {
+        return false;
+    }
+    throughput /= survival;
+    return true;
+}
+
+Color3 Camera::EmittedColor(const Material& material, const Ray& r, const HitRecord& rec) const
+{
+    if(UseUnidirectionalLight)
+    {
+        return material.Emitted(r, rec, rec.U, rec.V, rec.P);
+    }
+    return material.Emitted(rec.U, rec.V, rec.P);
+}
+
+bool Camera::ScatterRay(const Material& material, const Ray& r, const HitRecord& rec, const Objects::HittableList& lights, Ray& scattered, Color3& weight) const
+{
+    if(!UsePDF)
+    {
+        return material.Scatter(r, rec, weight, scattered);
+    }
+
+    ScatterRecord srec;
+    if(!material.Scatter(r, rec, srec))
+    {
+        return false;
+    }
+
+    if(srec.SkipPDF)
+    {
+        scattered = srec.SkipPDFRay;
+        weight    = srec.Attenuation;
+        return true;
+    }
+
+    Math::PDF lightPDF;
+    if(lights.Objects.empty())
+    {
+        lightPDF = Math::CosinePDF(rec.Normal);
     }
     else
     {
-        Ray    scattered;
-        Color3 attenuation;
+        lightPDF = Math::HittablePDF(lights, rec.P);
+    }
 
-        if(!rec.GetMaterial()->Scatter(r, rec, attenuation, scattered))
-        {
-            return colorFromEmission;
-        }
+    const Math::MixturePDF mixedPDF(lightPDF, srec.ScatterPDF);
 
-        colorFromScatter = attenuation * RayColor(scattered, depth - 1, world, lights);
+    scattered         = rec.SpawnRay(mixedPDF.Generate(), r.Time());
+    const auto pdfVal = mixedPDF.Value(scattered.Direction());
+
+    // Scattering is impossible
+    if(std::isnan(pdfVal) || Math::DoubleUtils::isEqual(pdfVal, 0.0, Math::DoubleUtils::DefaultTolerance()))
+    {
+        return false;
     }
 
-    return colorFromEmission + colorFromScatter;
+    weight = srec.Attenuation * material.ScatteringPDF(r, rec, scattered) / pdfVal;
+    return true;
+}
+
+// The shadow ray is intersected with the lights, which are the emitters of the scene and carry their materials, for the
+// emission and the distance to the light. The world then only has to tell whether anything lies in between.
+Color3 Camera::SampleLight(const Material& material, const Ray& r, const HitRecord& rec, const ScatterRecord& srec, const Objects::Hittable& world, const Objects::HittableList& lights) const
+{
+    const Math::HittablePDF lightPDF(lights, rec.P);
+
+    const Ray        shadowRay    = rec.SpawnRay(lightPDF.Generate(), r.Time());
+    const Math::Real lightDensity = lightPDF.Value(shadowRay.Direction());
+    if(std::isnan(lightDensity) || lightDensity <= 0)
+    {
+        return {0, 0, 0};
+    }
+
+    // Directions the material does not scatter into need no shadow ray.
+    const Math::Real scattering = material.ScatteringPDF(r, rec, shadowRay);
+    if(scattering <= 0)
+    {
+        return {0, 0, 0};
+    }
+
+    HitRecord lightRec;
+    if(!lights.Hit(shadowRay, Math::Interval(0, Math::Infinity), lightRec))
+    {
+        return {0, 0, 0};
+    }
+
+    // Extra targets may have no material and emit nothing.
+    const Material* lightMaterial = GetMaterial(lightRec);
+    if(!lightMaterial)
+    {
+        return {0, 0, 0};
+    }
+
+    const Color3 emitted = EmittedColor(*lightMaterial, shadowRay, lightRec);
+    if(emitted.LengthSquared() <= 0)
+    {
+        return {0, 0, 0};
+    }
+
+    // Stop short of the light, whose own surface is part of the world too.
+    if(world.Occluded(shadowRay, Math::Interval(0, lightRec.T * (1 - Impl::ShadowRayEpsilon))))
+    {
+        return {0, 0, 0};
+    }
+
+    const Math::Real weight = Impl::PowerHeuristic(lightDensity, srec.ScatterPDF.Value(shadowRay.Direction()));
+    return srec.Attenuation * emitted * (scattering * weight / lightDensity);
 }
 
 // Returns a random point in the camera defocus disk.
@@ -269,18 +547,25 @@ Math::Point3 Camera::DefocusDiskSample() const
     return m_Center + (p[0] * m_DefocusDiskU) + (p[1] * m_DefocusDiskV);
 }
 
+const Material* Camera::GetMaterial(const HitRecord& rec) const
+{
+    return Materials->Get(rec.MaterialIndex);
+}
+
 // Returns the vector to a random point in the [-0.5,-0.5]-[+0.5,+0.5] unit square.
 Math::Vector3 Camera::SampleSquare() const
 {
-    return {Utils::Random::Double() - 0.5, Utils::Random::Double() - 0.5, 0};
+    const Math::Real px = Utils::Random::Double() - 0.5;
+    const Math::Real py = Utils::Random::Double() - 0.5;
+    return {px, py, 0};
 }
 
 // Returns the vector to a random point in the square sub-pixel specified by grid
 // indices xS and yS, for an idealized unit square pixel [-0.5,-0.5] to [+0.5,+0.5]
 Math::Vector3 Camera::SampleSquare(const int xS, const int yS) const
 {
-    const auto px = ((xS + Utils::Random::Double()) * m_RecipSqrtSpp) - 0.5;
-    const auto py = ((yS + Utils::Random::Double()) * m_RecipSqrtSpp) - 0.5;
+    const Math::Real px = ((xS + Utils::Random::Double()) * m_RecipSqrtSpp) - 0.5;
+    const Math::Real py = ((yS + Utils::Random::Double()) * m_RecipSqrtSpp) - 0.5;
     return {px, py, 0};
 }
 
@@ -294,8 +579,8 @@ Math::Vector3 Camera::SampleDisk() const
 // indices xS and yS, for an idealized unit circle pixel [-0.5,-0.5] to [+0.5,+0.5]
 Math::Vector3 Camera::SampleDisk(const int xS, const int yS) const
 {
-    const auto px = ((xS + Math::RandomInUnitDisk().X()) * m_RecipSqrtSpp) - 0.5;
-    const auto py = ((yS + Math::RandomInUnitDisk().Y()) * m_RecipSqrtSpp) - 0.5;
+    const Math::Real px = ((xS + Math::RandomInUnitDisk().X()) * m_RecipSqrtSpp) - 0.5;
+    const Math::Real py = ((yS + Math::RandomInUnitDisk().Y()) * m_RecipSqrtSpp) - 0.5;
     return {px, py, 0};
 }
 
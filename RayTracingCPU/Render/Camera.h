@@ -5,6 +5,8 @@
 
 #include <Math/Vector3.h>
 
+#include <cstdint>
+
 namespace Objects
 {
 class Hittable;
@@ -14,6 +16,11 @@ class HittableList;
 namespace Render
 {
 
+class HitRecord;
+class Material;
+class MaterialTable;
+class ScatterRecord;
+
 class Camera
 {
 public:
@@ -21,14 +28,23 @@ public:
     {
         CPUOneCore   = 0,
         CPUMultiCore = 1,
-        GPU          = 2
+        GPU          = 2,
+        CPUPackets   = 3    // Multi-core, primary rays are traced as packets of PacketSize rays
     };
 
     enum class SamplerType : int
     {
         Normal       = 0,
         Accumulation = 1,
-        Stratified   = 2
+        Stratified   = 2,
+        Adaptive     = 3    // Samples noisy pixels more often, see the Adaptive* settings
+    };
+
+    enum class IntegratorType : int
+    {
+        Recursive = 0,    // Gathers the color of each bounce on the way back up the call stack
+        Iterative = 1,    // Follows the path in a loop carrying its throughput, supports Russian roulette
+        NextEvent = 2     // Iterative, with a light sample at every diffuse bounce combined by multiple importance sampling
     };
 
     double AspectRatio       = 1.0;    // Ratio of image width over height
@@ -38,13 +54,27 @@ public:
     int    SqrtSpp           = 3;      // Square root of number of samples per pixel
     double SqrtSppScale      = 1.0;    // 1.0 / SamplesPerPixel or 1.0 / SqrtSpp * SqrtSpp:
     int    MaxDepth          = 10;     // Maximum number of ray bounces into scene
+    int    PacketSize        = 16;     // Rays per primary ray packet: 4 (2x2 pixels), 8 (4x2 pixels) or 16 (4x4 pixels)
     Color3 Background;                 // Scene background color
 
-    RenderType  RenderingType = RenderType::CPUMultiCore;
-    SamplerType SamplingType  = SamplerType::Stratified;
+    int    AdaptiveMinSpp    = 16;       // Samples every pixel takes before the adaptive sampler may stop it, at least 2
+    int    AdaptiveMaxSpp    = 1024;     // Most samples the adaptive sampler spends on one pixel
+    double AdaptiveThreshold = 0.005;    // Standard error of the displayed brightness [0, 1] of a converged pixel
+    bool   ShowSampleCount   = false;    // Shows the samples per pixel of the adaptive sampler as a heat map
+
+    RenderType     RenderingType = RenderType::CPUMultiCore;
+    SamplerType    SamplingType  = SamplerType::Stratified;
+    IntegratorType Integrator    = IntegratorType::NextEvent;
 
     bool UsePDF                 = true;    // Use probability density function for sampling
     bool UseUnidirectionalLight = true;    // Use unidirectional light sampling
+    bool UseRussianRoulette     = true;    // Let the iterative integrator end paths early, without bias
+    int  RussianRouletteDepth   = 3;       // Bounces every path takes before Russian roulette may end it
+
+    bool     DeterministicSampling = false;    // Random numbers depend only on Seed, pixel and sample, never on threads
+    uint64_t Seed                  = 0;        // Seed of the deterministic sampling
+
+    const MaterialTable* Materials = nullptr;    // Resolves HitRecord::MaterialIndex, owned by the scene
 
     double        Vfov     = 90;                        // Vertical view angle (field of view)
     Math::Vector3 LookFrom = Math::Point3(0, 0, 0);     // Point camera is looking from
@@ -56,8 +86,23 @@ public:
 
     void Initialize();
 
-    // Get RGBA color value for the pixel at location x,y.
-    uint32_t GetPixel(uint32_t x, uint32_t y, const Objects::Hittable& world, const Objects::HittableList& lights) const;
+    // Color of the pixel at location x,y, averaged over its samples.
+    Color3 GetPixel(uint32_t x, uint32_t y, const Objects::Hittable& world, const Objects::HittableList& lights) const;
+
+    // Samples GetPixel takes per pixel, the stratified sampler rounds SamplesPerPixel down to a square.
+    int PixelSampleCount() const { return SamplingType == SamplerType::Stratified ? SqrtSpp * SqrtSpp : SamplesPerPixel; }
+
+    // Color of a single sample of the pixel at location x,y. The stratified sampler takes the stratum from the sample index.
+    Color3 SamplePixel(uint32_t x, uint32_t y, int sample, const Objects::Hittable& world, const Objects::HittableList& lights) const;
+
+    // Size of the pixel block covered by one primary ray packet.
+    int PacketWidth() const { return PacketSize >= 8 ? 4 : 2; }
+    int PacketHeight() const { return PacketSize >= 16 ? 4 : 2; }
+
+    // Adds the sample colors of the pixel block at location x,y to colors, a row-major PacketWidth x PacketHeight array.
+    // The primary rays of every sample are traced as one packet, the rest of the paths one ray at a time.
+    // The accumulation sampler takes a single sample, the others take all samples of a pixel.
+    void SamplePixelBlock(uint32_t x, uint32_t y, Color3* colors, const Objects::Hittable& world, const Objects::HittableList& lights) const;
 
     // Get a randomly-sampled camera ray for the pixel at location x,y, originating from the camera defocus disk.
     Ray GetRay(int x, int y, int xS = 0, int yS = 0) const;
@@ -65,7 +110,25 @@ public:
     Color3 RayColorGradientBackground(const Ray& r, int depth, const Objects::Hittable& world) const;
     Color3 RayColor(const Ray& r, int depth, const Objects::Hittable& world, const Objects::HittableList& lights) const;
 
+    // Color gathered along a ray whose closest hit is already known.
+    Color3 ShadeHit(const Ray& r, HitRecord& rec, int depth, const Objects::Hittable& world, const Objects::HittableList& lights) const;
+
+    // Iterative version of ShadeHit, the color of the path is the emission of each hit weighted by the throughput.
+    Color3 TracePath(Ray r, HitRecord rec, int depth, const Objects::Hittable& world, const Objects::HittableList& lights) const;
+
+    // TracePath with next-event estimation: every non-specular bounce samples a light with a shadow ray and the
+    // material with the next path ray. Both can reach the same emitter, so both are weighted by the power heuristic.
+    // Specular bounces only follow the material.
+    Color3 TracePathNextEvent(Ray r, HitRecord rec, int depth, const Objects::Hittable& world, const Objects::HittableList& lights) const;
+
 private:
+    // Stages of a pixel sample with separate random streams, so the camera ray never shifts the numbers of the path.
+    enum class SampleStage : uint32_t
+    {
+        CameraRay = 0,
+        Path      = 1
+    };
+
     int           m_ImageHeight  = 0;    // Rendered image height
     double        m_RecipSqrtSpp = 1;    // 1 / sqrt_spp
     Math::Point3  m_Center;              // Camera m_center
@@ -80,6 +143,25 @@ private:
 
     Math::Point3 DefocusDiskSample() const;
 
+    const Material* GetMaterial(const HitRecord& rec) const;
+
+    Color3 EmittedColor(const Material& material, const Ray& r, const HitRecord& rec) const;
+
+    // Samples the direction of the next bounce. weight is the factor the incoming color of that direction contributes
+    // with: the attenuation, divided by the sampling density when PDFs are used.
+    bool ScatterRay(const Material& material, const Ray& r, const HitRecord& rec, const Objects::HittableList& lights, Ray& scattered, Color3& weight) const;
+
+    // Color reaching rec from the light sample of next-event estimation, already weighted against the material sample.
+    Color3 SampleLight(const Material& material, const Ray& r, const HitRecord& rec, const ScatterRecord& srec, const Objects::Hittable& world, const Objects::HittableList& lights) const;
+
+    // Russian roulette: ends the path with a probability that grows as its throughput drops, and boosts the throughput
+    // of surviving paths by the inverse, so the expected color stays the same. Returns false if the path ends.
+    bool ContinuePath(int bounce, Color3& throughput) const;
+
+    // With deterministic sampling, switches the calling thread to the random stream of the stage of a pixel sample.
+    void BeginSampleStream(uint32_t x, uint32_t y, int sample, SampleStage stage) const;
+    void EndSampleStream() const;
+
     // Pixel Sampling Functions
     Math::Vector3 SampleSquare() const;
     Math::Vector3 SampleSquare(int xS, int yS) const;    // Stratified
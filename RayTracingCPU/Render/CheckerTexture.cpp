@@ -3,7 +3,7 @@
 namespace Render
 {
 
-Color3 CheckerTexture::Value(const double u, const double v, const Math::Point3& point) const
+Color3 CheckerTexture::Value(const Math::Real u, const Math::Real v, const Math::Point3& point) const
 {
     const auto xInteger = static_cast<int>(std::floor(m_InvertedScale * point.X()));
     const auto yInteger = static_cast<int>(std::floor(m_InvertedScale * point.Y()));
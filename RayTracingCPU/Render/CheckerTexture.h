@@ -10,24 +10,24 @@ namespace Render
 class CheckerTexture final : public Texture
 {
 public:
-    CheckerTexture(const double scale, const std::shared_ptr<Texture>& even, const std::shared_ptr<Texture>& odd)
+    CheckerTexture(const Math::Real scale, const std::shared_ptr<Texture>& even, const std::shared_ptr<Texture>& odd)
         : m_InvertedScale(1.0 / scale)
         , m_Even(even)
         , m_Odd(odd)
     {
     }
 
-    CheckerTexture(const double scale, const Color3& color1, const Color3& color2)
+    CheckerTexture(const Math::Real scale, const Color3& color1, const Color3& color2)
         : m_InvertedScale(1.0 / scale)
         , m_Even(std::make_shared<SolidColor>(color1))
         , m_Odd(std::make_shared<SolidColor>(color2))
     {
     }
 
-    Color3 Value(double u, double v, const Math::Point3& point) const override;
+    Color3 Value(Math::Real u, Math::Real v, const Math::Point3& point) const override;
 
 private:
-    double                   m_InvertedScale;
+    Math::Real               m_InvertedScale;
     std::shared_ptr<Texture> m_Even;
     std::shared_ptr<Texture> m_Odd;
 };
@@ -1,5 +1,121 @@
 #include "Color.h"
 
+#include <Utils/CPUFeatures.h>
+
+#include <algorithm>
+
+#if RT_ARCH_X86
+    #include <immintrin.h>
+#endif
+
 namespace Render
 {
+
+namespace Impl
+{
+
+    using ResolveFunction = void (*)(const FloatColor* colors, uint32_t* rgba, size_t count, float colorScale);
+
+    // Same steps as GetColorRGBA, NaN fails the comparison and turns to zero.
+    uint32_t ResolveComponent(const float component, const float colorScale)
+    {
+        const float scaled = component * colorScale;
+        const float gamma  = scaled > 0.0f ? std::sqrt(scaled) : 0.0f;
+        return static_cast<uint32_t>(255.999f * std::min(gamma, 0.999f));
+    }
+
+    void ResolveScalar(const FloatColor* colors, uint32_t* rgba, const size_t count, const float colorScale)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            const uint32_t r = ResolveComponent(colors[i].R, colorScale);
+            const uint32_t g = ResolveComponent(colors[i].G, colorScale);
+            const uint32_t b = ResolveComponent(colors[i].B, colorScale);
+            rgba[i]          = 0xff000000 | (b << 16) | (g << 8) | r;
+        }
+    }
+
+#if RT_ARCH_X86
+    // One pixel per register. Max returns its second operand for NaN, which clears NaN along with negative components.
+    // The components end up as 32 bit integers below 256, two saturating packs narrow them down to bytes in RGBA order.
+    void ResolveSSE2(const FloatColor* colors, uint32_t* rgba, const size_t count, const float colorScale)
+    {
+        const __m128  scale = _mm_set1_ps(colorScale);
+        const __m128  zero  = _mm_setzero_ps();
+        const __m128  upper = _mm_set1_ps(0.999f);
+        const __m128  range = _mm_set1_ps(255.999f);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+
+        size_t i = 0;
+        for(; i + 4 <= count; i += 4)
+        {
+            __m128i components[4];
+            for(int pixel = 0; pixel < 4; pixel++)
+            {
+                const __m128 linear = _mm_max_ps(_mm_mul_ps(_mm_load_ps(&colors[i + pixel].R), scale), zero);
+                const __m128 gamma  = _mm_min_ps(_mm_sqrt_ps(linear), upper);
+                components[pixel]   = _mm_cvttps_epi32(_mm_mul_ps(gamma, range));
+            }
+
+            const __m128i low   = _mm_packs_epi32(components[0], components[1]);
+            const __m128i high  = _mm_packs_epi32(components[2], components[3]);
+            const __m128i bytes = _mm_or_si128(_mm_packus_epi16(low, high), alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i), bytes);
+        }
+        ResolveScalar(colors + i, rgba + i, count - i, colorScale);
+    }
+
+    // Two pixels per register, which are only 16 byte aligned. The packs work within 128 bit halves, which leaves the
+    // pixels in the order 0 2 4 6 1 3 5 7.
+    RT_TARGET_AVX2 void ResolveAVX2(const FloatColor* colors, uint32_t* rgba, const size_t count, const float colorScale)
+    {
+        const __m256  scale = _mm256_set1_ps(colorScale);
+        const __m256  zero  = _mm256_setzero_ps();
+        const __m256  upper = _mm256_set1_ps(0.999f);
+        const __m256  range = _mm256_set1_ps(255.999f);
+        const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xff000000));
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        size_t i = 0;
+        for(; i + 8 <= count; i += 8)
+        {
+            __m256i components[4];
+            for(int pair = 0; pair < 4; pair++)
+            {
+                const __m256 linear = _mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(&colors[i + 2 * pair].R), scale), zero);
+                const __m256 gamma  = _mm256_min_ps(_mm256_sqrt_ps(linear), upper);
+                components[pair]    = _mm256_cvttps_epi32(_mm256_mul_ps(gamma, range));
+            }
+
+            const __m256i low   = _mm256_packs_epi32(components[0], components[1]);
+            const __m256i high  = _mm256_packs_epi32(components[2], components[3]);
+            const __m256i bytes = _mm256_or_si256(_mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), order), alpha);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + i), bytes);
+        }
+        ResolveSSE2(colors + i, rgba + i, count - i, colorScale);
+    }
+#endif
+
+    // Picks the widest lanes the CPU supports.
+    ResolveFunction SelectResolveKernel()
+    {
+#if RT_ARCH_X86
+        if(Utils::GetCPUFeatures().AVX2)
+            return &ResolveAVX2;
+
+        if(Utils::GetCPUFeatures().SSE2)
+            return &ResolveSSE2;
+#endif
+
+        return &ResolveScalar;
+    }
+
+}    // namespace Impl
+
+void ResolveColors(const FloatColor* colors, uint32_t* rgba, const size_t count, const float colorScale)
+{
+    static const Impl::ResolveFunction resolve = Impl::SelectResolveKernel();
+    resolve(colors, rgba, count, colorScale);
+}
+
 }    // namespace Render
@@ -4,12 +4,41 @@
 #include <Math/Vector3.h>
 
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 namespace Render
 {
 
 using Color3 = Math::Vector3;
 
+// Linear color in single precision, for the accumulation buffer. The unused alpha pads a pixel to 16 bytes, so that it
+// fills one SSE register.
+struct alignas(16) FloatColor
+{
+    float R = 0.0f;
+    float G = 0.0f;
+    float B = 0.0f;
+    float A = 0.0f;
+
+    FloatColor() = default;
+
+    explicit FloatColor(const Color3& color)
+        : R(static_cast<float>(color.X()))
+        , G(static_cast<float>(color.Y()))
+        , B(static_cast<float>(color.Z()))
+    {
+    }
+
+    FloatColor& operator+=(const Color3& color)
+    {
+        R += static_cast<float>(color.X());
+        G += static_cast<float>(color.Y());
+        B += static_cast<float>(color.Z());
+        return *this;
+    }
+};
+
 inline double LinearToGamma(const double linearComponent)
 {
     if(linearComponent > 0)
@@ -19,6 +48,12 @@ inline double LinearToGamma(const double linearComponent)
     return 0.0;
 }
 
+// Relative luminance of a linear color, Rec. 709 weights.
+inline double Luminance(const Color3& color)
+{
+    return 0.2126 * color.X() + 0.7152 * color.Y() + 0.0722 * color.Z();
+}
+
 // Write the translated [0,255] value of each color component.
 inline uint32_t GetColorRGBA(const Color3& color, const double colorScale)
 {
@@ -69,6 +104,10 @@ inline uint32_t GetColorRGBA(const Color3& color, const double colorScale)
     return (a << 24) | (b << 16) | (g << 8) | r;
 }
 
+// Packs count colors into RGBA like GetColorRGBA, several pixels at a time with the widest SIMD lanes the CPU supports.
+// Alpha is always opaque.
+void ResolveColors(const FloatColor* colors, uint32_t* rgba, size_t count, float colorScale);
+
 inline uint32_t GetColorRGBANoGammaCorrection(const Color3& color, const double colorScale)
 {
     auto   red   = color.X();
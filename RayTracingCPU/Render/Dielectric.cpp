@@ -10,12 +10,12 @@ namespace Render
 bool Dielectric::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered) const
 {
     attenuation                  = Color3(1.0, 1.0, 1.0);
-    const double refractionRatio = rec.FrontFace ? (1.0 / m_Ir) : m_Ir;
+    const Math::Real refractionRatio = rec.FrontFace ? (1.0 / m_Ir) : m_Ir;
 
     const Math::Vector3 unitDirection = Math::UnitVector(rIn.Direction());
 
-    const double cosTheta = fmin(DotProduct(-unitDirection, rec.Normal), 1.0);
-    const double sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+    const Math::Real cosTheta = fmin(DotProduct(-unitDirection, rec.Normal), 1.0);
+    const Math::Real sinTheta = sqrt(1.0 - cosTheta * cosTheta);
 
     const bool    cannotRefract = refractionRatio * sinTheta > 1.0;
     Math::Vector3 direction;
@@ -29,21 +29,21 @@ bool Dielectric::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuati
         direction = Refract(unitDirection, rec.Normal, refractionRatio);
     }
 
-    scattered = Ray(rec.P, direction, rIn.Time());
+    scattered = rec.SpawnRay(direction, rIn.Time());
 
     return true;
 }
 
 // Produces black objects
-bool Dielectric::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, double& pdf) const
+bool Dielectric::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, Math::Real& pdf) const
 {
     attenuation                  = Color3(1.0, 1.0, 1.0);
-    const double refractionRatio = rec.FrontFace ? (1.0 / m_Ir) : m_Ir;
+    const Math::Real refractionRatio = rec.FrontFace ? (1.0 / m_Ir) : m_Ir;
 
     const Math::Vector3 unitDirection = Math::UnitVector(rIn.Direction());
 
-    const double cosTheta = fmin(DotProduct(-unitDirection, rec.Normal), 1.0);
-    const double sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+    const Math::Real cosTheta = fmin(DotProduct(-unitDirection, rec.Normal), 1.0);
+    const Math::Real sinTheta = sqrt(1.0 - cosTheta * cosTheta);
 
     const bool    cannotRefract = refractionRatio * sinTheta > 1.0;
     Math::Vector3 direction;
@@ -57,7 +57,7 @@ bool Dielectric::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuati
         direction = Refract(unitDirection, rec.Normal, refractionRatio);
     }
 
-    scattered = Ray(rec.P, direction, rIn.Time());
+    scattered = rec.SpawnRay(direction, rIn.Time());
     pdf       = 1.0;
 
     return true;
@@ -66,15 +66,15 @@ bool Dielectric::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuati
 bool Dielectric::Scatter(const Ray& rIn, const HitRecord& rec, ScatterRecord& srec) const
 {
     srec.Attenuation = Color3(1.0, 1.0, 1.0);
-    srec.PDFPtr      = nullptr;
+    srec.ScatterPDF  = {};
     srec.SkipPDF     = true;
 
-    const double refractionRatio = rec.FrontFace ? (1.0 / m_Ir) : m_Ir;
+    const Math::Real refractionRatio = rec.FrontFace ? (1.0 / m_Ir) : m_Ir;
 
     const Math::Vector3 unitDirection = Math::UnitVector(rIn.Direction());
 
-    const double cosTheta = fmin(DotProduct(-unitDirection, rec.Normal), 1.0);
-    const double sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+    const Math::Real cosTheta = fmin(DotProduct(-unitDirection, rec.Normal), 1.0);
+    const Math::Real sinTheta = sqrt(1.0 - cosTheta * cosTheta);
 
     const bool    cannotRefract = refractionRatio * sinTheta > 1.0;
     Math::Vector3 direction;
@@ -88,12 +88,12 @@ bool Dielectric::Scatter(const Ray& rIn, const HitRecord& rec, ScatterRecord& sr
         direction = Refract(unitDirection, rec.Normal, refractionRatio);
     }
 
-    srec.SkipPDFRay = Ray(rec.P, direction, rIn.Time());
+    srec.SkipPDFRay = rec.SpawnRay(direction, rIn.Time());
 
     return true;
 }
 
-double Dielectric::Reflectance(const double cosine, const double refIdx)
+Math::Real Dielectric::Reflectance(const Math::Real cosine, const Math::Real refIdx)
 {
     // Use Schlick's approximation for reflectance.
     auto r0 = (1 - refIdx) / (1 + refIdx);
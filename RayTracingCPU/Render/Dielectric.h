@@ -8,19 +8,19 @@ namespace Render
 class Dielectric final : public Material
 {
 public:
-    explicit Dielectric(const double indexOfRefraction)
+    explicit Dielectric(const Math::Real indexOfRefraction)
         : m_Ir(indexOfRefraction)
     {
     }
 
     bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered) const override;
-    bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, double& pdf) const override;
+    bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, Math::Real& pdf) const override;
     bool Scatter(const Ray& rIn, const HitRecord& rec, ScatterRecord& srec) const override;
 
 private:
-    double m_Ir;    // Index of Refraction
+    Math::Real m_Ir;    // Index of Refraction
 
-    static double Reflectance(double cosine, double refIdx);
+    static Math::Real Reflectance(Math::Real cosine, Math::Real refIdx);
 };
 
 }    // namespace Render
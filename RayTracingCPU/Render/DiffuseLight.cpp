@@ -10,17 +10,17 @@ bool DiffuseLight::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenua
     return false;
 }
 
-bool DiffuseLight::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, double& pdf) const
+bool DiffuseLight::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, Math::Real& pdf) const
 {
     return false;
 }
 
-Color3 DiffuseLight::Emitted(const double u, const double v, const Math::Point3& p) const
+Color3 DiffuseLight::Emitted(const Math::Real u, const Math::Real v, const Math::Point3& p) const
 {
     return m_Emit->Value(u, v, p);
 }
 
-Color3 DiffuseLight::Emitted(const Ray& rIn, const HitRecord& rec, const double u, const double v, const Math::Point3& p) const
+Color3 DiffuseLight::Emitted(const Ray& rIn, const HitRecord& rec, const Math::Real u, const Math::Real v, const Math::Point3& p) const
 {
     if(!rec.FrontFace)
     {
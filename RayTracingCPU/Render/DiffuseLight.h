@@ -21,10 +21,10 @@ public:
     }
 
     bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered) const override;
-    bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, double& pdf) const override;
+    bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, Math::Real& pdf) const override;
 
-    Color3 Emitted(double u, double v, const Math::Point3& p) const override;
-    Color3 Emitted(const Ray& rIn, const HitRecord& rec, double u, double v, const Math::Point3& p) const override;
+    Color3 Emitted(Math::Real u, Math::Real v, const Math::Point3& p) const override;
+    Color3 Emitted(const Ray& rIn, const HitRecord& rec, Math::Real u, Math::Real v, const Math::Point3& p) const override;
 
 private:
     std::shared_ptr<Texture> m_Emit;
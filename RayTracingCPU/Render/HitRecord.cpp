@@ -11,14 +11,9 @@ void HitRecord::SetFaceNormal(const Ray& r, const Math::Vector3& outwardNormal)
     Normal    = FrontFace ? outwardNormal : -outwardNormal;
 }
 
-std::shared_ptr<Material>& HitRecord::GetMaterial()
+Ray HitRecord::SpawnRay(const Math::Vector3& direction, const Math::Real time) const
 {
-    return m_Material;
-}
-
-void HitRecord::SetMaterial(const std::shared_ptr<Material>& material)
-{
-    m_Material = material;
+    return {Math::OffsetRayOrigin(P, PError, Normal, direction), direction, time};
 }
 
 }    // namespace Render
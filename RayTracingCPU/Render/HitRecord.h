@@ -2,34 +2,36 @@
 
 #include <Math/Vector3.h>
 
-#include <memory>
+#include <cstdint>
+#include <type_traits>
 
 namespace Render
 {
 
-class Material;
 class Ray;
 
+// Plain data, so primitives and BVHs copy it without touching shared state.
 class HitRecord
 {
 public:
     Math::Point3  P;
     Math::Vector3 Normal;
-    double        T         = 0.0;
-    double        U         = 0.0;
-    double        V         = 0.0;
-    bool          FrontFace = false;
+    Math::Real    T             = 0.0;
+    Math::Real    U             = 0.0;
+    Math::Real    V             = 0.0;
+    Math::Real    PError        = 0.0;    // Bound on the absolute rounding error of each coordinate of P
+    uint32_t      MaterialIndex = 0;    // Index into the MaterialTable of the scene
+    uint32_t      PrimitiveId   = 0;
+    bool          FrontFace     = false;
 
     // Sets the hit record normal vector.
     // NOTE: the parameter `outwardNormal` is assumed to have unit length.
     void SetFaceNormal(const Ray& r, const Math::Vector3& outwardNormal);
 
-    std::shared_ptr<Material>& GetMaterial();
-
-    void SetMaterial(const std::shared_ptr<Material>& material);
-
-private:
-    std::shared_ptr<Material> m_Material = nullptr;
+    // Ray leaving the hit point, with its origin moved past the rounding error of P so it does not hit the surface again.
+    Ray SpawnRay(const Math::Vector3& direction, Math::Real time) const;
 };
 
+static_assert(std::is_trivially_copyable_v<HitRecord>);
+
 }    // namespace Render
@@ -2,13 +2,15 @@
 
 #include <Math/Interval.h>
 
+#include <algorithm>
+
 namespace Render
 {
 
-Color3 ImageTexture::Value(double u, double v, const Math::Point3& p) const
+Color3 ImageTexture::Value(Math::Real u, Math::Real v, const Math::Point3& p) const
 {
     // If we have no texture data, then return solid cyan as a debugging aid.
-    if(m_Image.GetHeight() <= 0)
+    if(m_Image.Height == 0)
         return {0, 1, 1};
 
     // Clamp input texture coordinates to [0,1] x [1,0]
@@ -16,11 +18,11 @@ Color3 ImageTexture::Value(double u, double v, const Math::Point3& p) const
     // Flip V to image coordinates
     v = 1.0 - Math::Interval(0, 1).Clamp(v);
 
-    const auto i     = static_cast<int>(u * m_Image.GetWidth());
-    const auto j     = static_cast<int>(v * m_Image.GetHeight());
+    const auto i     = std::min(static_cast<uint32_t>(u * m_Image.Width), m_Image.Width - 1);
+    const auto j     = std::min(static_cast<uint32_t>(v * m_Image.Height), m_Image.Height - 1);
     const auto pixel = m_Image.PixelData(i, j);
 
-    constexpr auto colorScale = 1.0 / 255.0;
+    constexpr Math::Real colorScale = 1.0 / 255.0;
     return {colorScale * pixel[0], colorScale * pixel[1], colorScale * pixel[2]};
 }
 
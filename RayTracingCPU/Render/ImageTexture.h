@@ -2,7 +2,7 @@
 
 #include "Texture.h"
 
-#include <Engine/Image.h>
+#include <Utils/ImageIO.h>
 
 namespace Render
 {
@@ -11,14 +11,14 @@ class ImageTexture final : public Texture
 {
 public:
     explicit ImageTexture(const std::string_view path)
-        : m_Image(path, true)
+        : m_Image(Utils::ReadImage(path))
     {
     }
 
-    Color3 Value(double u, double v, const Math::Point3& p) const override;
+    Color3 Value(Math::Real u, Math::Real v, const Math::Point3& p) const override;
 
 private:
-    Engine::Image m_Image;
+    Utils::ImageRGBA m_Image;
 };
 
 }    // namespace Render
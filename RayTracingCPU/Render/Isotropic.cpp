@@ -12,14 +12,14 @@ namespace Render
 
 bool Isotropic::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered) const
 {
-    scattered   = Ray(rec.P, Math::RandomUnitVector(), rIn.Time());
+    scattered   = rec.SpawnRay(Math::RandomUnitVector(), rIn.Time());
     attenuation = m_Albedo->Value(rec.U, rec.V, rec.P);
     return true;
 }
 
-bool Isotropic::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, double& pdf) const
+bool Isotropic::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, Math::Real& pdf) const
 {
-    scattered   = Ray(rec.P, Math::RandomUnitVector(), rIn.Time());
+    scattered   = rec.SpawnRay(Math::RandomUnitVector(), rIn.Time());
     attenuation = m_Albedo->Value(rec.U, rec.V, rec.P);
     pdf         = 1 / (4 * Math::Pi);
     return true;
@@ -28,12 +28,12 @@ bool Isotropic::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuatio
 bool Isotropic::Scatter(const Ray& rIn, const HitRecord& rec, ScatterRecord& srec) const
 {
     srec.Attenuation = m_Albedo->Value(rec.U, rec.V, rec.P);
-    srec.PDFPtr      = std::make_shared<Math::SpherePDF>();
+    srec.ScatterPDF  = Math::SpherePDF();
     srec.SkipPDF     = false;
     return true;
 }
 
-double Isotropic::ScatteringPDF(const Ray& rIn, const HitRecord& rec, const Ray& scattered) const
+Math::Real Isotropic::ScatteringPDF(const Ray& rIn, const HitRecord& rec, const Ray& scattered) const
 {
     return 1 / (4 * Math::Pi);
 }
@@ -20,17 +20,17 @@ bool Lambertian::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuati
     {
         scatterDirection = rec.Normal;
     }
-    scattered   = Ray(rec.P, scatterDirection, rIn.Time());
+    scattered   = rec.SpawnRay(scatterDirection, rIn.Time());
     attenuation = m_Albedo->Value(rec.U, rec.V, rec.P);
     return true;
 }
 
-bool Lambertian::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, double& pdf) const
+bool Lambertian::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, Math::Real& pdf) const
 {
     Math::ONB uvw;
     uvw.BuildFromW(rec.Normal);
     const auto scatterDirection = uvw.Local(Math::RandomCosineDirection());
-    scattered                   = Ray(rec.P, UnitVector(scatterDirection), rIn.Time());
+    scattered                   = rec.SpawnRay(UnitVector(scatterDirection), rIn.Time());
     attenuation                 = m_Albedo->Value(rec.U, rec.V, rec.P);
     pdf                         = DotProduct(uvw.W(), scattered.Direction()) / Math::Pi;
     return true;
@@ -39,12 +39,12 @@ bool Lambertian::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuati
 bool Lambertian::Scatter(const Ray& rIn, const HitRecord& rec, ScatterRecord& srec) const
 {
     srec.Attenuation = m_Albedo->Value(rec.U, rec.V, rec.P);
-    srec.PDFPtr      = std::make_shared<Math::CosinePDF>(rec.Normal);
+    srec.ScatterPDF  = Math::CosinePDF(rec.Normal);
     srec.SkipPDF     = false;
     return true;
 }
 
-double Lambertian::ScatteringPDF(const Ray& rIn, const HitRecord& rec, const Ray& scattered) const
+Math::Real Lambertian::ScatteringPDF(const Ray& rIn, const HitRecord& rec, const Ray& scattered) const
 {
     const auto cosTheta = DotProduct(rec.Normal, Math::UnitVector(scattered.Direction()));
     return cosTheta < 0 ? 0 : cosTheta / Math::Pi;
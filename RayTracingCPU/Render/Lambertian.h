@@ -21,10 +21,10 @@ public:
     }
 
     bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered) const override;
-    bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, double& pdf) const override;
+    bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, Math::Real& pdf) const override;
     bool Scatter(const Ray& rIn, const HitRecord& rec, ScatterRecord& srec) const override;
 
-    double ScatteringPDF(const Ray& rIn, const HitRecord& rec, const Ray& scattered) const override;
+    Math::Real ScatteringPDF(const Ray& rIn, const HitRecord& rec, const Ray& scattered) const override;
 
 private:
     std::shared_ptr<Texture> m_Albedo;
@@ -1,24 +1,31 @@
 #include "Material.h"
 
+#include <Math/Constants.h>
+
 namespace Render
 {
 
-Color3 Material::Emitted(double u, double v, const Math::Point3& p) const
+Color3 Material::Emitted(Math::Real u, Math::Real v, const Math::Point3& p) const
 {
     return {0, 0, 0};
 }
 
-Color3 Material::Emitted(const Ray& rIn, const HitRecord& rec, double u, double v, const Math::Point3& p) const
+Color3 Material::Emitted(const Ray& rIn, const HitRecord& rec, Math::Real u, Math::Real v, const Math::Point3& p) const
 {
     return {0, 0, 0};
 }
 
+Math::Real Material::EmittedPower(const Math::Real area, const Math::Point3& p) const
+{
+    return static_cast<Math::Real>(Math::Pi * Luminance(Emitted(0.5, 0.5, p))) * area;
+}
+
 bool Material::Scatter(const Ray& rIn, const HitRecord& rec, ScatterRecord& srec) const
 {
     return false;
 }
 
-double Material::ScatteringPDF(const Ray& rIn, const HitRecord& rec, const Ray& scattered) const
+Math::Real Material::ScatteringPDF(const Ray& rIn, const HitRecord& rec, const Ray& scattered) const
 {
     return 0;
 }
@@ -22,14 +22,18 @@ class Material
 public:
     virtual ~Material() = default;
 
-    virtual Color3 Emitted(double u, double v, const Math::Point3& p) const;
-    virtual Color3 Emitted(const Ray& rIn, const HitRecord& rec, double u, double v, const Math::Point3& p) const;
+    virtual Color3 Emitted(Math::Real u, Math::Real v, const Math::Point3& p) const;
+    virtual Color3 Emitted(const Ray& rIn, const HitRecord& rec, Math::Real u, Math::Real v, const Math::Point3& p) const;
 
-    virtual bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered) const              = 0;
-    virtual bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, double& pdf) const = 0;
+    // Power a one-sided diffuse emitter of this material and area sends out, from the luminance of its emission at p
+    // and the center of the texture. Zero for materials that emit no light.
+    Math::Real EmittedPower(Math::Real area, const Math::Point3& p) const;
+
+    virtual bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered) const                  = 0;
+    virtual bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, Math::Real& pdf) const = 0;
     virtual bool Scatter(const Ray& rIn, const HitRecord& rec, ScatterRecord& srec) const;
 
-    virtual double ScatteringPDF(const Ray& rIn, const HitRecord& rec, const Ray& scattered) const;
+    virtual Math::Real ScatteringPDF(const Ray& rIn, const HitRecord& rec, const Ray& scattered) const;
 };
 
 }    // namespace Render
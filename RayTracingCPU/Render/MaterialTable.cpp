@@ -0,0 +1,20 @@
+#include "MaterialTable.h"
+
+namespace Render
+{
+
+uint32_t MaterialTable::Add(const std::shared_ptr<Material>& material)
+{
+    const auto [it, inserted] = m_Indices.try_emplace(material.get(), static_cast<uint32_t>(m_Materials.size()));
+    if(inserted)
+        m_Materials.push_back(material);
+    return it->second;
+}
+
+void MaterialTable::Clear()
+{
+    m_Materials.clear();
+    m_Indices.clear();
+}
+
+}    // namespace Render
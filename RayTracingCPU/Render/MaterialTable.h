@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Render
+{
+
+class Material;
+
+// Owns the materials of a scene. Primitives keep the index of their material, so hit records carry a plain integer
+// instead of a shared pointer, which every thread would otherwise copy and reference count on each hit.
+class MaterialTable
+{
+public:
+    // Returns the index of the material, adding it on first use.
+    uint32_t Add(const std::shared_ptr<Material>& material);
+
+    const Material* Get(const uint32_t index) const { return m_Materials[index].get(); }
+    size_t          Size() const { return m_Materials.size(); }
+    void            Clear();
+
+private:
+    std::vector<std::shared_ptr<Material>>        m_Materials;
+    std::unordered_map<const Material*, uint32_t> m_Indices;
+};
+
+}    // namespace Render
@@ -10,16 +10,16 @@ namespace Render
 bool Metal::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered) const
 {
     const Math::Vector3 reflected = Reflect(Math::UnitVector(rIn.Direction()), rec.Normal);
-    scattered                     = Ray(rec.P, reflected + m_Fuzz * Math::RandomUnitVector(), rIn.Time());
+    scattered                     = rec.SpawnRay(reflected + m_Fuzz * Math::RandomUnitVector(), rIn.Time());
     attenuation                   = m_Albedo;
     return (DotProduct(scattered.Direction(), rec.Normal) > 0);
 }
 
 // Produces black objects
-bool Metal::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, double& pdf) const
+bool Metal::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, Math::Real& pdf) const
 {
     const Math::Vector3 reflected = Reflect(Math::UnitVector(rIn.Direction()), rec.Normal);
-    scattered                     = Ray(rec.P, reflected + m_Fuzz * Math::RandomUnitVector(), rIn.Time());
+    scattered                     = rec.SpawnRay(reflected + m_Fuzz * Math::RandomUnitVector(), rIn.Time());
     attenuation                   = m_Albedo;
     pdf                           = 1.0;
     return (DotProduct(scattered.Direction(), rec.Normal) > 0);
@@ -28,10 +28,10 @@ bool Metal::Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, R
 bool Metal::Scatter(const Ray& rIn, const HitRecord& rec, ScatterRecord& srec) const
 {
     srec.Attenuation              = m_Albedo;
-    srec.PDFPtr                   = nullptr;
+    srec.ScatterPDF               = {};
     srec.SkipPDF                  = true;
     const Math::Vector3 reflected = Reflect(Math::UnitVector(rIn.Direction()), rec.Normal);
-    srec.SkipPDFRay               = Ray(rec.P, reflected + m_Fuzz * Math::RandomUnitVector(), rIn.Time());
+    srec.SkipPDFRay               = rec.SpawnRay(reflected + m_Fuzz * Math::RandomUnitVector(), rIn.Time());
     return true;
 }
 
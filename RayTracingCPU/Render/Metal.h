@@ -8,19 +8,19 @@ namespace Render
 class Metal final : public Material
 {
 public:
-    explicit Metal(const Color3& color, const double fuzz)
+    explicit Metal(const Color3& color, const Math::Real fuzz)
         : m_Albedo(color)
         , m_Fuzz(fuzz < 1 ? fuzz : 1)
     {
     }
 
     bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered) const override;
-    bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, double& pdf) const override;
+    bool Scatter(const Ray& rIn, const HitRecord& rec, Color3& attenuation, Ray& scattered, Math::Real& pdf) const override;
     bool Scatter(const Ray& rIn, const HitRecord& rec, ScatterRecord& srec) const override;
 
 private:
-    Color3 m_Albedo;
-    double m_Fuzz;
+    Color3     m_Albedo;
+    Math::Real m_Fuzz;
 };
 
 }    // namespace Render
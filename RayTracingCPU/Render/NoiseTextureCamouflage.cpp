@@ -3,7 +3,7 @@
 namespace Render
 {
 
-Color3 NoiseTextureCamouflage::Value(double u, double v, const Math::Point3& p) const
+Color3 NoiseTextureCamouflage::Value(Math::Real u, Math::Real v, const Math::Point3& p) const
 {
     const auto s = m_Scale * p;
     return Color3(1, 1, 1) * m_Noise.Turbulence(s, 7);
@@ -11,16 +11,16 @@ class NoiseTextureSmooth final : public Texture
 public:
     NoiseTextureSmooth() = default;
 
-    explicit NoiseTextureSmooth(const double scale)
+    explicit NoiseTextureSmooth(const Math::Real scale)
         : m_Scale(scale)
     {
     }
 
-    Color3 Value(double u, double v, const Math::Point3& p) const override;
+    Color3 Value(Math::Real u, Math::Real v, const Math::Point3& p) const override;
 
 private:
-    Perlin m_Noise;
-    double m_Scale;
+    Perlin     m_Noise;
+    Math::Real m_Scale;
 };
 
 }    // namespace Render
@@ -15,7 +15,7 @@ Perlin::Perlin()
     PerlinGeneratePerm(m_PermZ);
 }
 
-double Perlin::Noise(const Math::Point3& p) const
+Math::Real Perlin::Noise(const Math::Point3& p) const
 {
     const auto u = p.X() - floor(p.X());
     const auto v = p.Y() - floor(p.Y());
@@ -39,7 +39,7 @@ double Perlin::Noise(const Math::Point3& p) const
     return PerlinInterp(c, u, v, w);
 }
 
-double Perlin::Turbulence(const Math::Point3& p, const int depth) const
+Math::Real Perlin::Turbulence(const Math::Point3& p, const int depth) const
 {
     auto accum  = 0.0;
     auto tempP  = p;
@@ -74,7 +74,7 @@ void Perlin::Permute(int* p, const int n)
     }
 }
 
-double Perlin::PerlinInterp(const Math::Vector3 c[2][2][2], const double u, const double v, const double w)
+Math::Real Perlin::PerlinInterp(const Math::Vector3 c[2][2][2], const Math::Real u, const Math::Real v, const Math::Real w)
 {
     const auto uu = u * u * (3 - 2 * u);
     const auto vv = v * v * (3 - 2 * v);
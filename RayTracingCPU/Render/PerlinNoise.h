@@ -11,8 +11,8 @@ public:
     Perlin();
     ~Perlin() = default;
 
-    double Noise(const Math::Point3& p) const;
-    double Turbulence(const Math::Point3& p, int depth) const;
+    Math::Real Noise(const Math::Point3& p) const;
+    Math::Real Turbulence(const Math::Point3& p, int depth) const;
 
 private:
     static constexpr int PointCount = 256;
@@ -21,9 +21,9 @@ private:
     int                  m_PermY[PointCount];
     int                  m_PermZ[PointCount];
 
-    static void   PerlinGeneratePerm(int* p);
-    static void   Permute(int* p, int n);
-    static double PerlinInterp(const Math::Vector3 c[2][2][2], double u, double v, double w);
+    static void       PerlinGeneratePerm(int* p);
+    static void       Permute(int* p, int n);
+    static Math::Real PerlinInterp(const Math::Vector3 c[2][2][2], Math::Real u, Math::Real v, Math::Real w);
 };
 
 }    // namespace Render
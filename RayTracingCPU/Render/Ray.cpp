@@ -13,12 +13,12 @@ const Math::Vector3& Ray::Direction() const
     return m_Direction;
 }
 
-double Ray::Time() const
+Math::Real Ray::Time() const
 {
     return m_Time;
 }
 
-Math::Point3 Ray::At(const double t) const
+Math::Point3 Ray::At(const Math::Real t) const
 {
     return m_Origin + t * m_Direction;
 }
@@ -17,7 +17,7 @@ public:
     {
     }
 
-    Ray(const Math::Point3& origin, const Math::Vector3& direction, const double time)
+    Ray(const Math::Point3& origin, const Math::Vector3& direction, const Math::Real time)
         : m_Origin(origin)
         , m_Direction(direction)
         , m_Time(time)
@@ -26,13 +26,13 @@ public:
 
     const Math::Point3&  Origin() const;
     const Math::Vector3& Direction() const;
-    double               Time() const;
-    Math::Point3         At(double t) const;
+    Math::Real           Time() const;
+    Math::Point3         At(Math::Real t) const;
 
 private:
     Math::Point3  m_Origin;
     Math::Vector3 m_Direction;
-    double        m_Time = 0;
+    Math::Real    m_Time = 0;
 };
 
 }    // namespace Render
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Ray.h"
+
+namespace Render
+{
+
+// Bundle of coherent rays, e.g. the primary rays of neighbouring pixels, which are traced through the scene together.
+struct RayPacket
+{
+    static constexpr int MaxSize = 16;
+
+    Ray Rays[MaxSize];
+    int Size = 0;
+};
+
+}    // namespace Render
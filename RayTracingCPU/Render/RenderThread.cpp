@@ -0,0 +1,150 @@
+#include "RenderThread.h"
+
+#include <Utils/Timers.h>
+
+#include <algorithm>
+
+namespace Render
+{
+
+RenderThread::RenderThread(const unsigned threadCount)
+    : m_Renderer(threadCount)
+{
+    m_Renderer.SetCancelFlag(&m_Cancelled);
+    m_Renderer.SetTileCallback([this](const Tile& tile) { PublishTile(tile); });
+    m_Thread = std::thread(&RenderThread::ThreadLoop, this);
+}
+
+RenderThread::~RenderThread()
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Stop = true;
+        m_Cancelled.store(true);
+    }
+    m_WakeCondition.notify_all();
+    m_Thread.join();
+}
+
+void RenderThread::Submit(Job job)
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_PendingJob = std::move(job);
+        if(m_Status.Busy)
+            m_Cancelled.store(true);
+    }
+    m_WakeCondition.notify_all();
+}
+
+void RenderThread::Cancel()
+{
+    std::unique_lock lock(m_Mutex);
+    m_PendingJob = nullptr;
+    if(m_Status.Busy)
+        m_Cancelled.store(true);
+    m_IdleCondition.wait(lock, [this] { return !m_Status.Busy; });
+}
+
+bool RenderThread::IsBusy() const
+{
+    std::lock_guard lock(m_Mutex);
+    return m_Status.Busy || m_PendingJob;
+}
+
+RenderStatus RenderThread::GetStatus() const
+{
+    RenderStatus status;
+    {
+        std::lock_guard lock(m_Mutex);
+        status = m_Status;
+    }
+    if(status.Busy)
+    {
+        std::lock_guard lock(m_ImageMutex);
+        const uint64_t pixelCount = static_cast<uint64_t>(m_FrontWidth) * m_FrontHeight;
+        status.Progress           = pixelCount > 0 ? std::min(1.0, static_cast<double>(m_PixelsDone) / static_cast<double>(pixelCount)) : 0.0;
+    }
+    return status;
+}
+
+bool RenderThread::FetchImage(std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height)
+{
+    std::lock_guard lock(m_ImageMutex);
+    if(!m_ImageChanged)
+        return false;
+
+    pixels         = m_FrontBuffer;
+    width          = m_FrontWidth;
+    height         = m_FrontHeight;
+    m_ImageChanged = false;
+    return true;
+}
+
+void RenderThread::ThreadLoop()
+{
+    std::unique_lock lock(m_Mutex);
+    while(true)
+    {
+        m_WakeCondition.wait(lock, [this] { return m_Stop || m_PendingJob; });
+        if(m_Stop)
+            break;
+
+        // The flag is only cleared here, under the lock, so a cancel that comes in later always reaches this job.
+        Job job      = std::move(m_PendingJob);
+        m_PendingJob = nullptr;
+        m_Cancelled.store(false);
+        m_Status.Busy = true;
+        {
+            std::lock_guard imageLock(m_ImageMutex);
+            m_PixelsDone = 0;
+        }
+        lock.unlock();
+
+        const Utils::Timer timer;
+        job(m_Renderer);
+        const double elapsed   = timer.ElapsedMilliseconds();
+        const bool   cancelled = m_Cancelled.load();
+
+        // Renderers that do not work in tiles only show up once the whole image is done.
+        if(!cancelled)
+            PublishTile({0, 0, m_Renderer.GetWidth(), m_Renderer.GetHeight()});
+
+        lock.lock();
+        m_Status.Busy         = false;
+        m_Status.Cancelled    = cancelled;
+        m_Status.FrameCounter = m_Renderer.GetFrameCounter();
+        if(!cancelled)
+        {
+            m_Status.LastFrameMs = elapsed;
+            m_Status.Tiles       = m_Renderer.GetTileStats();
+            m_Status.Adaptive    = m_Renderer.GetAdaptiveStats();
+        }
+        m_IdleCondition.notify_all();
+    }
+}
+
+void RenderThread::PublishTile(const Tile& tile)
+{
+    const uint32_t  width  = m_Renderer.GetWidth();
+    const uint32_t  height = m_Renderer.GetHeight();
+    const uint32_t* image  = m_Renderer.GetImageData();
+
+    std::lock_guard lock(m_ImageMutex);
+    if(m_FrontWidth != width || m_FrontHeight != height)
+    {
+        m_FrontWidth  = width;
+        m_FrontHeight = height;
+        m_FrontBuffer.assign(static_cast<size_t>(width) * height, 0);
+    }
+
+    for(uint32_t y = tile.Y; y < tile.Y + tile.Height; y++)
+    {
+        const size_t row = static_cast<size_t>(y) * width + tile.X;
+        std::copy_n(image + row, tile.Width, m_FrontBuffer.data() + row);
+    }
+    m_PixelsDone += static_cast<uint64_t>(tile.Width) * tile.Height;
+    m_ImageChanged = true;
+}
+
+}    // namespace Render
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Renderer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Render
+{
+
+// State of the render thread, copied out for the UI.
+struct RenderStatus
+{
+    bool          Busy         = false;
+    bool          Cancelled    = false;    // The last job stopped before it finished
+    double        Progress     = 0.0;      // Fraction of the pixels finished by the current job, the first pass of the adaptive sampler
+    double        LastFrameMs  = 0.0;      // Wall time of the last job that finished
+    uint32_t      FrameCounter = 1;
+    TileStats     Tiles;
+    AdaptiveStats Adaptive;
+};
+
+// Runs a renderer on a thread of its own, so that the UI keeps drawing while a frame is traced. There is one job in
+// flight at most, submitting another cancels it, and the renderer stops within a pixel. The renderer writes into its
+// own image, the back buffer, and every finished tile is copied into a front buffer the UI reads from.
+//
+// Jobs run on the render thread and only read the scene. Anything the scene holds, like its compiled world, may only
+// be changed after Cancel() returned.
+class RenderThread
+{
+public:
+    using Job = std::function<void(Renderer& renderer)>;
+
+    // Zero threads means one per hardware thread, the render thread is one of them.
+    explicit RenderThread(unsigned threadCount = 0);
+    ~RenderThread();
+
+    RenderThread(const RenderThread&)            = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Cancels the job in flight and queues the new one, without waiting for either.
+    void Submit(Job job);
+
+    // Cancels the job in flight and the queued one, and waits until the renderer is idle.
+    void Cancel();
+
+    bool         IsBusy() const;
+    RenderStatus GetStatus() const;
+
+    // Copies the front buffer into pixels if it changed since the last call, and returns whether it did.
+    bool FetchImage(std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height);
+
+private:
+    Renderer          m_Renderer;
+    std::atomic<bool> m_Cancelled = false;
+
+    mutable std::mutex      m_Mutex;
+    std::condition_variable m_WakeCondition;
+    std::condition_variable m_IdleCondition;
+    Job                     m_PendingJob;
+    RenderStatus            m_Status;
+    bool                    m_Stop = false;
+
+    mutable std::mutex    m_ImageMutex;
+    std::vector<uint32_t> m_FrontBuffer;
+    uint32_t              m_FrontWidth   = 0;
+    uint32_t              m_FrontHeight  = 0;
+    uint64_t              m_PixelsDone   = 0;
+    bool                  m_ImageChanged = false;
+
+    std::thread m_Thread;    // Started last, after everything it uses
+
+    void ThreadLoop();
+
+    // Copies the pixels of the tile from the back buffer, called from the rendering threads.
+    void PublishTile(const Tile& tile);
+};
+
+}    // namespace Render
@@ -1,78 +1,89 @@
 #include "Renderer.h"
 
 #include "Camera.h"
+#include "RayPacket.h"
 
 #include <Objects/Hittable.h>
 #include <Objects/HittableList.h>
+#include <Utils/Log.h>
 
-#include <cstring>
-#include <execution>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
 
 namespace Render
 {
 
+namespace Impl
+{
+
+    constexpr double AdaptivePriorM2 = 0.5 * 0.5;
+
+    // Heat map color of a sample count, blue for the fewest samples through green to red for the most, on a log scale.
+    Color3 SampleCountColor(const uint32_t samples, const uint32_t maxSamples)
+    {
+        const double t = maxSamples > 1 ? std::log(static_cast<double>(samples)) / std::log(static_cast<double>(maxSamples)) : 1.0;
+        if(t < 0.5)
+            return (1.0 - 2.0 * t) * Color3(0, 0, 1) + 2.0 * t * Color3(0, 1, 0);
+        return (2.0 - 2.0 * t) * Color3(0, 1, 0) + (2.0 * t - 1.0) * Color3(1, 0, 0);
+    }
+
+}    // namespace Impl
+
+void AdaptiveStats::Log(const std::string_view name) const
+{
+    LOG_INFO("{}: {} passes, {} samples, {:.1f} spp on average, {} of {} pixels converged",
+             name, Passes, SampleCount, PixelCount > 0 ? static_cast<double>(SampleCount) / PixelCount : 0.0, ConvergedPixels, PixelCount);
+}
+
 void Renderer::ResetPixelColorsAccumulator() const
 {
-    std::memset(m_PixelColorsAccum, 0, static_cast<uint64_t>(m_Image->GetWidth()) * m_Image->GetHeight() * sizeof(Color3));
+    std::fill_n(m_PixelColorsAccum, static_cast<uint64_t>(m_Width) * m_Height, FloatColor());
 }
 
 void Renderer::SetImageSize(uint32_t width, uint32_t height)
 {
-    if(m_Image)
-    {
-        // Return, if the image size isn't changed
-        if(m_Image->GetWidth() == width && m_Image->GetHeight() == height)
-            return;
+    // Return, if the image size isn't changed
+    if(m_ImageData && m_Width == width && m_Height == height)
+        return;
 
-        m_Image->Resize(width, height);
-    }
-    else
-    {
-        m_Image = std::make_shared<Engine::Image>(width, height, Engine::ImageFormat::RGBA);
-    }
+    m_Width  = width;
+    m_Height = height;
 
     delete[] m_ImageData;
     m_ImageData = new uint32_t[static_cast<uint64_t>(width * height)];
 
     delete[] m_PixelColorsAccum;
-    m_PixelColorsAccum = new Color3[static_cast<uint64_t>(width * height)];
+    m_PixelColorsAccum = new FloatColor[static_cast<uint64_t>(width * height)];
+}
 
-    m_ImageWidthIterator.resize(width);
-    for(uint32_t i = 0; i < width; i++)
-    {
-        m_ImageWidthIterator[i] = i;
-    }
-    m_ImageHeightIterator.resize(height);
-    for(uint32_t i = 0; i < height; i++)
-    {
-        m_ImageHeightIterator[i] = i;
-    }
+void Renderer::SetTileSize(const uint32_t tileSize)
+{
+    m_TileSize = (std::max(tileSize, 4u) + 3) & ~3u;
 }
 
 void Renderer::RenderHelloWorld() const
 {
-    for(uint32_t y = 0; y < m_Image->GetHeight(); y++)
+    for(uint32_t y = 0; y < m_Height; y++)
     {
-        for(uint32_t x = 0; x < m_Image->GetWidth(); x++)
+        for(uint32_t x = 0; x < m_Width; x++)
         {
-            auto pixelColor = Color3(static_cast<double>(x) / (m_Image->GetWidth() - 1), static_cast<double>(y) / (m_Image->GetHeight() - 1), 0);
+            auto pixelColor = Color3(static_cast<double>(x) / (m_Width - 1), static_cast<double>(y) / (m_Height - 1), 0);
 
-            m_ImageData[y * m_Image->GetWidth() + x] = GetColorRGBA(pixelColor, 1);
+            m_ImageData[y * m_Width + x] = GetColorRGBA(pixelColor, 1);
         }
     }
-    m_Image->SetData(m_ImageData);
 }
 
 void Renderer::RenderRandom() const
 {
-    for(uint32_t y = 0; y < m_Image->GetHeight(); y++)
+    for(uint32_t y = 0; y < m_Height; y++)
     {
-        for(uint32_t x = 0; x < m_Image->GetWidth(); x++)
+        for(uint32_t x = 0; x < m_Width; x++)
         {
-            m_ImageData[y * m_Image->GetWidth() + x] = GetRandomColorRGBA();
+            m_ImageData[y * m_Width + x] = GetRandomColorRGBA();
         }
     }
-    m_Image->SetData(m_ImageData);
 }
 
 void Renderer::Render(Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights)
@@ -83,6 +94,13 @@ void Renderer::Render(Camera& camera, const Objects::Hittable& world, const Obje
     }
     camera.Initialize();
 
+    if(camera.SamplingType == Camera::SamplerType::Adaptive && camera.RenderingType != Camera::RenderType::GPU)
+    {
+        CPUAdaptive(camera, world, lights);
+        std::clog << "\rDone.                                        ";
+        return;
+    }
+
     switch(camera.RenderingType)
     {
         case Camera::RenderType::CPUOneCore:
@@ -94,14 +112,20 @@ void Renderer::Render(Camera& camera, const Objects::Hittable& world, const Obje
         case Camera::RenderType::GPU:
             // TBA
             break;
+        case Camera::RenderType::CPUPackets:
+            CPUPackets(camera, world, lights);
+            break;
     }
 
     std::clog << "\rDone.                                        ";
-    m_Image->SetData(m_ImageData);
 
     if(camera.SamplingType == Camera::SamplerType::Accumulation)
     {
-        m_FrameCounter++;
+        // Part of the pixels of a cancelled frame hold one more sample than the rest, so the accumulation is restarted.
+        if(IsCancelled())
+            ResetFrameCounter();
+        else
+            m_FrameCounter++;
     }
 }
 
@@ -112,24 +136,25 @@ void Renderer::CPUOneCore(const Camera& camera, const Objects::Hittable& world,
         ResetPixelColorsAccumulator();
     }
 
-    for(uint32_t y = 0; y < m_Image->GetHeight(); y++)
+    const float colorScale = ColorScale(camera);
+    for(uint32_t y = 0; y < m_Height; y++)
     {
-        std::clog << "\rScanlines remaining: " << (m_Image->GetHeight() - y) << "                    " << std::flush;
-        for(uint32_t x = 0; x < m_Image->GetWidth(); x++)
+        std::clog << "\rScanlines remaining: " << (m_Height - y) << "                    " << std::flush;
+        for(uint32_t x = 0; x < m_Width; x++)
         {
+            if(IsCancelled())
+                return;
+
             if(camera.SamplingType == Camera::SamplerType::Accumulation)
             {
-                Ray r = camera.GetRay(static_cast<int>(x), static_cast<int>(y));
-                m_PixelColorsAccum[y * m_Image->GetWidth() + x] += camera.RayColor(r, camera.MaxDepth, world, lights);
-                const Color3 pixelColor = m_PixelColorsAccum[y * m_Image->GetWidth() + x];
-
-                m_ImageData[y * m_Image->GetWidth() + x] = GetColorRGBA(pixelColor, 1.0 / m_FrameCounter);
+                m_PixelColorsAccum[y * m_Width + x] += camera.SamplePixel(x, y, m_FrameCounter - 1, world, lights);
             }
             else
             {
-                m_ImageData[y * m_Image->GetWidth() + x] = camera.GetPixel(x, y, world, lights);
+                m_PixelColorsAccum[y * m_Width + x] = FloatColor(camera.GetPixel(x, y, world, lights));
             }
         }
+        FinishTile({0, y, m_Width, 1}, colorScale);
     }
 }
 
@@ -140,29 +165,219 @@ void Renderer::CPUMultiCore(Camera& camera, const Objects::Hittable& world, cons
         ResetPixelColorsAccumulator();
     }
 
-    std::for_each(
-        std::execution::par, m_ImageHeightIterator.begin(), m_ImageHeightIterator.end(),
-        [this, &camera, &world, &lights](uint32_t y)
+    m_Tiles = TileScheduler::MakeTiles(m_Width, m_Height, m_TileSize, m_TileOrder);
+    const auto renderTile = [this, &camera, &world, &lights, colorScale = ColorScale(camera)](const Tile& tile)
+    {
+        RenderTile(tile, camera, world, lights);
+        FinishTile(tile, colorScale);
+    };
+    m_TileScheduler.Run(m_Tiles, renderTile);
+}
+
+void Renderer::CPUPackets(const Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights)
+{
+    if(camera.SamplingType == Camera::SamplerType::Accumulation && m_FrameCounter == 1)
+    {
+        ResetPixelColorsAccumulator();
+    }
+
+    m_Tiles = TileScheduler::MakeTiles(m_Width, m_Height, m_TileSize, m_TileOrder);
+    const auto renderTile = [this, &camera, &world, &lights, colorScale = ColorScale(camera)](const Tile& tile)
+    {
+        RenderPacketTile(tile, camera, world, lights);
+        FinishTile(tile, colorScale);
+    };
+    m_TileScheduler.Run(m_Tiles, renderTile);
+}
+
+void Renderer::RenderTile(const Tile& tile, const Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights) const
+{
+    const uint32_t width = m_Width;
+    for(uint32_t y = tile.Y; y < tile.Y + tile.Height; y++)
+    {
+        for(uint32_t x = tile.X; x < tile.X + tile.Width; x++)
+        {
+            if(IsCancelled())
+                return;
+
+            if(camera.SamplingType == Camera::SamplerType::Accumulation)
+            {
+                m_PixelColorsAccum[y * width + x] += camera.SamplePixel(x, y, m_FrameCounter - 1, world, lights);
+            }
+            else
+            {
+                m_PixelColorsAccum[y * width + x] = FloatColor(camera.GetPixel(x, y, world, lights));
+            }
+        }
+    }
+}
+
+void Renderer::RenderPacketTile(const Tile& tile, const Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights) const
+{
+    const auto     blockWidth  = static_cast<uint32_t>(camera.PacketWidth());
+    const auto     blockHeight = static_cast<uint32_t>(camera.PacketHeight());
+    const uint32_t width       = m_Width;
+    const uint32_t tileRight   = tile.X + tile.Width;
+    const uint32_t tileBottom  = tile.Y + tile.Height;
+
+    for(uint32_t y = tile.Y; y < tileBottom; y += blockHeight)
+    {
+        for(uint32_t x = tile.X; x < tileRight; x += blockWidth)
         {
-            std::clog << "\rScanlines remaining: " << (m_Image->GetHeight() - y) << "                    " << std::flush;
-            std::for_each(
-                std::execution::par, m_ImageWidthIterator.begin(), m_ImageWidthIterator.end(),
-                [this, y, &camera, &world, &lights](const uint32_t x)
+            if(IsCancelled())
+                return;
+
+            Color3 colors[RayPacket::MaxSize];
+            camera.SamplePixelBlock(x, y, colors, world, lights);
+
+            for(uint32_t j = 0; j < blockHeight && y + j < tileBottom; j++)
+            {
+                for(uint32_t i = 0; i < blockWidth && x + i < tileRight; i++)
                 {
+                    const uint32_t pixel      = (y + j) * width + x + i;
+                    const Color3&  pixelColor = colors[j * blockWidth + i];
+
                     if(camera.SamplingType == Camera::SamplerType::Accumulation)
                     {
-                        Ray r = camera.GetRay(static_cast<int>(x), static_cast<int>(y));
-                        m_PixelColorsAccum[y * m_Image->GetWidth() + x] += camera.RayColor(r, camera.MaxDepth, world, lights);
-                        const Color3 pixelColor = m_PixelColorsAccum[y * m_Image->GetWidth() + x];
-
-                        m_ImageData[y * m_Image->GetWidth() + x] = GetColorRGBA(pixelColor, 1.0 / m_FrameCounter);
+                        m_PixelColorsAccum[pixel] += pixelColor;
                     }
                     else
                     {
-                        m_ImageData[y * m_Image->GetWidth() + x] = camera.GetPixel(x, y, world, lights);
+                        m_PixelColorsAccum[pixel] = FloatColor(pixelColor * camera.PixelSamplesScale);
                     }
-                });
-        });
+                }
+            }
+        }
+    }
+}
+
+void Renderer::CPUAdaptive(const Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights)
+{
+    const uint64_t pixelCount = static_cast<uint64_t>(m_Width) * m_Height;
+    const auto     maxSamples = static_cast<uint32_t>(camera.AdaptiveMaxSpp);
+
+    // SamplesPerPixel is the average budget, converged pixels hand their share to the noisy ones.
+    const uint64_t budget = pixelCount * static_cast<uint64_t>(std::max(camera.SamplesPerPixel, camera.AdaptiveMinSpp));
+
+    m_AdaptivePixels.assign(pixelCount, {});
+    m_AdaptiveStats            = {};
+    m_AdaptiveStats.PixelCount = pixelCount;
+
+    m_Tiles = TileScheduler::MakeTiles(m_Width, m_Height, m_TileSize, m_TileOrder);
+
+    // The first pass takes the minimum number of samples of every pixel, each later pass doubles the samples of the
+    // pixels that are still active, as long as the budget allows.
+    auto     sampleCount   = static_cast<uint32_t>(camera.AdaptiveMinSpp);
+    uint32_t activeSamples = 0;
+    while(sampleCount > 0)
+    {
+        const auto renderTile = [this, sampleCount, &camera, &world, &lights](const Tile& tile)
+        {
+            RenderAdaptiveTile(tile, sampleCount, camera, world, lights);
+            FinishTile(tile, 1.0f);
+        };
+        if(camera.RenderingType == Camera::RenderType::CPUOneCore)
+        {
+            for(const Tile& tile : m_Tiles)
+            {
+                renderTile(tile);
+            }
+        }
+        else
+        {
+            m_TileScheduler.Run(m_Tiles, renderTile);
+        }
+        if(IsCancelled())
+            break;
+
+        m_AdaptiveStats.Passes++;
+        activeSamples = std::min(activeSamples + sampleCount, maxSamples);
+
+        uint64_t activePixels           = 0;
+        m_AdaptiveStats.SampleCount     = 0;
+        m_AdaptiveStats.ConvergedPixels = 0;
+        for(const AdaptivePixel& pixel : m_AdaptivePixels)
+        {
+            m_AdaptiveStats.SampleCount += pixel.Samples;
+            if(pixel.Converged)
+                m_AdaptiveStats.ConvergedPixels++;
+            else if(pixel.Samples < maxSamples)
+                activePixels++;
+        }
+
+        if(activePixels == 0 || m_AdaptiveStats.SampleCount >= budget)
+            break;
+
+        const uint64_t remaining = budget - m_AdaptiveStats.SampleCount;
+        sampleCount              = static_cast<uint32_t>(std::min<uint64_t>(activeSamples, remaining / activePixels));
+    }
+}
+
+void Renderer::RenderAdaptiveTile(const Tile& tile, const uint32_t sampleCount, const Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights)
+{
+    const uint32_t width      = m_Width;
+    const auto     minSamples = static_cast<uint32_t>(camera.AdaptiveMinSpp);
+    const auto     maxSamples = static_cast<uint32_t>(camera.AdaptiveMaxSpp);
+
+    for(uint32_t y = tile.Y; y < tile.Y + tile.Height; y++)
+    {
+        for(uint32_t x = tile.X; x < tile.X + tile.Width; x++)
+        {
+            if(IsCancelled())
+                return;
+
+            AdaptivePixel& pixel = m_AdaptivePixels[y * width + x];
+            if(!pixel.Converged && pixel.Samples < maxSamples)
+            {
+                const uint32_t lastSample = std::min(pixel.Samples + sampleCount, maxSamples);
+                while(pixel.Samples < lastSample)
+                {
+                    const Color3 color = camera.SamplePixel(x, y, static_cast<int>(pixel.Samples), world, lights);
+                    pixel.Sum += color;
+                    pixel.Samples++;
+
+                    // The error is measured on the brightness the viewport shows, so dark noise counts as much as bright noise.
+                    const double brightness = LinearToGamma(std::min(Luminance(color), 1.0));
+                    const double delta      = brightness - pixel.Mean;
+                    pixel.Mean += delta / pixel.Samples;
+                    pixel.M2 += delta * (brightness - pixel.Mean);
+                }
+
+                // Identical samples do not prove a pixel converged, rare paths may simply not have been found yet. The
+                // prior counts one more sample half the brightness range away from the mean, so such pixels need about a
+                // hundred samples at the default threshold before they stop.
+                if(pixel.Samples >= minSamples)
+                {
+                    const double variance = (pixel.M2 + Impl::AdaptivePriorM2) / (pixel.Samples - 1);
+                    pixel.Converged       = std::sqrt(variance / pixel.Samples) <= camera.AdaptiveThreshold;
+                }
+            }
+
+            m_PixelColorsAccum[y * width + x] = FloatColor(camera.ShowSampleCount ? Impl::SampleCountColor(pixel.Samples, maxSamples) : pixel.Sum / pixel.Samples);
+        }
+    }
+}
+
+// Accumulated frames are averaged here, the other samplers store averages already.
+float Renderer::ColorScale(const Camera& camera) const
+{
+    return camera.SamplingType == Camera::SamplerType::Accumulation ? 1.0f / static_cast<float>(m_FrameCounter) : 1.0f;
+}
+
+// The colors are converted after the whole tile is traced, while it is still in the cache of the thread that traced it.
+void Renderer::FinishTile(const Tile& tile, const float colorScale) const
+{
+    if(IsCancelled())
+        return;
+
+    for(uint32_t y = tile.Y; y < tile.Y + tile.Height; y++)
+    {
+        const uint64_t row = static_cast<uint64_t>(y) * m_Width + tile.X;
+        ResolveColors(m_PixelColorsAccum + row, m_ImageData + row, tile.Width, colorScale);
+    }
+
+    if(m_TileCallback)
+        m_TileCallback(tile);
 }
 
 }    // namespace Render
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "Color.h"
+#include "TileScheduler.h"
 
-#include <Engine/Image.h>
-
-#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string_view>
 #include <vector>
 
 namespace Objects
@@ -18,35 +20,107 @@ namespace Render
 
 class Camera;
 
+// Work of the adaptive sampler over the last frame.
+struct AdaptiveStats
+{
+    uint32_t Passes          = 0;
+    uint64_t PixelCount      = 0;
+    uint64_t SampleCount     = 0;
+    uint64_t ConvergedPixels = 0;    // Pixels that stopped below the error threshold, the rest reached the budget or the cap
+
+    void Log(std::string_view name) const;
+};
+
 class Renderer
 {
 public:
-    Renderer() = default;
+    // Called from the rendering threads with every tile, or scanline of the single core renderer, whose pixels are
+    // final for the current pass.
+    using TileCallback = std::function<void(const Tile& tile)>;
+
+    // Zero threads means one per hardware thread.
+    explicit Renderer(const unsigned threadCount = 0)
+        : m_TileScheduler(threadCount)
+    {
+    }
 
     uint32_t GetFrameCounter() const { return m_FrameCounter; }
     void     ResetFrameCounter() { m_FrameCounter = 1; }
 
     void ResetPixelColorsAccumulator() const;
 
+    // Tile size is rounded up to a multiple of 4, so tiles always hold whole ray packet blocks.
+    uint32_t GetTileSize() const { return m_TileSize; }
+    void     SetTileSize(uint32_t tileSize);
+
+    TileOrder GetTileOrder() const { return m_TileOrder; }
+    void      SetTileOrder(const TileOrder order) { m_TileOrder = order; }
+
+    // Timings of the tiles of the last multi-core frame.
+    const TileStats& GetTileStats() const { return m_TileScheduler.Stats(); }
+
+    const AdaptiveStats& GetAdaptiveStats() const { return m_AdaptiveStats; }
+
+    void SetTileCallback(TileCallback callback) { m_TileCallback = std::move(callback); }
+
+    // Once the flag is set, the renderer stops within a pixel and leaves the rest of the image as it was. A cancelled
+    // frame is not counted, accumulation starts over with the next one.
+    void SetCancelFlag(const std::atomic<bool>* cancelled) { m_Cancelled = cancelled; }
+    bool IsCancelled() const { return m_Cancelled && m_Cancelled->load(std::memory_order_relaxed); }
+
     void SetImageSize(uint32_t width, uint32_t height);
     void RenderRandom() const;
     void RenderHelloWorld() const;
     void Render(Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights);
     void CPUOneCore(const Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights) const;
     void CPUMultiCore(Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights);
+    void CPUPackets(const Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights);
+    void CPUAdaptive(const Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights);
+    void RenderTile(const Tile& tile, const Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights) const;
+    void RenderPacketTile(const Tile& tile, const Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights) const;
+
+    // Adds up to sampleCount samples to each pixel of the tile that has not converged yet.
+    void RenderAdaptiveTile(const Tile& tile, uint32_t sampleCount, const Camera& camera, const Objects::Hittable& world, const Objects::HittableList& lights);
 
-    std::shared_ptr<Engine::Image> GetImage() const { return m_Image; }
+    // Rendered pixels, packed RGBA with 8 bits per channel, row by row from the top.
+    uint32_t        GetWidth() const { return m_Width; }
+    uint32_t        GetHeight() const { return m_Height; }
+    const uint32_t* GetImageData() const { return m_ImageData; }
 
 private:
-    int                            m_FrameCounter     = 1;
-    int                            m_Xs               = 0;
-    int                            m_Ys               = 0;
-    bool                           m_IsAccumulating   = false;
-    uint32_t*                      m_ImageData        = nullptr;
-    Color3*                        m_PixelColorsAccum = nullptr;
-    std::shared_ptr<Engine::Image> m_Image;
-    std::vector<uint32_t>          m_ImageHeightIterator;
-    std::vector<uint32_t>          m_ImageWidthIterator;
+    // Running statistics of a pixel for the adaptive sampler, taken over the displayed brightness of its samples.
+    struct AdaptivePixel
+    {
+        Color3   Sum;
+        double   Mean      = 0.0;
+        double   M2        = 0.0;    // Sum of squared differences from the mean, Welford's algorithm
+        uint32_t Samples   = 0;
+        bool     Converged = false;
+    };
+
+    int                      m_FrameCounter     = 1;
+    int                      m_Xs               = 0;
+    int                      m_Ys               = 0;
+    bool                     m_IsAccumulating   = false;
+    uint32_t                 m_Width            = 0;
+    uint32_t                 m_Height           = 0;
+    uint32_t*                m_ImageData        = nullptr;
+    FloatColor*              m_PixelColorsAccum = nullptr;    // Linear colors, resolved into m_ImageData tile by tile
+    uint32_t                 m_TileSize         = 32;
+    TileOrder                m_TileOrder        = TileOrder::Hilbert;
+    std::vector<Tile>        m_Tiles;
+    TileScheduler            m_TileScheduler;
+    TileCallback             m_TileCallback;
+    const std::atomic<bool>* m_Cancelled        = nullptr;
+
+    std::vector<AdaptivePixel> m_AdaptivePixels;
+    AdaptiveStats              m_AdaptiveStats;
+
+    // Scale that turns the colors of m_PixelColorsAccum into averages.
+    float ColorScale(const Camera& camera) const;
+
+    // Resolves the traced tile into the image and reports it.
+    void FinishTile(const Tile& tile, float colorScale) const;
 };
 
 }    // namespace Render
@@ -3,12 +3,7 @@
 #include "Color.h"
 #include "Ray.h"
 
-#include <memory>
-
-namespace Math
-{
-class PDF;
-}
+#include <Math/PDF.h>
 
 namespace Render
 {
@@ -16,10 +11,10 @@ namespace Render
 class ScatterRecord
 {
 public:
-    Color3                     Attenuation;
-    std::shared_ptr<Math::PDF> PDFPtr;
-    bool                       SkipPDF = false;
-    Ray                        SkipPDFRay;
+    Color3    Attenuation;
+    Math::PDF ScatterPDF;    // Stored inline, empty when SkipPDF is set
+    bool      SkipPDF = false;
+    Ray       SkipPDFRay;
 };
 
 }    // namespace Render
@@ -3,7 +3,7 @@
 namespace Render
 {
 
-Color3 SolidColor::Value(double u, double v, const Math::Point3& point) const
+Color3 SolidColor::Value(Math::Real u, Math::Real v, const Math::Point3& point) const
 {
     return m_ColorValue;
 }
@@ -13,12 +13,12 @@ public:
     {
     }
 
-    SolidColor(const double red, const double green, const double blue)
+    SolidColor(const Math::Real red, const Math::Real green, const Math::Real blue)
         : SolidColor(Color3(red, green, blue))
     {
     }
 
-    Color3 Value(double u, double v, const Math::Point3& point) const override;
+    Color3 Value(Math::Real u, Math::Real v, const Math::Point3& point) const override;
 
 private:
     Color3 m_ColorValue;
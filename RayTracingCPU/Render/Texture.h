@@ -10,7 +10,7 @@ class Texture
 public:
     virtual ~Texture() = default;
 
-    virtual Color3 Value(double u, double v, const Math::Point3& point) const = 0;
+    virtual Color3 Value(Math::Real u, Math::Real v, const Math::Point3& point) const = 0;
 };
 
 }    // namespace Render
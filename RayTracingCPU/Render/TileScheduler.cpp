@@ -0,0 +1,264 @@
+#include "TileScheduler.h"
+
+#include <Utils/Log.h>
+#include <Utils/Timers.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace Render
+{
+
+namespace Impl
+{
+
+    // Interleaves the bits of x and y, x in the even bits.
+    uint64_t MortonCode(const uint32_t x, const uint32_t y)
+    {
+        const auto spread = [](uint64_t v)
+        {
+            v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+            v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+            v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+            v = (v | (v << 2)) & 0x3333333333333333ull;
+            v = (v | (v << 1)) & 0x5555555555555555ull;
+            return v;
+        };
+        return spread(x) | (spread(y) << 1);
+    }
+
+    // Distance of x,y along the Hilbert curve that covers an n x n grid, n being a power of two.
+    uint64_t HilbertIndex(const uint32_t n, uint32_t x, uint32_t y)
+    {
+        uint64_t index = 0;
+        for(uint32_t s = n / 2; s > 0; s /= 2)
+        {
+            const uint32_t rx = (x & s) > 0 ? 1 : 0;
+            const uint32_t ry = (y & s) > 0 ? 1 : 0;
+            index += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+
+            // Rotate the quadrant, so the curve stays continuous.
+            if(ry == 0)
+            {
+                if(rx == 1)
+                {
+                    x = s - 1 - (x & (s - 1));
+                    y = s - 1 - (y & (s - 1));
+                }
+                std::swap(x, y);
+            }
+        }
+        return index;
+    }
+
+}    // namespace Impl
+
+void TileStats::Log(const std::string_view name) const
+{
+    LOG_INFO("{}: {} tiles on {} threads, {} stolen, tile min {:.3f} ms, mean {:.3f} ms, max {:.3f} ms, total {:.3f} ms",
+             name, TileCount, ThreadCount, StealCount, MinTileMs, MeanTileMs, MaxTileMs, TotalMs);
+}
+
+TileScheduler::TileScheduler(unsigned threadCount)
+{
+    if(threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for(unsigned i = 0; i < threadCount; i++)
+    {
+        m_Queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    m_StealCounts.resize(threadCount);
+
+    // Worker 0 is the thread that calls Run().
+    for(unsigned i = 1; i < threadCount; i++)
+    {
+        m_Threads.emplace_back(&TileScheduler::WorkerLoop, this, i);
+    }
+}
+
+TileScheduler::~TileScheduler()
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_WakeCondition.notify_all();
+
+    for(auto& thread : m_Threads)
+    {
+        thread.join();
+    }
+}
+
+std::vector<Tile> TileScheduler::MakeTiles(const uint32_t width, const uint32_t height, uint32_t tileSize, const TileOrder order)
+{
+    tileSize = std::max(tileSize, 1u);
+
+    const uint32_t columns  = (width + tileSize - 1) / tileSize;
+    const uint32_t rows     = (height + tileSize - 1) / tileSize;
+    const uint32_t gridSize = std::bit_ceil(std::max(columns, rows));
+
+    struct OrderedTile
+    {
+        uint64_t Key;
+        Tile     Area;
+    };
+
+    std::vector<OrderedTile> orderedTiles;
+    orderedTiles.reserve(static_cast<size_t>(columns) * rows);
+    for(uint32_t row = 0; row < rows; row++)
+    {
+        for(uint32_t column = 0; column < columns; column++)
+        {
+            uint64_t key = static_cast<uint64_t>(row) * columns + column;
+            if(order == TileOrder::Morton)
+                key = Impl::MortonCode(column, row);
+            else if(order == TileOrder::Hilbert)
+                key = Impl::HilbertIndex(gridSize, column, row);
+
+            const uint32_t x = column * tileSize;
+            const uint32_t y = row * tileSize;
+            orderedTiles.push_back({key, {x, y, std::min(tileSize, width - x), std::min(tileSize, height - y)}});
+        }
+    }
+
+    std::ranges::sort(orderedTiles, {}, &OrderedTile::Key);
+
+    std::vector<Tile> tiles;
+    tiles.reserve(orderedTiles.size());
+    for(const auto& orderedTile : orderedTiles)
+    {
+        tiles.push_back(orderedTile.Area);
+    }
+    return tiles;
+}
+
+void TileScheduler::Run(const std::vector<Tile>& tiles, const TileFunction& renderTile)
+{
+    const Utils::Timer timer;
+    const auto         threadCount = ThreadCount();
+
+    m_TileTimes.assign(tiles.size(), 0.0);
+    std::ranges::fill(m_StealCounts, 0);
+
+    // Each worker starts on its own contiguous run of the curve.
+    for(unsigned worker = 0; worker < threadCount; worker++)
+    {
+        const size_t first = tiles.size() * worker / threadCount;
+        const size_t last  = tiles.size() * (worker + 1) / threadCount;
+
+        std::lock_guard lock(m_Queues[worker]->Mutex);
+        m_Queues[worker]->Tiles.clear();
+        for(size_t i = first; i < last; i++)
+        {
+            m_Queues[worker]->Tiles.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Tiles         = &tiles;
+        m_RenderTile    = &renderTile;
+        m_ActiveWorkers = threadCount - 1;
+        m_Generation++;
+    }
+    m_WakeCondition.notify_all();
+
+    RenderTiles(0);
+
+    {
+        std::unique_lock lock(m_Mutex);
+        m_DoneCondition.wait(lock, [this] { return m_ActiveWorkers == 0; });
+        m_Tiles      = nullptr;
+        m_RenderTile = nullptr;
+    }
+
+    m_Stats             = {};
+    m_Stats.TileCount   = tiles.size();
+    m_Stats.ThreadCount = threadCount;
+    m_Stats.TotalMs     = timer.ElapsedMilliseconds();
+    for(const uint32_t steals : m_StealCounts)
+    {
+        m_Stats.StealCount += steals;
+    }
+    if(!m_TileTimes.empty())
+    {
+        const auto [minTime, maxTime] = std::ranges::minmax(m_TileTimes);
+
+        m_Stats.MinTileMs = minTime;
+        m_Stats.MaxTileMs = maxTime;
+        for(const double time : m_TileTimes)
+        {
+            m_Stats.MeanTileMs += time;
+        }
+        m_Stats.MeanTileMs /= static_cast<double>(m_TileTimes.size());
+    }
+}
+
+void TileScheduler::WorkerLoop(const unsigned worker)
+{
+    uint64_t generation = 0;
+    while(true)
+    {
+        {
+            std::unique_lock lock(m_Mutex);
+            m_WakeCondition.wait(lock, [this, generation] { return m_Stop || m_Generation != generation; });
+            if(m_Stop)
+                return;
+            generation = m_Generation;
+        }
+
+        RenderTiles(worker);
+
+        {
+            std::lock_guard lock(m_Mutex);
+            m_ActiveWorkers--;
+        }
+        m_DoneCondition.notify_one();
+    }
+}
+
+void TileScheduler::RenderTiles(const unsigned worker)
+{
+    uint32_t tile = 0;
+    while(NextTile(worker, tile))
+    {
+        const Utils::Timer timer;
+        (*m_RenderTile)((*m_Tiles)[tile]);
+        m_TileTimes[tile] = timer.ElapsedMilliseconds();
+    }
+}
+
+bool TileScheduler::NextTile(const unsigned worker, uint32_t& tile)
+{
+    {
+        WorkerQueue&    queue = *m_Queues[worker];
+        std::lock_guard lock(queue.Mutex);
+        if(!queue.Tiles.empty())
+        {
+            tile = queue.Tiles.front();
+            queue.Tiles.pop_front();
+            return true;
+        }
+    }
+
+    // Steal from the end of another run, which is the work its owner would reach last. No tiles are added during a
+    // run, so once every queue is empty the worker is done.
+    const auto threadCount = ThreadCount();
+    for(unsigned i = 1; i < threadCount; i++)
+    {
+        WorkerQueue&    victim = *m_Queues[(worker + i) % threadCount];
+        std::lock_guard lock(victim.Mutex);
+        if(!victim.Tiles.empty())
+        {
+            tile = victim.Tiles.back();
+            victim.Tiles.pop_back();
+            m_StealCounts[worker]++;
+            return true;
+        }
+    }
+    return false;
+}
+
+}    // namespace Render
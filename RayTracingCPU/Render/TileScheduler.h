@@ -0,0 +1,97 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Render
+{
+
+// Order in which the tiles of an image are handed out. Space-filling curves keep consecutive tiles close to each
+// other, so a thread working through its run of tiles touches neighbouring parts of the scene.
+enum class TileOrder : int
+{
+    Scanline = 0,
+    Morton   = 1,
+    Hilbert  = 2
+};
+
+struct Tile
+{
+    uint32_t X      = 0;
+    uint32_t Y      = 0;
+    uint32_t Width  = 0;
+    uint32_t Height = 0;
+};
+
+// Timings of the last TileScheduler::Run.
+struct TileStats
+{
+    size_t   TileCount   = 0;
+    unsigned ThreadCount = 0;
+    uint32_t StealCount  = 0;      // Tiles a thread took from the queue of another thread
+    double   MinTileMs   = 0.0;
+    double   MaxTileMs   = 0.0;
+    double   MeanTileMs  = 0.0;
+    double   TotalMs     = 0.0;    // Wall time of the whole run
+
+    void Log(std::string_view name) const;
+};
+
+// Splits an image into tiles and renders them on a pool of persistent worker threads. Every thread gets a contiguous
+// run of the tiles in its own deque and works through it from the front. A thread that runs out of work steals from
+// the back of the other deques, which keeps all threads busy when some parts of the image are much more expensive.
+class TileScheduler
+{
+public:
+    using TileFunction = std::function<void(const Tile& tile)>;
+
+    // Zero threads means one per hardware thread. The calling thread of Run() is one of them.
+    explicit TileScheduler(unsigned threadCount = 0);
+    ~TileScheduler();
+
+    TileScheduler(const TileScheduler&)            = delete;
+    TileScheduler& operator=(const TileScheduler&) = delete;
+
+    static std::vector<Tile> MakeTiles(uint32_t width, uint32_t height, uint32_t tileSize, TileOrder order);
+
+    // Calls renderTile once for every tile and returns when all tiles are done.
+    void Run(const std::vector<Tile>& tiles, const TileFunction& renderTile);
+
+    unsigned                   ThreadCount() const { return static_cast<unsigned>(m_Queues.size()); }
+    const TileStats&           Stats() const { return m_Stats; }
+    const std::vector<double>& TileTimes() const { return m_TileTimes; }    // Milliseconds per tile of the last run
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex           Mutex;
+        std::deque<uint32_t> Tiles;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+    std::vector<std::thread>                  m_Threads;
+    std::mutex                                m_Mutex;
+    std::condition_variable                   m_WakeCondition;
+    std::condition_variable                   m_DoneCondition;
+    uint64_t                                  m_Generation    = 0;    // Incremented for every Run, wakes the workers
+    unsigned                                  m_ActiveWorkers = 0;
+    bool                                      m_Stop          = false;
+    const std::vector<Tile>*                  m_Tiles         = nullptr;
+    const TileFunction*                       m_RenderTile    = nullptr;
+    std::vector<double>                       m_TileTimes;
+    std::vector<uint32_t>                     m_StealCounts;    // Per worker, so no atomics are needed
+    TileStats                                 m_Stats;
+
+    void WorkerLoop(unsigned worker);
+    void RenderTiles(unsigned worker);
+    bool NextTile(unsigned worker, uint32_t& tile);
+};
+
+}    // namespace Render
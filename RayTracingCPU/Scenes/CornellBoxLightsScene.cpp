@@ -55,11 +55,8 @@ CornellBoxLightsScene::CornellBoxLightsScene(const double aspectRatio, const int
     // m_World.Add(std::make_shared<Objects:Quad>(Math::Point3(555, 0, 555), Math::Vector3(-555, 0, 0), Math::Vector3(0, 555, 0), white));
 
     m_World.Add(std::make_shared<Objects::Sphere>(Math::Point3(530, 530, 277), 50, lightR));
-    m_Lights.Add(std::make_shared<Objects::Sphere>(Math::Point3(530, 530, 277), 50, lightR));
     m_World.Add(std::make_shared<Objects::Sphere>(Math::Point3(277, 530, 277), 50, lightB));
-    m_Lights.Add(std::make_shared<Objects::Sphere>(Math::Point3(277, 530, 277), 50, lightB));
     m_World.Add(std::make_shared<Objects::Sphere>(Math::Point3(30, 530, 277), 50, lightG));
-    m_Lights.Add(std::make_shared<Objects::Sphere>(Math::Point3(30, 530, 277), 50, lightG));
     // m_World.Add(std::make_shared<Objects::Sphere>(Point3(277, 25, 277), 50, lightW));
 
     m_World.Add(std::make_shared<Objects::Sphere>(Math::Point3(405, 100, 277.5), 100, glass));
@@ -0,0 +1,90 @@
+#include "Scene.h"
+
+#include <Math/Transform.h>
+#include <Math/Vector3.h>
+#include <Objects/Instance.h>
+#include <Objects/ModelLoader.h>
+#include <Objects/Sphere.h>
+#include <Objects/SphereSet.h>
+#include <Objects/TriangleMesh.h>
+#include <Render/Dielectric.h>
+#include <Render/Lambertian.h>
+#include <Render/Metal.h>
+#include <Utils/Filesystem.h>
+#include <Utils/Random.h>
+
+namespace Scenes
+{
+
+// Same as RTWeekOne: Final, with three instances of the Lucy model in place of the large spheres.
+LucyInOneWeekendScene::LucyInOneWeekendScene(const double aspectRatio, const int width, const int samplesPerPixel, const int maxDepth)
+    : Scene(aspectRatio, width, samplesPerPixel, maxDepth)
+{
+    auto groundMaterial = std::make_shared<Render::Lambertian>(Render::Color3(0.5, 0.5, 0.5));
+    m_World.Add(std::make_shared<Objects::Sphere>(Math::Point3(0, -1000, 0), 1000, groundMaterial));
+
+    auto spheres = std::make_shared<Objects::SphereSet>();
+    for(int a = -11; a < 11; a++)
+    {
+        for(int b = -11; b < 11; b++)
+        {
+            const auto   chooseMaterial = Utils::Random::Double();
+            Math::Point3 center(a + 0.9 * Utils::Random::Double(), 0.2, b + 0.9 * Utils::Random::Double());
+
+            if((center - Math::Point3(4, 0.2, 0)).Length() > 0.9)
+            {
+                std::shared_ptr<Render::Material> sphereMaterial;
+
+                if(chooseMaterial < 0.8)
+                {
+                    // diffuse
+                    auto albedo    = Render::Color3::Random() * Render::Color3::Random();
+                    sphereMaterial = std::make_shared<Render::Lambertian>(albedo);
+                    spheres->Add(center, 0.2, sphereMaterial);
+                }
+                else if(chooseMaterial < 0.95)
+                {
+                    // metal
+                    auto albedo    = Render::Color3::Random(0.5, 1);
+                    auto fuzz      = Utils::Random::Double(0, 0.5);
+                    sphereMaterial = std::make_shared<Render::Metal>(albedo, fuzz);
+                    spheres->Add(center, 0.2, sphereMaterial);
+                }
+                else
+                {
+                    // glass
+                    sphereMaterial = std::make_shared<Render::Dielectric>(1.5);
+                    spheres->Add(center, 0.2, sphereMaterial);
+                }
+            }
+        }
+    }
+    m_World.Add(spheres);
+
+    // One mesh, placed three times with different materials. The model is not part of the repository, without it the
+    // scene has no statues.
+    auto lucy = std::make_shared<Objects::TriangleMesh>(Objects::LoadModel(Utils::ThisExecutableLocation() + "/Resources/Models/lucy.obj"));
+    if(lucy->TriangleCount() > 0)
+    {
+        const auto scaleAndRotate = Math::Transform::Scale(0.0035) * Math::Transform::Rotate(90, Math::Vector3(0, 1, 0));
+        m_World.Add(std::make_shared<Objects::Instance>(lucy, Math::Transform::Translate(Math::Vector3(0, -0.08, 0)) * scaleAndRotate, std::make_shared<Render::Dielectric>(1.5)));
+        m_World.Add(std::make_shared<Objects::Instance>(lucy, Math::Transform::Translate(Math::Vector3(-4, -0.08, 0)) * scaleAndRotate, std::make_shared<Render::Lambertian>(Render::Color3(0.4, 0.2, 0.1))));
+        m_World.Add(std::make_shared<Objects::Instance>(lucy, Math::Transform::Translate(Math::Vector3(4, -0.08, 0)) * scaleAndRotate, std::make_shared<Render::Metal>(Render::Color3(0.7, 0.6, 0.5), 0.05)));
+    }
+
+    m_Camera.AspectRatio     = m_AspectRatio;
+    m_Camera.ImageWidth      = m_Width;
+    m_Camera.SamplesPerPixel = m_SamplesPerPixel;
+    m_Camera.MaxDepth        = m_MaxDepth;
+    m_Camera.Background      = Render::Color3(0.70, 0.80, 1.00);
+
+    m_Camera.Vfov     = 20;
+    m_Camera.LookFrom = Math::Point3(13, 2, 3);
+    m_Camera.LookAt   = Math::Point3(0, 1, 0);
+    m_Camera.VUp      = Math::Vector3(0, 1, 0);
+
+    m_Camera.DefocusAngle = 0.3;
+    m_Camera.FocusDist    = 10.0;
+}
+
+}    // namespace Scenes
@@ -1,11 +1,11 @@
 #include "Scene.h"
 
+#include <Math/Transform.h>
 #include <Math/Vector3.h>
 #include <Objects/Box.h>
 #include <Objects/ConstantMedium.h>
+#include <Objects/Instance.h>
 #include <Objects/Quad.h>
-#include <Objects/RotateY.h>
-#include <Objects/Translate.h>
 #include <Render/DiffuseLight.h>
 #include <Render/Lambertian.h>
 
@@ -30,16 +30,13 @@ RTWeekNextCornellSmokeScene::RTWeekNextCornellSmokeScene(const double aspectRati
 
     // Lights
     m_World.Add(std::make_shared<Objects::Quad>(Math::Point3(113, 554, 127), Math::Vector3(330, 0, 0), Math::Vector3(0, 0, 305), light));
-    m_Lights.Add(std::make_shared<Objects::Quad>(Math::Point3(113, 554, 127), Math::Vector3(329, 0, 0), Math::Vector3(0, 0, 304), light));
 
     std::shared_ptr<Objects::Hittable> box1 = Objects::Box(Math::Point3(0, 0, 0), Math::Point3(165, 330, 165), white);
-    box1                                    = std::make_shared<Objects::RotateY>(box1, 15);
-    box1                                    = std::make_shared<Objects::Translate>(box1, Math::Vector3(265, 0, 295));
+    box1                                    = std::make_shared<Objects::Instance>(box1, Math::Transform::Translate(Math::Vector3(265, 0, 295)) * Math::Transform::Rotate(15, Math::Vector3(0, 1, 0)));
     m_World.Add(std::make_shared<Objects::ConstantMedium>(box1, 0.01, Render::Color3(0, 0, 0)));
 
     std::shared_ptr<Objects::Hittable> box2 = Objects::Box(Math::Point3(0, 0, 0), Math::Point3(165, 165, 165), white);
-    box2                                    = std::make_shared<Objects::RotateY>(box2, -18);
-    box2                                    = std::make_shared<Objects::Translate>(box2, Math::Vector3(130, 0, 65));
+    box2                                    = std::make_shared<Objects::Instance>(box2, Math::Transform::Translate(Math::Vector3(130, 0, 65)) * Math::Transform::Rotate(-18, Math::Vector3(0, 1, 0)));
     m_World.Add(std::make_shared<Objects::ConstantMedium>(box2, 0.01, Render::Color3(1, 1, 1)));
 
     m_Camera.AspectRatio     = m_AspectRatio;
@@ -1,13 +1,15 @@
 #include "Scene.h"
 
+#include <Math/Transform.h>
 #include <Math/Vector3.h>
 #include <Objects/BVH.h>
 #include <Objects/Box.h>
 #include <Objects/ConstantMedium.h>
+#include <Objects/Instance.h>
 #include <Objects/Quad.h>
-#include <Objects/RotateY.h>
 #include <Objects/Sphere.h>
-#include <Objects/Translate.h>
+#include <Objects/SphereSet.h>
+#include <Objects/WideBVH.h>
 #include <Render/Dielectric.h>
 #include <Render/DiffuseLight.h>
 #include <Render/ImageTexture.h>
@@ -49,7 +51,6 @@ RTWeekNextFinalScene::RTWeekNextFinalScene(const double aspectRatio, const int w
     // Lights
     auto light = std::make_shared<Render::DiffuseLight>(Render::Color3(7, 7, 7));
     m_World.Add(std::make_shared<Objects::Quad>(Math::Point3(123, 554, 147), Math::Vector3(300, 0, 0), Math::Vector3(0, 0, 265), light));
-    m_Lights.Add(std::make_shared<Objects::Quad>(Math::Point3(123, 554, 147), Math::Vector3(299, 0, 0), Math::Vector3(0, 0, 264), light));
 
     auto center1        = Math::Point3(400, 400, 200);
     auto center2        = center1 + Math::Vector3(30, 0, 0);
@@ -72,15 +73,15 @@ RTWeekNextFinalScene::RTWeekNextFinalScene(const double aspectRatio, const int w
     auto pertext = std::make_shared<Render::NoiseTexture>(0.1);
     m_World.Add(std::make_shared<Objects::Sphere>(Math::Point3(220, 280, 300), 80, std::make_shared<Render::Lambertian>(pertext)));
 
-    Objects::HittableList boxes2;
-    auto                  white = std::make_shared<Render::Lambertian>(Render::Color3(.73, .73, .73));
-    constexpr int         ns    = 1000;
+    Objects::SphereSet boxes2;
+    auto               white = std::make_shared<Render::Lambertian>(Render::Color3(.73, .73, .73));
+    constexpr int      ns    = 1000;
     for(int j = 0; j < ns; j++)
     {
-        boxes2.Add(std::make_shared<Objects::Sphere>(Math::Point3::Random(0, 165), 10, white));
+        boxes2.Add(Math::Point3::Random(0, 165), 10, white);
     }
 
-    m_World.Add(std::make_shared<Objects::Translate>(std::make_shared<Objects::RotateY>(std::make_shared<Objects::BVHNode>(boxes2), 15), Math::Vector3(-100, 270, 395)));
+    m_World.Add(std::make_shared<Objects::Instance>(std::make_shared<Objects::BVH8>(boxes2.Clusters()), Math::Transform::Translate(Math::Vector3(-100, 270, 395)) * Math::Transform::Rotate(15, Math::Vector3(0, 1, 0))));
 
     m_Camera.AspectRatio     = m_AspectRatio;
     m_Camera.ImageWidth      = m_Width;
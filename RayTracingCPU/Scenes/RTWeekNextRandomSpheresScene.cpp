@@ -1,8 +1,8 @@
 #include "Scene.h"
 
 #include <Math/Vector3.h>
-#include <Objects/BVH.h>
 #include <Objects/Sphere.h>
+#include <Objects/SphereSet.h>
 #include <Render/CheckerTexture.h>
 #include <Render/Dielectric.h>
 #include <Render/Lambertian.h>
@@ -26,6 +26,7 @@ RTWeekNextRandomSpheresScene::RTWeekNextRandomSpheresScene(const double aspectRa
     auto lightMaterial = std::shared_ptr<Render::Material>();
     m_Lights.Add(std::make_shared<Objects::Sphere>(Math::Point3(0, 15, 0), 2, lightMaterial));
 
+    auto spheres = std::make_shared<Objects::SphereSet>();
     for(int a = -11; a < 11; a++)
     {
         for(int b = -11; b < 11; b++)
@@ -43,7 +44,7 @@ RTWeekNextRandomSpheresScene::RTWeekNextRandomSpheresScene(const double aspectRa
                     auto albedo    = Render::Color3::Random() * Render::Color3::Random();
                     sphereMaterial = std::make_shared<Render::Lambertian>(albedo);
                     auto center2   = center + Math::Vector3(0, Utils::Random::Double(0.0, 0.5), 0);
-                    m_World.Add(std::make_shared<Objects::Sphere>(center, center2, 0.2, sphereMaterial));
+                    spheres->Add(center, center2, 0.2, sphereMaterial);
                 }
                 else if(chooseMaterial < 0.95)
                 {
@@ -51,17 +52,18 @@ RTWeekNextRandomSpheresScene::RTWeekNextRandomSpheresScene(const double aspectRa
                     auto albedo    = Render::Color3::Random(0.5, 1);
                     auto fuzz      = Utils::Random::Double(0, 0.5);
                     sphereMaterial = std::make_shared<Render::Metal>(albedo, fuzz);
-                    m_World.Add(std::make_shared<Objects::Sphere>(center, 0.2, sphereMaterial));
+                    spheres->Add(center, 0.2, sphereMaterial);
                 }
                 else
                 {
                     // glass
                     sphereMaterial = std::make_shared<Render::Dielectric>(1.5);
-                    m_World.Add(std::make_shared<Objects::Sphere>(center, 0.2, sphereMaterial));
+                    spheres->Add(center, 0.2, sphereMaterial);
                 }
             }
         }
     }
+    m_World.Add(spheres);
 
     auto material1 = std::make_shared<Render::Dielectric>(1.5);
     m_World.Add(std::make_shared<Objects::Sphere>(Math::Point3(0, 1, 0), 1.0, material1));
@@ -72,8 +74,6 @@ RTWeekNextRandomSpheresScene::RTWeekNextRandomSpheresScene(const double aspectRa
     auto material3 = std::make_shared<Render::Metal>(Render::Color3(0.7, 0.6, 0.5), 0.0);
     m_World.Add(std::make_shared<Objects::Sphere>(Math::Point3(4, 1, 0), 1.0, material3));
 
-    m_World = Objects::HittableList(std::make_shared<Objects::BVHNode>(m_World));
-
     m_Camera.AspectRatio     = m_AspectRatio;
     m_Camera.ImageWidth      = m_Width;
     m_Camera.SamplesPerPixel = m_SamplesPerPixel;
@@ -1,10 +1,10 @@
 #include "Scene.h"
 
+#include <Math/Transform.h>
 #include <Math/Vector3.h>
 #include <Objects/Box.h>
+#include <Objects/Instance.h>
 #include <Objects/Quad.h>
-#include <Objects/RotateY.h>
-#include <Objects/Translate.h>
 #include <Render/DiffuseLight.h>
 #include <Render/Lambertian.h>
 
@@ -33,19 +33,14 @@ RTWeekRestACornellBoxScene::RTWeekRestACornellBoxScene(const double aspectRatio,
 
     // Box 1
     std::shared_ptr<Objects::Hittable> box1 = Objects::Box(Math::Point3(0, 0, 0), Math::Point3(165, 330, 165), white);
-    box1                                    = std::make_shared<Objects::RotateY>(box1, 15);
-    box1                                    = std::make_shared<Objects::Translate>(box1, Math::Vector3(265, 0, 295));
+    box1                                    = std::make_shared<Objects::Instance>(box1, Math::Transform::Translate(Math::Vector3(265, 0, 295)) * Math::Transform::Rotate(15, Math::Vector3(0, 1, 0)));
     m_World.Add(box1);
 
     // Box 2
     std::shared_ptr<Objects::Hittable> box2 = Objects::Box(Math::Point3(0, 0, 0), Math::Point3(165, 165, 165), white);
-    box2                                    = std::make_shared<Objects::RotateY>(box2, -18);
-    box2                                    = std::make_shared<Objects::Translate>(box2, Math::Vector3(130, 0, 65));
+    box2                                    = std::make_shared<Objects::Instance>(box2, Math::Transform::Translate(Math::Vector3(130, 0, 65)) * Math::Transform::Rotate(-18, Math::Vector3(0, 1, 0)));
     m_World.Add(box2);
 
-    auto m = std::shared_ptr<Render::Material>();
-    m_Lights.Add(std::make_shared<Objects::Quad>(Math::Point3(343, 554, 332), Math::Vector3(-130, 0, 0), Math::Vector3(0, 0, -105), m));
-
     m_Camera.AspectRatio     = m_AspectRatio;
     m_Camera.ImageWidth      = m_Width;
     m_Camera.SamplesPerPixel = m_SamplesPerPixel;
@@ -1,11 +1,11 @@
 #include "Scene.h"
 
+#include <Math/Transform.h>
 #include <Math/Vector3.h>
 #include <Objects/Box.h>
+#include <Objects/Instance.h>
 #include <Objects/Quad.h>
-#include <Objects/RotateY.h>
 #include <Objects/Sphere.h>
-#include <Objects/Translate.h>
 #include <Render/Dielectric.h>
 #include <Render/DiffuseLight.h>
 #include <Render/Lambertian.h>
@@ -35,16 +35,15 @@ RTWeekRestCCornellBoxGlassScene::RTWeekRestCCornellBoxGlassScene(const double as
 
     // Box
     std::shared_ptr<Objects::Hittable> box1 = Objects::Box(Math::Point3(0, 0, 0), Math::Point3(165, 330, 165), white);
-    box1                                    = std::make_shared<Objects::RotateY>(box1, 15);
-    box1                                    = std::make_shared<Objects::Translate>(box1, Math::Vector3(265, 0, 295));
+    box1                                    = std::make_shared<Objects::Instance>(box1, Math::Transform::Translate(Math::Vector3(265, 0, 295)) * Math::Transform::Rotate(15, Math::Vector3(0, 1, 0)));
     m_World.Add(box1);
 
     // Glass Sphere
     auto glass = std::make_shared<Render::Dielectric>(1.5);
     m_World.Add(std::make_shared<Objects::Sphere>(Math::Point3(190, 90, 190), 90, glass));
 
+    // The light is found in the world, the glass sphere is sampled like one for its caustics.
     auto m = std::shared_ptr<Render::Material>();
-    m_Lights.Add(std::make_shared<Objects::Quad>(Math::Point3(343, 554, 332), Math::Vector3(-130, 0, 0), Math::Vector3(0, 0, -105), m));
     m_Lights.Add(std::make_shared<Objects::Sphere>(Math::Point3(190, 90, 190), 90, m));
 
     m_Camera.AspectRatio     = m_AspectRatio;
@@ -1,8 +1,33 @@
 #include "Scene.h"
 
+#include <Objects/Instance.h>
+#include <Objects/LinearBVH.h>
+#include <Objects/TopLevelBVH.h>
+#include <Objects/WideBVH.h>
+#include <Utils/Log.h>
+
 namespace Scenes
 {
 
+namespace Impl
+{
+
+    std::shared_ptr<Objects::Hittable> CompileBVH(const Objects::HittableList& objects, const Objects::BVHBuildOptions& options)
+    {
+        switch(options.Layout)
+        {
+            case Objects::BVHLayout::Binary:
+                return std::make_shared<Objects::LinearBVH>(objects, options);
+            case Objects::BVHLayout::BVH4:
+                return std::make_shared<Objects::BVH4>(objects, options);
+            case Objects::BVHLayout::BVH8:
+            default:
+                return std::make_shared<Objects::BVH8>(objects, options);
+        }
+    }
+
+}    // namespace Impl
+
 Render::Camera& Scene::GetCamera()
 {
     return m_Camera;
@@ -10,12 +35,167 @@ Render::Camera& Scene::GetCamera()
 
 Objects::Hittable& Scene::GetWorld()
 {
-    return m_World;
+    if(!m_CompiledWorld)
+    {
+        uint32_t primitiveId = 0;
+        m_Materials.Clear();
+        m_World.AssignIds(m_Materials, primitiveId);
+
+        // The lights refer to the material table as well, they are numbered again on the next GetLights() call.
+        m_LightsCollected = false;
+
+        // Instances in the world are kept out of the flattened BVH, they go into a top level over their own
+        // structures and a BVH of everything else, so that they can be moved without rebuilding the world.
+        std::vector<std::shared_ptr<Objects::Instance>> instances;
+        Objects::HittableList                           staticObjects;
+        for(const auto& object : m_World.Objects)
+        {
+            if(auto instance = std::dynamic_pointer_cast<Objects::Instance>(object))
+                instances.emplace_back(std::move(instance));
+            else
+                staticObjects.Add(object);
+        }
+
+        if(instances.empty())
+        {
+            m_TopLevel.reset();
+            m_CompiledWorld = Impl::CompileBVH(m_World, m_BVHBuildOptions);
+        }
+        else
+        {
+            auto staticBVH  = staticObjects.Objects.empty() ? nullptr : Impl::CompileBVH(staticObjects, m_BVHBuildOptions);
+            m_TopLevel      = std::make_shared<Objects::TopLevelBVH>(std::move(instances), std::move(staticBVH), m_BVHBuildOptions);
+            m_CompiledWorld = m_TopLevel;
+        }
+    }
+    return *m_CompiledWorld;
+}
+
+Objects::TopLevelBVH* Scene::GetTopLevel()
+{
+    GetWorld();
+    return m_TopLevel.get();
 }
 
 Objects::HittableList& Scene::GetLights()
 {
-    return m_Lights;
+    if(m_LightsCollected)
+        return m_LightSampler;
+
+    // Light samples take the emission from the hit records of the lights, so the lights need the material indices of
+    // the compiled world.
+    GetWorld();
+
+    Objects::HittableList   lights;
+    std::vector<Math::Real> powers;
+    m_World.CollectEmitters(lights, powers, nullptr);
+
+    // The extra targets have no power of their own, they get the average of the emitters. A scene with one light and
+    // one target then samples both evenly.
+    Math::Real targetPower = 1;
+    if(!powers.empty())
+    {
+        targetPower = 0;
+        for(const Math::Real power : powers)
+            targetPower += power / static_cast<Math::Real>(powers.size());
+    }
+    for(const auto& target : m_Lights.Objects)
+    {
+        lights.Add(target);
+        powers.emplace_back(targetPower);
+    }
+
+    uint32_t lightPrimitiveId = 0;
+    lights.AssignIds(m_Materials, lightPrimitiveId);
+
+    LOG_INFO("Scene lights: {} emitters, {} extra targets", lights.Objects.size() - m_Lights.Objects.size(), m_Lights.Objects.size());
+
+    if(lights.Objects.size() < LightBVHThreshold)
+        m_LightSampler = std::move(lights);
+    else
+        m_LightSampler = Objects::HittableList(std::make_shared<Objects::LightBVH>(lights, powers, m_LightSelection));
+    m_LightsCollected = true;
+    return m_LightSampler;
+}
+
+void Scene::SetBVHBuildOptions(const Objects::BVHBuildOptions& options)
+{
+    m_BVHBuildOptions = options;
+    m_CompiledWorld.reset();
+    m_TopLevel.reset();
+}
+
+void Scene::SetLightSelection(const Objects::LightSelection selection)
+{
+    m_LightSelection  = selection;
+    m_LightsCollected = false;
+}
+
+const std::array<const char*, 19> SceneNames = {
+    "RTWeekOne: Default",
+    "RTWeekOne: Test",
+    "RTWeekOne: Final",
+    "RTWeekNext: Default",
+    "RTWeekNext: Random Spheres",
+    "RTWeekNext: Two Spheres",
+    "RTWeekNext: Earth",
+    "RTWeekNext: Two Perlin Spheres",
+    "RTWeekNext: Quads",
+    "RTWeekNext: Simple Light",
+    "RTWeekNext: Cornell Box",
+    "RTWeekNext: Cornell Smoke",
+    "RTWeekNext: Final",
+    "RTWeekRest: Cornell Box (Simple)",
+    "RTWeekRest: Cornell Box (Mirror)",
+    "RTWeekRest: Cornell Box (Glass)",
+    "White Speres",
+    "Cornell Box Lights",
+    "Lucy In One Weekend"};
+
+std::shared_ptr<Scene> CreateScene(const int sceneId, const double aspectRatio, const int width, const int samplesPerPixel, const int maxDepth)
+{
+    switch(sceneId)
+    {
+        case 0:
+            return std::make_shared<RTWeekOneDefaultScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 1:
+            return std::make_shared<RTWeekOneTestScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 2:
+            return std::make_shared<RTWeekOneFinalScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 3:
+            return std::make_shared<RTWeekNextDefaultScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 4:
+            return std::make_shared<RTWeekNextRandomSpheresScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 5:
+            return std::make_shared<RTWeekNextTwoSpheresScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 6:
+            return std::make_shared<RTWeekNextEarthScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 7:
+            return std::make_shared<RTWeekNextTwoPerlinSpheresScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 8:
+            return std::make_shared<RTWeekNextQuadsScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 9:
+            return std::make_shared<RTWeekNextSimpleLightScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 10:
+            return std::make_shared<RTWeekNextCornellBoxScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 11:
+            return std::make_shared<RTWeekNextCornellSmokeScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 12:
+            return std::make_shared<RTWeekNextFinalScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 13:
+            return std::make_shared<RTWeekRestACornellBoxScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 14:
+            return std::make_shared<RTWeekRestBCornellBoxMirrorScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 15:
+            return std::make_shared<RTWeekRestCCornellBoxGlassScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 16:
+            return std::make_shared<WhiteSperesScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 17:
+            return std::make_shared<CornellBoxLightsScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+        case 18:
+        default:
+            return std::make_shared<LucyInOneWeekendScene>(aspectRatio, width, samplesPerPixel, maxDepth);
+    }
 }
 
 }    // namespace Scenes
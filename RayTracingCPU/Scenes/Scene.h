@@ -1,7 +1,18 @@
 #pragma once
 
+#include <Objects/BVHBuild.h>
 #include <Objects/HittableList.h>
+#include <Objects/LightBVH.h>
 #include <Render/Camera.h>
+#include <Render/MaterialTable.h>
+
+#include <array>
+#include <memory>
+
+namespace Objects
+{
+class TopLevelBVH;
+}    // namespace Objects
 
 namespace Scenes
 {
@@ -9,27 +20,55 @@ namespace Scenes
 class Scene
 {
 public:
+    // Smallest number of lights sampled through a LightBVH.
+    static constexpr size_t LightBVHThreshold = 2;
+
     Scene(const double aspectRatio, const int width, const int samplesPerPixel, const int maxDepth)
         : m_AspectRatio(aspectRatio)
         , m_Width(width)
         , m_SamplesPerPixel(samplesPerPixel)
         , m_MaxDepth(maxDepth)
     {
+        m_Camera.Materials = &m_Materials;
     }
     virtual ~Scene() = default;
 
-    virtual Render::Camera&        GetCamera();
-    virtual Objects::Hittable&     GetWorld();
+    virtual Render::Camera& GetCamera();
+
+    // Returns the scene objects compiled into a flattened BVH of the configured layout. The BVH is built on first use,
+    // after the materials of the objects are collected into the material table the camera refers to.
+    virtual Objects::Hittable& GetWorld();
+
+    // Returns the lights to sample, collected on first use: the emitters found in the world, weighted by their power,
+    // followed by the extra targets the scene registered in m_Lights. Several lights are sampled through a LightBVH.
+    // Compiles the world first, the lights share its material table.
     virtual Objects::HittableList& GetLights();
 
+    // Top level of the compiled world, which only exists for scenes that place instances. Their transforms can be
+    // changed through it, followed by TopLevelBVH::Update(), without compiling the world again.
+    Objects::TopLevelBVH* GetTopLevel();
+
+    // Changes how the BVH is built, the world is rebuilt on the next GetWorld() call.
+    void SetBVHBuildOptions(const Objects::BVHBuildOptions& options);
+
+    // Changes how a light is picked for a shading point, the lights are collected again on the next GetLights() call.
+    void SetLightSelection(Objects::LightSelection selection);
+
 protected:
-    Render::Camera        m_Camera;
-    Objects::HittableList m_World;
-    Objects::HittableList m_Lights;
-    double                m_AspectRatio     = 16.0 / 9.0;
-    int                   m_Width           = 400;
-    int                   m_SamplesPerPixel = 1;
-    int                   m_MaxDepth        = 1;
+    Render::Camera                        m_Camera;
+    Objects::HittableList                 m_World;
+    Objects::HittableList                 m_Lights;          // Extra targets that emit nothing, like glass spheres sampled for caustics
+    Objects::HittableList                 m_LightSampler;    // Lights handed out by GetLights()
+    Objects::LightSelection               m_LightSelection  = Objects::LightSelection::Power;
+    bool                                  m_LightsCollected = false;
+    std::shared_ptr<Objects::Hittable>    m_CompiledWorld;
+    std::shared_ptr<Objects::TopLevelBVH> m_TopLevel;
+    Render::MaterialTable                 m_Materials;
+    Objects::BVHBuildOptions              m_BVHBuildOptions;
+    double                                m_AspectRatio     = 16.0 / 9.0;
+    int                                   m_Width           = 400;
+    int                                   m_SamplesPerPixel = 1;
+    int                                   m_MaxDepth        = 1;
 };
 
 class RTWeekOneDefaultScene final : public Scene
@@ -140,4 +179,16 @@ public:
     WhiteSperesScene(double aspectRatio, int width, int samplesPerPixel, int maxDepth);
 };
 
+class LucyInOneWeekendScene final : public Scene
+{
+public:
+    LucyInOneWeekendScene(double aspectRatio, int width, int samplesPerPixel, int maxDepth);
+};
+
+// Display names of all scenes, indexed by the scene id used by CreateScene.
+extern const std::array<const char*, 19> SceneNames;
+
+// Creates the scene with the given id, unknown ids fall back to the last scene.
+std::shared_ptr<Scene> CreateScene(int sceneId, double aspectRatio, int width, int samplesPerPixel, int maxDepth);
+
 }    // namespace Scenes
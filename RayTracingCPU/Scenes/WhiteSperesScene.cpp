@@ -1,13 +1,13 @@
 #include "Scene.h"
 
+#include <Math/Transform.h>
 #include <Math/Vector3.h>
-#include <Objects/BVH.h>
 #include <Objects/Box.h>
 #include <Objects/ConstantMedium.h>
+#include <Objects/Instance.h>
 #include <Objects/Quad.h>
-#include <Objects/RotateY.h>
-#include <Objects/Sphere.h>
-#include <Objects/Translate.h>
+#include <Objects/SphereSet.h>
+#include <Objects/WideBVH.h>
 #include <Render/Dielectric.h>
 #include <Render/DiffuseLight.h>
 #include <Render/ImageTexture.h>
@@ -25,22 +25,20 @@ WhiteSperesScene::WhiteSperesScene(const double aspectRatio, const int width, co
     : Scene(aspectRatio, width, samplesPerPixel, maxDepth)
 {
     // Materials
-    auto white   = std::make_shared<Render::Lambertian>(Render::Color3(.73, .73, .73));
-    auto light   = std::make_shared<Render::DiffuseLight>(Render::Color3(7, 7, 7));
-    auto nothing = std::shared_ptr<Render::Material>();
+    auto white = std::make_shared<Render::Lambertian>(Render::Color3(.73, .73, .73));
+    auto light = std::make_shared<Render::DiffuseLight>(Render::Color3(7, 7, 7));
 
     // Lights
     m_World.Add(std::make_shared<Objects::Quad>(Math::Point3(400, 554, 100), Math::Vector3(-300, 0, 0), Math::Vector3(0, 0, -100), light));
-    m_Lights.Add(std::make_shared<Objects::Quad>(Math::Point3(400, 554, 100), Math::Vector3(-300, 0, 0), Math::Vector3(0, 0, -100), nothing));
 
-    Objects::HittableList boxOfSpheres;
-    constexpr int         ns = 20000;
+    Objects::SphereSet boxOfSpheres;
+    constexpr int      ns = 20000;
     for(int j = 0; j < ns; j++)
     {
-        boxOfSpheres.Add(std::make_shared<Objects::Sphere>(Math::Point3::Random(0, 500), 10, white));
+        boxOfSpheres.Add(Math::Point3::Random(0, 500), 10, white);
     }
 
-    m_World.Add(std::make_shared<Objects::Translate>(std::make_shared<Objects::RotateY>(std::make_shared<Objects::BVHNode>(boxOfSpheres), 15), Math::Vector3(0, 0, 300)));
+    m_World.Add(std::make_shared<Objects::Instance>(std::make_shared<Objects::BVH8>(boxOfSpheres.Clusters()), Math::Transform::Translate(Math::Vector3(0, 0, 300)) * Math::Transform::Rotate(15, Math::Vector3(0, 1, 0))));
 
     m_Camera.AspectRatio     = m_AspectRatio;
     m_Camera.ImageWidth      = m_Width;
@@ -0,0 +1,88 @@
+#include "CPUFeatures.h"
+
+#if RT_ARCH_X86
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+#include <cstdint>
+
+namespace Utils
+{
+
+namespace Impl
+{
+
+#if RT_ARCH_X86
+    void CPUID(const int leaf, const int subLeaf, uint32_t registers[4])
+    {
+    #ifdef _MSC_VER
+        int values[4];
+        __cpuidex(values, leaf, subLeaf);
+        for(int i = 0; i < 4; i++)
+            registers[i] = static_cast<uint32_t>(values[i]);
+    #else
+        __cpuid_count(leaf, subLeaf, registers[0], registers[1], registers[2], registers[3]);
+    #endif
+    }
+
+    uint64_t XGetBV()
+    {
+    #ifdef _MSC_VER
+        return _xgetbv(0);
+    #else
+        uint32_t eax = 0;
+        uint32_t edx = 0;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+    #endif
+    }
+#endif
+
+    CPUFeatures DetectCPUFeatures()
+    {
+        CPUFeatures features;
+
+#if RT_ARCH_X86
+        uint32_t registers[4] = {};
+        CPUID(0, 0, registers);
+        const uint32_t maxLeaf = registers[0];
+        if(maxLeaf < 1)
+            return features;
+
+        CPUID(1, 0, registers);
+        features.SSE2  = (registers[3] & (1u << 26)) != 0;
+        features.SSE41 = (registers[2] & (1u << 19)) != 0;
+
+        // AVX needs both the CPU support and the OS saving the XMM and YMM state on context switches.
+        const bool osxsave = (registers[2] & (1u << 27)) != 0;
+        const bool avx     = (registers[2] & (1u << 28)) != 0;
+        const bool fma     = (registers[2] & (1u << 12)) != 0;
+        if(osxsave && avx && (XGetBV() & 0x6) == 0x6)
+        {
+            features.AVX = true;
+            features.FMA = fma;
+
+            if(maxLeaf >= 7)
+            {
+                CPUID(7, 0, registers);
+                features.AVX2 = (registers[1] & (1u << 5)) != 0;
+            }
+        }
+#endif
+
+        return features;
+    }
+
+}    // namespace Impl
+
+const CPUFeatures& GetCPUFeatures()
+{
+    static const CPUFeatures features = Impl::DetectCPUFeatures();
+    return features;
+}
+
+}    // namespace Utils
@@ -0,0 +1,36 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define RT_ARCH_X86 1
+#else
+    #define RT_ARCH_X86 0
+#endif
+
+// Enables AVX2 and FMA code generation for a single function, so that it can be dispatched to at runtime without
+// compiling the whole translation unit for AVX2. RT_FLATTEN inlines everything such a function calls, to keep the
+// hot loop inside the function that is allowed to use the wider instructions.
+#if RT_ARCH_X86 && (defined(__GNUC__) || defined(__clang__))
+    #define RT_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #define RT_FLATTEN     __attribute__((flatten))
+#else
+    #define RT_TARGET_AVX2
+    #define RT_FLATTEN
+#endif
+
+namespace Utils
+{
+
+// Instruction set extensions the SIMD kernels can be dispatched to at runtime.
+struct CPUFeatures
+{
+    bool SSE2  = false;
+    bool SSE41 = false;
+    bool AVX   = false;
+    bool AVX2  = false;
+    bool FMA   = false;
+};
+
+// Queries the CPU on first use. AVX features are only reported if the OS saves the YMM registers.
+const CPUFeatures& GetCPUFeatures();
+
+}    // namespace Utils
@@ -0,0 +1,55 @@
+#include "ImageIO.h"
+
+#include <Utils/Log.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <fstream>
+#include <string>
+
+namespace Utils
+{
+
+ImageRGBA ReadImage(const std::string_view path)
+{
+    const std::string filepath(path);
+
+    ImageRGBA image;
+    int       width, height, channels;
+    uint8_t*  data = stbi_load(filepath.c_str(), &width, &height, &channels, 4);
+    if(!data)
+    {
+        LOG_ERROR("Failed to load image {}", filepath);
+        return image;
+    }
+
+    image.Width  = static_cast<uint32_t>(width);
+    image.Height = static_cast<uint32_t>(height);
+    image.Pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(data);
+    return image;
+}
+
+bool WriteImage(const std::string_view path, const uint32_t width, const uint32_t height, const uint32_t* pixels)
+{
+    const std::string filepath(path);
+    const auto*       bytes = reinterpret_cast<const uint8_t*>(pixels);
+
+    if(filepath.ends_with(".ppm"))
+    {
+        std::ofstream file(filepath, std::ios::binary);
+        file << "P6\n" << width << ' ' << height << "\n255\n";
+        for(size_t i = 0; i < static_cast<size_t>(width) * height; i++)
+        {
+            file.write(reinterpret_cast<const char*>(bytes + i * 4), 3);
+        }
+        return file.good();
+    }
+
+    return stbi_write_png(filepath.c_str(), static_cast<int>(width), static_cast<int>(height), 4, bytes, static_cast<int>(width) * 4) != 0;
+}
+
+}    // namespace Utils
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Utils
+{
+
+// 8-bit RGBA pixels kept in main memory, independent of any graphics API.
+struct ImageRGBA
+{
+    uint32_t             Width  = 0;
+    uint32_t             Height = 0;
+    std::vector<uint8_t> Pixels;
+
+    const uint8_t* PixelData(const uint32_t x, const uint32_t y) const { return Pixels.data() + (static_cast<size_t>(y) * Width + x) * 4; }
+};
+
+// Loads an image file, the result is empty if the file can't be read.
+ImageRGBA ReadImage(std::string_view path);
+
+// Writes packed RGBA pixels as PNG, or as binary PPM when the path ends with ".ppm". Returns false on failure.
+bool WriteImage(std::string_view path, uint32_t width, uint32_t height, const uint32_t* pixels);
+
+}    // namespace Utils
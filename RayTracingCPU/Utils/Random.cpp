@@ -1,53 +1,35 @@
-// ReSharper disable CppClangTidyCertMsc51Cpp
 #include "Random.h"
 
+#include <atomic>
+#include <random>
+
 namespace Utils
 {
 
-void Random::Init()
+namespace Impl
 {
-    s_RandomEngine.seed(std::random_device()());
-}
 
-// Returns a random integer in [min,max].
-int Random::Int(const int min, const int max)
-{
-    return static_cast<int>(Double(min, max + 1));
-}
+    std::atomic<uint64_t> s_Seed        = 0x853C49E6748FEA9Bull;
+    std::atomic<uint64_t> s_ThreadCount = 0;
 
-uint32_t Random::UInt()
-{
-    return s_RandomDistribution(s_RandomEngine);
-}
+}    // namespace Impl
 
-uint32_t Random::UInt(const uint32_t min, const uint32_t max)
+void Random::Init(const uint64_t seed)
 {
-    return min + (s_RandomDistribution(s_RandomEngine) % (max - min + 1));
+    Impl::s_Seed = seed;
+    Engine().Seed(NextThreadSeed());
 }
 
-// Returns a random float in [0,1).
-float Random::Float()
-{
-    return static_cast<float>(rand()) / (static_cast<float>(RAND_MAX) + 1.0f);
-}
-
-float Random::Float(const float min, const float max)
-{
-    return min + (max - min) * Float();
-}
-
-// Returns a random double in [0,1).
-double Random::Double()
+void Random::Init()
 {
-    return rand() / (RAND_MAX + 1.0);
+    std::random_device device;
+    Init((static_cast<uint64_t>(device()) << 32) | device());
 }
 
-double Random::Double(const double min, const double max)
+uint64_t Random::NextThreadSeed()
 {
-    return min + (max - min) * Double();
+    // The engines mix the seed through SplitMix64, so consecutive thread indices still give unrelated streams.
+    return Impl::s_Seed.load(std::memory_order_relaxed) + Impl::s_ThreadCount.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B97F4A7C15ull;
 }
 
-thread_local std::minstd_rand                                             Random::s_RandomEngine;
-thread_local std::uniform_int_distribution<std::minstd_rand::result_type> Random::s_RandomDistribution;
-
 }    // namespace Utils
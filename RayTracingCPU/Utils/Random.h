@@ -1,23 +1,31 @@
 #pragma once
 
-// Random numbers are SLOW!!!!
-// Mersenne Twister (mt19937) is slow like hell. Stick to rand().
-// TODO: Investigate usage of:
-// https://www.pcg-random.org/
-// https://github.com/Reputeless/Xoshiro-cpp
-// https://prng.di.unimi.it/
-// #include <pcg_random.hpp>
-// #include <XoshiroCpp.hpp>
+// Every thread draws from its own engine, so sampling needs no locks and threads never share cache lines. The engine
+// is picked at compile time: xoshiro256++ by default, PCG32 when RT_RANDOM_ENGINE_PCG32 is defined.
+//
+// For reproducible renders a thread can switch to a counter-based stream instead. Each draw is then a hash of the stream
+// key and the number of draws so far, so the numbers depend only on the key and never on which thread draws them.
 
-#include <random>
+#include "RandomEngines.h"
+
+#include <cstdint>
 
 namespace Utils
 {
 
+#if defined(RT_RANDOM_ENGINE_PCG32)
+using RandomEngine = PCG32;
+#else
+using RandomEngine = Xoshiro256PlusPlus;
+#endif
+
 class Random
 {
 public:
-    static void Init();
+    // Sets the seed all engines are derived from and reseeds the engine of the calling thread. Threads that haven't
+    // drawn a number yet use the new seed, each with its own stream.
+    static void Init(uint64_t seed);
+    static void Init();    // Seeds from std::random_device
 
     // Returns a random integer in [min,max].
     static int Int(const int min, const int max);
@@ -33,9 +41,111 @@ public:
     static double Double();
     static double Double(const double min, const double max);
 
+    // Engine of the calling thread.
+    static RandomEngine& Engine();
+
+    // Key of the stream for one stage of one sample of a pixel.
+    static uint64_t StreamKey(uint64_t seed, uint64_t pixel, uint32_t sample, uint32_t stage);
+
+    // Until EndStream, all numbers drawn by the calling thread come from the counter-based stream with the given key.
+    static void BeginStream(const uint64_t key) { s_Stream = {key, 0, true}; }
+    static void EndStream() { s_Stream.Active = false; }
+
 private:
-    static thread_local std::minstd_rand                                             s_RandomEngine;
-    static thread_local std::uniform_int_distribution<std::minstd_rand::result_type> s_RandomDistribution;
+    struct CounterStream
+    {
+        uint64_t Key;
+        uint64_t Counter;
+        bool     Active;
+    };
+
+    // Constant-initialized, so accessing it needs no thread_local initialization check.
+    static inline thread_local constinit CounterStream s_Stream = {0, 0, false};
+
+    static uint64_t NextThreadSeed();
+
+    static uint64_t Bits64();
 };
 
+namespace Impl
+{
+
+    // SplitMix64 finalizer, a bijective 64-bit mix.
+    inline uint64_t Mix64(uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+}    // namespace Impl
+
+inline RandomEngine& Random::Engine()
+{
+    thread_local RandomEngine engine(NextThreadSeed());
+    return engine;
+}
+
+inline uint64_t Random::StreamKey(const uint64_t seed, const uint64_t pixel, const uint32_t sample, const uint32_t stage)
+{
+    const uint64_t sampleKey = Impl::Mix64(seed + Impl::Mix64(pixel + 0x9E3779B97F4A7C15ull));
+    return Impl::Mix64(sampleKey + ((static_cast<uint64_t>(sample) << 32) | stage));
+}
+
+inline uint64_t Random::Bits64()
+{
+    if(s_Stream.Active)
+    {
+        // Same sequence as SplitMix64 seeded with the key.
+        return Impl::Mix64(s_Stream.Key + ++s_Stream.Counter * 0x9E3779B97F4A7C15ull);
+    }
+
+    if constexpr(sizeof(RandomEngine::result_type) == 8)
+    {
+        return Engine()();
+    }
+    else
+    {
+        const uint64_t high = Engine()();
+        return (high << 32) | Engine()();
+    }
+}
+
+inline int Random::Int(const int min, const int max)
+{
+    return static_cast<int>(Double(min, max + 1));
+}
+
+inline uint32_t Random::UInt()
+{
+    return static_cast<uint32_t>(Bits64() >> 32);
+}
+
+inline uint32_t Random::UInt(const uint32_t min, const uint32_t max)
+{
+    return min + (UInt() % (max - min + 1));
+}
+
+inline float Random::Float()
+{
+    // The top 24 bits fill the float mantissa exactly.
+    return static_cast<float>(UInt() >> 8) * 0x1.0p-24f;
+}
+
+inline float Random::Float(const float min, const float max)
+{
+    return min + (max - min) * Float();
+}
+
+inline double Random::Double()
+{
+    // The top 53 bits fill the double mantissa exactly.
+    return static_cast<double>(Bits64() >> 11) * 0x1.0p-53;
+}
+
+inline double Random::Double(const double min, const double max)
+{
+    return min + (max - min) * Double();
+}
+
 }    // namespace Utils
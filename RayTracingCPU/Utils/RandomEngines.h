@@ -0,0 +1,114 @@
+#pragma once
+
+// Small, fast pseudo-random engines. Each one satisfies UniformRandomBitGenerator, so they work with <random>, and
+// keeps its whole state in a few words, so one instance per thread costs nothing.
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace Utils
+{
+
+// SplitMix64, used to expand a single seed into the state of the other engines, see https://prng.di.unimi.it/
+class SplitMix64
+{
+public:
+    using result_type = uint64_t;
+
+    explicit SplitMix64(const uint64_t seed = 0)
+        : m_State(seed)
+    {
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        uint64_t z = (m_State += 0x9E3779B97F4A7C15ull);
+        z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z          = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t m_State;
+};
+
+// xoshiro256++ by Blackman and Vigna, see https://prng.di.unimi.it/
+class Xoshiro256PlusPlus
+{
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256PlusPlus(const uint64_t seed = 0) { Seed(seed); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    void Seed(const uint64_t seed)
+    {
+        SplitMix64 seeder(seed);
+        for(uint64_t& s : m_State)
+        {
+            s = seeder();
+        }
+    }
+
+    result_type operator()()
+    {
+        const uint64_t result = std::rotl(m_State[0] + m_State[3], 23) + m_State[0];
+        const uint64_t t      = m_State[1] << 17;
+
+        m_State[2] ^= m_State[0];
+        m_State[3] ^= m_State[1];
+        m_State[1] ^= m_State[2];
+        m_State[0] ^= m_State[3];
+        m_State[2] ^= t;
+        m_State[3]  = std::rotl(m_State[3], 45);
+
+        return result;
+    }
+
+private:
+    uint64_t m_State[4];
+};
+
+// PCG32 (XSH RR 64/32) by O'Neill, see https://www.pcg-random.org/
+class PCG32
+{
+public:
+    using result_type = uint32_t;
+
+    explicit PCG32(const uint64_t seed = 0) { Seed(seed); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    void Seed(const uint64_t seed)
+    {
+        SplitMix64 seeder(seed);
+        m_State     = 0;
+        m_Increment = (seeder() << 1u) | 1u;
+        (*this)();
+        m_State += seeder();
+        (*this)();
+    }
+
+    result_type operator()()
+    {
+        const uint64_t state = m_State;
+        m_State              = state * 6364136223846793005ull + m_Increment;
+
+        const auto xorShifted = static_cast<uint32_t>(((state >> 18u) ^ state) >> 27u);
+        const auto rotation   = static_cast<int>(state >> 59u);
+        return std::rotr(xorShifted, rotation);
+    }
+
+private:
+    uint64_t m_State;
+    uint64_t m_Increment;    // Selects the stream, always odd
+};
+
+}    // namespace Utils